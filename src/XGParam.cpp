@@ -20,8 +20,15 @@
 *****************************************************************************/
 
 #include "XGParam.h"
+#include "XGParamSysex.h"
+
+#include "qxgeditTrace.h"
+#include "qxgeditAlloc.h"
 
 #include <QRegularExpression>
+#include <QtAlgorithms>
+
+#include <algorithm>
 
 #include <cstdio>
 #include <cstdlib>
@@ -3007,9 +3014,9 @@ XGRpnParamItem NRPNParamTab[] =
 	{  138, 0x08, 0x17 }, // Vibrato Delay
 	{  160, 0x08, 0x18 }, // Filter Cutoff
 	{  161, 0x08, 0x19 }, // Filter Resonance
-	{  227, 0x08, 0x20 }, // EG Attack
-	{  228, 0x08, 0x21 }, // EG Decay
-	{  230, 0x08, 0x22 }, // EG Release
+	{  227, 0x08, 0x1a }, // EG Attack
+	{  228, 0x08, 0x1b }, // EG Decay
+	{  230, 0x08, 0x1c }, // EG Release
 
 	// DRUMSETUP NRPN map...
 	// Address: 0x3n <note> <id>   n=0,1 (drumset)
@@ -3374,12 +3381,236 @@ unsigned short XGDrumVoice::noteOff (void) const
 }
 
 
+//-------------------------------------------------------------------------
+// class XGParamState - XG Parameter dense state array.
+
+// Constructor.
+XGParamState::XGParamState ( unsigned int count )
+	: m_count(count), m_values(nullptr), m_defs(nullptr),
+		m_modified(nullptr), m_unsaved(nullptr), m_seqs(nullptr),
+		m_dirty(nullptr), m_pending(false)
+{
+	m_values = new std::atomic<unsigned short> [m_count];
+	for (unsigned int i = 0; i < m_count; ++i)
+		m_values[i].store(0, std::memory_order_relaxed);
+
+	const unsigned int nblocks = blocks();
+	m_seqs = new std::atomic<unsigned int> [nblocks];
+	for (unsigned int i = 0; i < nblocks; ++i)
+		m_seqs[i].store(0, std::memory_order_relaxed);
+
+	m_defs = new unsigned short [m_count];
+	::memset(m_defs, 0, m_count * sizeof(unsigned short));
+
+	const unsigned int nwords = (m_count >> 5) + 1;
+	m_modified = new std::atomic<unsigned int> [nwords];
+	m_unsaved  = new std::atomic<unsigned int> [nwords];
+	m_dirty    = new std::atomic<unsigned int> [nwords];
+	for (unsigned int i = 0; i < nwords; ++i) {
+		m_modified[i].store(0, std::memory_order_relaxed);
+		m_unsaved[i].store(0, std::memory_order_relaxed);
+		m_dirty[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+
+// Destructor.
+XGParamState::~XGParamState (void)
+{
+	delete [] m_dirty;
+	delete [] m_unsaved;
+	delete [] m_modified;
+	delete [] m_defs;
+	delete [] m_seqs;
+	delete [] m_values;
+}
+
+
+// Concurrent slot commit (any thread; seqlock per block).
+bool XGParamState::commit ( unsigned int index, unsigned short u )
+{
+	if (index >= m_count)
+		return false;
+
+	std::atomic<unsigned int>& seq = m_seqs[index >> BlockShift];
+
+	// Writers on the same block are serialized by spinning the
+	// sequence counter from even to odd; readers retry on odd...
+	unsigned int s = seq.load(std::memory_order_relaxed);
+	for (;;) {
+		if ((s & 1) == 0 && seq.compare_exchange_weak(s, s + 1,
+				std::memory_order_acquire, std::memory_order_relaxed))
+			break;
+		s = seq.load(std::memory_order_relaxed);
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+
+	const bool changed
+		= (m_values[index].exchange(u, std::memory_order_relaxed) != u);
+
+	seq.store(s + 2, std::memory_order_release);
+
+	if (changed) {
+		track(index, u);
+		m_dirty[index >> 5].fetch_or(1U << (index & 31),
+			std::memory_order_release);
+		m_pending.store(true, std::memory_order_release);
+	}
+
+	return changed;
+}
+
+
+// Modified from default slots (in dense order).
+int XGParamState::modified ( QVector<unsigned int>& indexes ) const
+{
+	indexes.clear();
+
+	const unsigned int nwords = (m_count >> 5) + 1;
+	for (unsigned int i = 0; i < nwords; ++i) {
+		unsigned int bits = m_modified[i].load(std::memory_order_relaxed);
+		while (bits) {
+			const unsigned int bit = qCountTrailingZeroBits(bits);
+			indexes.append((i << 5) + bit);
+			bits &= bits - 1;
+		}
+	}
+
+	return indexes.count();
+}
+
+
+// Changed since last save reset.
+void XGParamState::reset_unsaved (void)
+{
+	const unsigned int nwords = (m_count >> 5) + 1;
+	for (unsigned int i = 0; i < nwords; ++i)
+		m_unsaved[i].store(0, std::memory_order_relaxed);
+}
+
+
+// Tracking bitmaps rebuild (eg. after a whole state restore).
+void XGParamState::refresh (void)
+{
+	const unsigned int nwords = (m_count >> 5) + 1;
+	for (unsigned int i = 0; i < nwords; ++i) {
+		unsigned int bits = 0;
+		const unsigned int i0 = (i << 5);
+		const unsigned int i1 = qMin(i0 + 32, m_count);
+		for (unsigned int j = i0; j < i1; ++j) {
+			if (m_values[j].load(std::memory_order_relaxed) != m_defs[j])
+				bits |= (1U << (j - i0));
+		}
+		const unsigned int prev
+			= m_modified[i].exchange(bits, std::memory_order_relaxed);
+		if (prev != bits)
+			m_unsaved[i].fetch_or(prev ^ bits, std::memory_order_relaxed);
+	}
+}
+
+
+// Tracking bitmap range tester (any set in range).
+bool XGParamState::test ( const std::atomic<unsigned int> *bitmap,
+	unsigned int first, unsigned int count ) const
+{
+	if (count < 1 || first >= m_count)
+		return false;
+
+	unsigned int last = first + count - 1;
+	if (last >= m_count)
+		last = m_count - 1;
+
+	const unsigned int w0 = (first >> 5);
+	const unsigned int w1 = (last  >> 5);
+	for (unsigned int w = w0; w <= w1; ++w) {
+		unsigned int mask = ~0U;
+		if (w == w0)
+			mask &= (~0U << (first & 31));
+		if (w == w1 && (last & 31) < 31)
+			mask &= ((1U << ((last & 31) + 1)) - 1);
+		if (bitmap[w].load(std::memory_order_relaxed) & mask)
+			return true;
+	}
+
+	return false;
+}
+
+
+// Consistent state image copy (retries blocks being committed).
+void XGParamState::snapshot ( unsigned short *values ) const
+{
+	const unsigned int nblocks = blocks();
+	for (unsigned int block = 0; block < nblocks; ++block) {
+		const unsigned int i0 = (block << BlockShift);
+		const unsigned int i1 = qMin(i0 + (1U << BlockShift), m_count);
+		unsigned int s0, s1;
+		do {
+			s0 = m_seqs[block].load(std::memory_order_acquire);
+			for (unsigned int i = i0; i < i1; ++i)
+				values[i] = m_values[i].load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			s1 = m_seqs[block].load(std::memory_order_relaxed);
+		}
+		while ((s0 & 1) || s0 != s1);
+	}
+}
+
+
+// Whole state image restore (seqlock per block; no dirty slots).
+void XGParamState::restore ( const unsigned short *values )
+{
+	const unsigned int nblocks = blocks();
+	for (unsigned int block = 0; block < nblocks; ++block) {
+		const unsigned int i0 = (block << BlockShift);
+		const unsigned int i1 = qMin(i0 + (1U << BlockShift), m_count);
+		std::atomic<unsigned int>& seq = m_seqs[block];
+		unsigned int s = seq.load(std::memory_order_relaxed);
+		for (;;) {
+			if ((s & 1) == 0 && seq.compare_exchange_weak(s, s + 1,
+					std::memory_order_acquire, std::memory_order_relaxed))
+				break;
+			s = seq.load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+		for (unsigned int i = i0; i < i1; ++i)
+			m_values[i].store(values[i], std::memory_order_relaxed);
+		seq.store(s + 2, std::memory_order_release);
+	}
+
+	refresh();
+}
+
+
+// Committed slots pick-up (single consumer).
+int XGParamState::take_dirty ( QVector<unsigned int>& indexes )
+{
+	indexes.clear();
+
+	if (!m_pending.exchange(false, std::memory_order_acq_rel))
+		return 0;
+
+	const unsigned int nwords = (m_count >> 5) + 1;
+	for (unsigned int i = 0; i < nwords; ++i) {
+		if (m_dirty[i].load(std::memory_order_relaxed) == 0)
+			continue;
+		unsigned int bits = m_dirty[i].exchange(0, std::memory_order_acquire);
+		while (bits) {
+			const unsigned int bit = qCountTrailingZeroBits(bits);
+			indexes.append((i << 5) + bit);
+			bits &= bits - 1;
+		}
+	}
+
+	return indexes.count();
+}
+
+
 //-------------------------------------------------------------------------
 // class XGParam - XG Generic parameter descriptor.
 
 // Constructor.
 XGParam::XGParam ( unsigned short high, unsigned short mid, unsigned short low )
-	: m_param(nullptr), m_value(0),
+	: m_param(nullptr), m_value(0), m_state(nullptr), m_index(0),
 		m_high(high), m_mid(mid), m_low(low), m_busy(false)
 {
 	if (m_high == 0x00 && m_mid == 0x00) {
@@ -3411,12 +3642,16 @@ XGParam::XGParam ( unsigned short high, unsigned short mid, unsigned short low )
 	// Set initial defaults.
 	if (m_param)
 		m_value = XGParam::def();
+
+	qxgeditAlloc::acquire(qxgeditAlloc::Param, sizeof(XGParam));
 }
 
 
 // Virtual destructor.
 XGParam::~XGParam (void)
 {
+	qxgeditAlloc::release(qxgeditAlloc::Param, sizeof(XGParam));
+
 	m_busy = true;
 
 	QListIterator<XGParamObserver *> iter(m_observers);
@@ -3561,22 +3796,52 @@ void XGParam::set_value_update ( unsigned short u, XGParamObserver *sender )
 	if (gets(min()) && !gets(u))
 		return;
 
-	m_value = u;
+	if (m_state)
+		m_state->set_value(m_index, u);
+	else
+		m_value = u;
 
 	notify_update(sender);
 }
 
 void XGParam::set_value ( unsigned short u, XGParamObserver *sender )
 {
-	if (m_value == u)
+	if (value() == u)
 		return;
 
+	QXGEDIT_TRACE("XGParam::set_value");
+
 	set_value_update(u, sender);
 }
 
 unsigned short XGParam::value (void) const
 {
-	return m_value;
+	return (m_state ? m_state->value(m_index) : m_value);
+}
+
+
+// Dense state slot accessors.
+void XGParam::set_state ( XGParamState *state, unsigned int index )
+{
+	const unsigned short u = value();
+
+	m_state = state;
+	m_index = index;
+
+	if (m_state)
+		m_state->set_value(m_index, u);
+	else
+		m_value = u;
+}
+
+XGParamState *XGParam::state (void) const
+{
+	return m_state;
+}
+
+unsigned int XGParam::index (void) const
+{
+	return m_index;
 }
 
 
@@ -3600,6 +3865,8 @@ void XGParam::notify_reset ( XGParamObserver *sender )
 	if (m_busy)
 		return;
 
+	QXGEDIT_TRACE("XGParam::notify_reset");
+
 	m_busy = true;
 
 	QListIterator<XGParamObserver *> iter(m_observers);
@@ -3620,6 +3887,8 @@ void XGParam::notify_update ( XGParamObserver *sender )
 	if (m_busy)
 		return;
 
+	QXGEDIT_TRACE("XGParam::notify_update");
+
 	m_busy = true;
 
 	QListIterator<XGParamObserver *> iter(m_observers);
@@ -3736,6 +4005,18 @@ XGEffectParam::XGEffectParam (
 	// Re(set) initial defaults.
 	if (m_eparam)
 		m_value = XGEffectParam::def();
+
+	// Accounted as such, not as a plain one.
+	qxgeditAlloc::release(qxgeditAlloc::Param, sizeof(XGParam));
+	qxgeditAlloc::acquire(qxgeditAlloc::EffectParam, sizeof(XGEffectParam));
+}
+
+
+// Destructor.
+XGEffectParam::~XGEffectParam (void)
+{
+	qxgeditAlloc::release(qxgeditAlloc::EffectParam, sizeof(XGEffectParam));
+	qxgeditAlloc::acquire(qxgeditAlloc::Param, sizeof(XGParam));
 }
 
 
@@ -3807,12 +4088,19 @@ XGDataParam::XGDataParam (
 	unsigned short n = size();
 	m_data = new unsigned char [n];
 	::memset(m_data, ' ', n);
+
+	// Accounted as such (and its data), not as a plain one.
+	qxgeditAlloc::release(qxgeditAlloc::Param, sizeof(XGParam));
+	qxgeditAlloc::acquire(qxgeditAlloc::DataParam, sizeof(XGDataParam) + n);
 }
 
 // Destructor.
 XGDataParam::~XGDataParam (void)
 {
 	delete [] m_data;
+
+	qxgeditAlloc::release(qxgeditAlloc::DataParam, sizeof(XGDataParam) + size());
+	qxgeditAlloc::acquire(qxgeditAlloc::Param, sizeof(XGParam));
 }
 
 
@@ -3848,9 +4136,22 @@ void XGDataParam::reset ( XGParamObserver *sender )
 // class XGParamMap - XG Parameter mapper.
 //
 
+// Parameter id (low address) ordering helpers.
+static inline bool xgparam_less ( XGParam *a, XGParam *b )
+{
+	return (a->low() < b->low());
+}
+
+static inline bool xgparam_less_id ( XGParam *a, unsigned short id )
+{
+	return (a->low() < id);
+}
+
+
 // Constructor.
 XGParamMap::XGParamMap (void)
-	: m_key_param(nullptr), m_key(0), m_elements(0), m_element(0)
+	: m_master(nullptr), m_key_param(nullptr), m_key(0),
+		m_elements(0), m_element(0)
 {
 	m_observer = new XGParamMap::Observer(this);
 }
@@ -3867,15 +4168,31 @@ XGParamMap::~XGParamMap (void)
 }
 
 
+// Owner master map (back-reference).
+void XGParamMap::set_master_map ( XGParamMasterMap *master )
+{
+	m_master = master;
+}
+
+XGParamMasterMap *XGParamMap::master_map (void) const
+{
+	return m_master;
+}
+
+
 // Append method.
 void XGParamMap::add_param ( XGParam *param, unsigned short key )
 {
 	XGParamSet *paramset = find_paramset(param->low());
 	paramset->insert(key, param);
 
-	XGParamMasterMap *pMasterMap = XGParamMasterMap::getInstance();
-	if (pMasterMap)
-		pMasterMap->add_param_map(param, this);
+	// Keep per-key vector in id order...
+	Params& params = m_key_params[key];
+	params.insert(std::upper_bound(
+		params.begin(), params.end(), param, xgparam_less), param);
+
+	if (m_master)
+		m_master->add_param_map(param, this);
 }
 
 
@@ -3943,21 +4260,22 @@ XGParamSet *XGParamMap::find_paramset ( unsigned short id )
 // Local observers notify (key change).
 void XGParamMap::notify_reset (void)
 {
+	QXGEDIT_TRACE("XGParamMap::notify_reset");
+
 	if (m_key_param)
 		m_key = m_key_param->value();
 
-	unsigned short id0 = 0x3d + (m_element * 0x50);
-	XGParamMap::const_iterator iter = XGParamMap::constBegin();
-	for (; iter != XGParamMap::constEnd(); ++iter) {
-		unsigned short id = iter.key();
-		if (m_elements > 0 && id >= 0x3d && (id < id0 || id >= id0 + 0x50))
-			continue;
-		XGParamSet *paramset = iter.value();
-		if (paramset->contains(m_key)) {
-			XGParam *param = paramset->value(m_key);
-			if (param)
-				param->notify_reset();
-		}
+	const Params& params = key_params(m_key);
+
+	ParamsIter iter, end;
+	key_range(params, iter, end);
+	for (; iter != end; ++iter)
+		(*iter)->notify_reset();
+
+	if (m_elements > 0) {
+		element_range(params, m_element, iter, end);
+		for (; iter != end; ++iter)
+			(*iter)->notify_reset();
 	}
 }
 
@@ -3991,20 +4309,10 @@ void XGParamMap::set_current_element ( unsigned short element )
 {
 	m_element = element;
 
-	unsigned short key = current_key();
-	unsigned short id0 = 0x3d + (m_element * 0x50);
-	XGParamMap::const_iterator iter = XGParamMap::constBegin();
-	for (; iter != XGParamMap::constEnd(); ++iter) {
-		unsigned short id = iter.key();
-		if (id >= id0 && id < id0 + 0x50) {
-			XGParamSet *paramset = iter.value();
-			if (paramset->contains(key)) {
-				XGParam *param = paramset->value(key);
-				if (param)
-					param->notify_reset();
-			}
-		}
-	}
+	ParamsIter iter, end;
+	element_range(key_params(current_key()), m_element, iter, end);
+	for (; iter != end; ++iter)
+		(*iter)->notify_reset();
 }
 
 unsigned short XGParamMap::current_element (void) const
@@ -4016,75 +4324,118 @@ unsigned short XGParamMap::current_element (void) const
 // All parameter reset (to default)
 void XGParamMap::reset ( XGParamObserver *sender )
 {
-	unsigned short key = current_key();
-	XGParamMap::const_iterator iter = XGParamMap::constBegin();
-	for (; iter != XGParamMap::constEnd(); ++iter) {
-		XGParamSet *paramset = iter.value();
-		if (paramset->contains(key)) {
-			XGParam *param = paramset->value(key);
-			if (param)
-				param->reset(sender);
-		}
-	}
+	const Params& params = key_params(current_key());
+
+	ParamsIter iter = params.constBegin();
+	for (; iter != params.constEnd(); ++iter)
+		(*iter)->reset(sender);
 }
 
 
 // All parameter randomizer (p = percent from value/def).
 void XGParamMap::randomize_value ( int p )
 {
-	unsigned short key = current_key();
-	unsigned short id0 = 0x3d + (m_element * 0x50);
-	XGParamMap::const_iterator iter = XGParamMap::constBegin();
-	for (; iter != XGParamMap::constEnd(); ++iter) {
-		unsigned short id = iter.key();
-		if (m_elements > 0 && id >= 0x3d && (id < id0 || id >= id0 + 0x50))
-			continue;
-		XGParamSet *paramset = iter.value();
-		if (paramset->contains(key)) {
-			XGParam *param = paramset->value(key);
-			if (param)
-				param->randomize_value(p);
-		}
+	const Params& params = key_params(current_key());
+
+	ParamsIter iter, end;
+	key_range(params, iter, end);
+	for (; iter != end; ++iter)
+		(*iter)->randomize_value(p);
+
+	if (m_elements > 0) {
+		element_range(params, m_element, iter, end);
+		for (; iter != end; ++iter)
+			(*iter)->randomize_value(p);
 	}
 }
 
 void XGParamMap::randomize_def ( int p )
 {
-	unsigned short key = current_key();
-	unsigned short id0 = 0x3d + (m_element * 0x50);
-	XGParamMap::const_iterator iter = XGParamMap::constBegin();
-	for (; iter != XGParamMap::constEnd(); ++iter) {
-		unsigned short id = iter.key();
-		if (m_elements > 0 && id >= 0x3d && (id < id0 || id >= id0 + 0x50))
-			continue;
-		XGParamSet *paramset = iter.value();
-		if (paramset->contains(key)) {
-			XGParam *param = paramset->value(key);
-			if (param)
-				param->randomize_def(p);
-		}
+	const Params& params = key_params(current_key());
+
+	ParamsIter iter, end;
+	key_range(params, iter, end);
+	for (; iter != end; ++iter)
+		(*iter)->randomize_def(p);
+
+	if (m_elements > 0) {
+		element_range(params, m_element, iter, end);
+		for (; iter != end; ++iter)
+			(*iter)->randomize_def(p);
+	}
+}
+
+
+// Per-key bound parameters (in id order).
+const XGParamMap::Params& XGParamMap::key_params ( unsigned short key ) const
+{
+	static const Params s_none;
+
+	QHash<unsigned short, Params>::const_iterator iter
+		= m_key_params.constFind(key);
+	return (iter != m_key_params.constEnd() ? iter.value() : s_none);
+}
+
+
+// Per-key parameter slice (all, or common ones only, with elements).
+void XGParamMap::key_range ( const Params& params,
+	ParamsIter& iter, ParamsIter& end ) const
+{
+	iter = params.constBegin();
+	end  = params.constEnd();
+
+	if (m_elements > 0) {
+		end = std::lower_bound(iter, end, 0x3d, xgparam_less_id);
 	}
 }
 
 
+// Per-element parameter slice (0x50 id stride, from 0x3d).
+void XGParamMap::element_range ( const Params& params,
+	unsigned short element, ParamsIter& iter, ParamsIter& end ) const
+{
+	const unsigned short id0 = 0x3d + (element * 0x50);
+
+	iter = std::lower_bound(
+		params.constBegin(), params.constEnd(), id0, xgparam_less_id);
+	end  = std::lower_bound(
+		iter, params.constEnd(), id0 + 0x50, xgparam_less_id);
+}
+
+
 //-------------------------------------------------------------------------
 // class XGParamMasterMap - XG Parameter master state database.
 //
 // Pseudo-singleton reference.
 XGParamMasterMap *XGParamMasterMap::g_pParamMasterMap = nullptr;
 
-// Pseudo-singleton accessor (static).
+// Pseudo-singleton accessors (static).
 XGParamMasterMap *XGParamMasterMap::getInstance (void)
 {
 	return g_pParamMasterMap;
 }
 
+void XGParamMasterMap::setInstance ( XGParamMasterMap *pMasterMap )
+{
+	g_pParamMasterMap = pMasterMap;
+}
+
 
 // Constructor.
 XGParamMasterMap::XGParamMasterMap (void)
+	: m_state(nullptr), m_layout(0)
 {
 	unsigned short i, j, k;
 
+	// Group-maps owner back-references...
+	SYSTEM.set_master_map(this);
+	REVERB.set_master_map(this);
+	CHORUS.set_master_map(this);
+	VARIATION.set_master_map(this);
+	MULTIPART.set_master_map(this);
+	DRUMSETUP.set_master_map(this);
+	USERVOICE.set_master_map(this);
+
 	// Initialize the randomizer seed...
 	::srand(::time(nullptr));
 
@@ -4241,8 +4592,52 @@ XGParamMasterMap::XGParamMasterMap (void)
 		}
 	}
 
-	// Pseudo-singleton set.
-	g_pParamMasterMap = this;
+	// Dense parameter state, in key order...
+	m_state = new XGParamState(XGParamMasterMap::size());
+	m_params.reserve(XGParamMasterMap::size());
+	m_layout = 2166136261U; // FNV-1a offset basis.
+	XGParamMasterMap::const_iterator iter = XGParamMasterMap::constBegin();
+	for (; iter != XGParamMasterMap::constEnd(); ++iter) {
+		XGParam *param = iter.value();
+		const unsigned int index = m_params.count();
+		param->set_state(m_state, index);
+		m_params.append(param);
+		// Contiguous block slices (key order)...
+		const unsigned short high = param->high();
+		const unsigned short key = (high << 8) | param->mid();
+		if (m_high_ranges.contains(high))
+			++m_high_ranges[high].count;
+		else
+			m_high_ranges.insert(high, {index, 1});
+		if (m_mid_ranges.contains(key))
+			++m_mid_ranges[key].count;
+		else
+			m_mid_ranges.insert(key, {index, 1});
+		// Layout signature (address, sub-type and size)...
+		unsigned int sig = (param->high() << 16)
+			| (param->mid() << 8) | param->low();
+		sig ^= ((unsigned int) param->size() << 28);
+		if (param->high() == 0x02 && param->mid() == 0x01 &&
+			param->low() != 0x00 && param->low() != 0x20 && param->low() != 0x40) {
+			XGEffectParam *eparam = static_cast<XGEffectParam *> (param);
+			sig ^= ((unsigned int) eparam->etype() << 20);
+		}
+		for (int n = 0; n < 4; ++n) {
+			m_layout ^= ((sig >> (n << 3)) & 0xff);
+			m_layout *= 16777619U; // FNV-1a prime.
+		}
+	}
+
+	// Modified from default tracking...
+	const int nparams = m_params.count();
+	for (int i = 0; i < nparams; ++i)
+		m_state->set_def(i, m_params.at(i)->def());
+	m_state->refresh();
+	m_state->reset_unsaved();
+
+	// Pseudo-singleton set (first one only).
+	if (g_pParamMasterMap == nullptr)
+		g_pParamMasterMap = this;
 }
 
 
@@ -4250,11 +4645,16 @@ XGParamMasterMap::XGParamMasterMap (void)
 XGParamMasterMap::~XGParamMasterMap (void)
 {
 	// Pseudo-singleton reset.
-	g_pParamMasterMap = nullptr;
+	if (g_pParamMasterMap == this)
+		g_pParamMasterMap = nullptr;
 
 	XGParamMasterMap::const_iterator iter = XGParamMasterMap::constBegin();
 	for (; iter != XGParamMasterMap::constEnd(); ++iter)
 		delete iter.value();
+
+	m_params.clear();
+
+	delete m_state;
 }
 
 
@@ -4317,6 +4717,87 @@ XGParam *XGParamMasterMap::find_param (
 }
 
 
+// Direct SysEx data receiver.
+bool XGParamMasterMap::add_sysex_data (
+	SysexData& sysex_data, unsigned char *data, unsigned short len ) const
+{
+	// Validate it all, first...
+	const XGSysexDecoder sysex(data, len);
+	if (!sysex.is_valid()) {
+	#ifdef CONFIG_DEBUG_0
+		qDebug("XGParamMasterMap::add_sysex_data(%p, %u): invalid (status=%d).",
+			data, len, int(sysex.status()));
+	#endif
+		return false;
+	}
+
+	// Parameter Change (or Native Bulk Dump)...
+	const XGParamKey key(sysex.high(), sysex.mid(), sysex.low());
+	sysex_data.insert(key, QByteArray((const char *) sysex.data(), sysex.size()));
+
+	return true;
+}
+
+
+bool XGParamMasterMap::set_sysex_data (
+	const SysexData& sysex_data, bool bNotify )
+{
+	QXGEDIT_TRACE("XGParamMasterMap::set_sysex_data");
+
+	int nparam = 0;
+
+	SysexData::const_iterator iter = sysex_data.constBegin();
+	for (; iter != sysex_data.constEnd(); ++iter) {
+		const XGParamKey& key = iter.key();
+		const QByteArray& val = iter.value();
+		unsigned char *data = (unsigned char *) val.data();
+		for (unsigned short i = 0; i < val.size(); ++i) {
+			// Parameter Change...
+			XGParam *param = find_param(key.high(), key.mid(), key.low() + i);
+			// Must fit in what's left of the block...
+			if (param && i + param->size() > val.size())
+				break;
+			if (param && set_param_data(param, data + i, bNotify)) {
+				const unsigned short n = param->size();
+				if (n > 1) {
+					i += (n - 1);
+					++nparam;
+				}
+			}
+		}
+	}
+
+	return (nparam > 0);
+}
+
+
+// Direct parameter data access (no local observers here).
+bool XGParamMasterMap::set_param_data (
+	XGParam *param, unsigned char *data, bool /*bNotify*/ )
+{
+	decode_param_data(param, data);
+
+	return (param->size() > 0);
+}
+
+
+// Parameter data decoder (raw SysEx data to value).
+void XGParamMasterMap::decode_param_data (
+	XGParam *param, unsigned char *data, XGParamObserver *sender )
+{
+	if (param->size() > 4) {
+		XGDataParam *dparam = static_cast<XGDataParam *> (param);
+		dparam->set_data(data, dparam->size(), sender);
+	}
+	else
+	if (param->high() == 0x08 && param->low() == 0x09) { // DETUNE (2byte, 4bit).
+		param->set_value(param->data_value2(data), sender);
+	} else {
+		param->set_value(param->data_value(data), sender);
+	}
+}
+
+
 // Find map from param.
 XGParamMap *XGParamMasterMap::find_param_map ( XGParam *param ) const
 {
@@ -4324,4 +4805,77 @@ XGParamMap *XGParamMasterMap::find_param_map ( XGParam *param ) const
 }
 
 
+// Dense parameter state (in master map key order).
+XGParamState *XGParamMasterMap::state (void) const
+{
+	return m_state;
+}
+
+const QList<XGParam *>& XGParamMasterMap::params (void) const
+{
+	return m_params;
+}
+
+
+// Dense state layout signature.
+unsigned int XGParamMasterMap::layout (void) const
+{
+	return m_layout;
+}
+
+
+// Contiguous dense state slices.
+XGParamMasterMap::Range XGParamMasterMap::range ( unsigned short high ) const
+{
+	return m_high_ranges.value(high, {0, 0});
+}
+
+
+XGParamMasterMap::Range XGParamMasterMap::range (
+	unsigned short high, unsigned short mid ) const
+{
+	return m_mid_ranges.value((high << 8) | mid, {0, 0});
+}
+
+
+// Modified from default parameters (in key order).
+int XGParamMasterMap::modified_params ( QList<XGParam *>& list ) const
+{
+	QVector<unsigned int> indexes;
+	m_state->modified(indexes);
+
+	list.clear();
+	list.reserve(indexes.count());
+	QVectorIterator<unsigned int> iter(indexes);
+	while (iter.hasNext())
+		list.append(m_params.at(iter.next()));
+
+	return list.count();
+}
+
+
+// Whether any sub-block parameter is modified from default
+// or has changed since last save (eg. part, drum note, user voice).
+bool XGParamMasterMap::is_modified (
+	unsigned short high, unsigned short mid ) const
+{
+	const Range r = range(high, mid);
+	return m_state->any_modified(r.first, r.count);
+}
+
+bool XGParamMasterMap::is_unsaved (
+	unsigned short high, unsigned short mid ) const
+{
+	const Range r = range(high, mid);
+	return m_state->any_unsaved(r.first, r.count);
+}
+
+
+// Mark all as saved.
+void XGParamMasterMap::reset_unsaved (void)
+{
+	m_state->reset_unsaved();
+}
+
+
 // end of XGParam.cpp
@@ -26,6 +26,10 @@
 
 #include <QHash>
 #include <QMap>
+#include <QVector>
+#include <QByteArray>
+
+#include <atomic>
 
 
 // Helper prototypes.
@@ -181,6 +185,129 @@ private:
 };
 
 
+//-------------------------------------------------------------------------
+// class XGParamState - XG Parameter dense state array.
+//
+
+class XGParamState
+{
+public:
+
+	// Constructor.
+	XGParamState(unsigned int count);
+
+	// Destructor.
+	~XGParamState();
+
+	// Number of state slots.
+	unsigned int count() const
+		{ return m_count; }
+
+	// Slot value accessors.
+	void set_value(unsigned int index, unsigned short u)
+	{
+		if (m_values[index].load(std::memory_order_relaxed) == u)
+			return;
+		m_values[index].store(u, std::memory_order_relaxed);
+		track(index, u);
+	}
+	unsigned short value(unsigned int index) const
+		{ return m_values[index].load(std::memory_order_relaxed); }
+
+	// Slots per sequence counter block.
+	enum { BlockShift = 6 };
+
+	// Number of sequence counter blocks.
+	unsigned int blocks() const
+		{ return (m_count >> BlockShift) + 1; }
+
+	// Concurrent slot commit (any thread; seqlock per block).
+	bool commit(unsigned int index, unsigned short u);
+
+	// Block sequence counter (odd while a commit is in flight).
+	unsigned int seq(unsigned int block) const
+		{ return m_seqs[block].load(std::memory_order_acquire); }
+
+	// Consistent state image copy (retries blocks being committed).
+	void snapshot(unsigned short *values) const;
+
+	// Whole state image restore (seqlock per block; no dirty slots).
+	void restore(const unsigned short *values);
+
+	// Committed slots pick-up (single consumer).
+	bool is_dirty() const
+		{ return m_pending.load(std::memory_order_acquire); }
+	int take_dirty(QVector<unsigned int>& indexes);
+
+	// Slot default value (modified tracking reference).
+	void set_def(unsigned int index, unsigned short u)
+		{ m_defs[index] = u; }
+	unsigned short def(unsigned int index) const
+		{ return m_defs[index]; }
+
+	// Modified from default (slot, any in range, all of them).
+	bool is_modified(unsigned int index) const
+		{ return test(m_modified, index); }
+	bool any_modified(unsigned int first, unsigned int count) const
+		{ return test(m_modified, first, count); }
+	int modified(QVector<unsigned int>& indexes) const;
+
+	// Changed since last save (slot, any in range, reset).
+	bool is_unsaved(unsigned int index) const
+		{ return test(m_unsaved, index); }
+	bool any_unsaved(unsigned int first, unsigned int count) const
+		{ return test(m_unsaved, first, count); }
+	void reset_unsaved();
+
+	// Tracking bitmaps rebuild (eg. after a whole state restore).
+	void refresh();
+
+protected:
+
+	// Tracking bitmaps update (any thread).
+	void track(unsigned int index, unsigned short u)
+	{
+		const unsigned int word = (index >> 5);
+		const unsigned int bit  = (1U << (index & 31));
+		const bool modified = (u != m_defs[index]);
+		const unsigned int bits = m_modified[word].load(std::memory_order_relaxed);
+		if (modified && (bits & bit) == 0)
+			m_modified[word].fetch_or(bit, std::memory_order_relaxed);
+		else
+		if (!modified && (bits & bit))
+			m_modified[word].fetch_and(~bit, std::memory_order_relaxed);
+		if ((m_unsaved[word].load(std::memory_order_relaxed) & bit) == 0)
+			m_unsaved[word].fetch_or(bit, std::memory_order_relaxed);
+	}
+
+	// Tracking bitmap testers.
+	bool test(const std::atomic<unsigned int> *bitmap, unsigned int index) const
+	{
+		return (bitmap[index >> 5].load(std::memory_order_relaxed)
+			& (1U << (index & 31))) != 0;
+	}
+
+	bool test(const std::atomic<unsigned int> *bitmap,
+		unsigned int first, unsigned int count) const;
+
+private:
+
+	// Instance variables.
+	unsigned int m_count;
+
+	std::atomic<unsigned short> *m_values;
+
+	unsigned short *m_defs;
+
+	std::atomic<unsigned int> *m_modified;
+	std::atomic<unsigned int> *m_unsaved;
+
+	std::atomic<unsigned int> *m_seqs;
+	std::atomic<unsigned int> *m_dirty;
+	std::atomic<bool>          m_pending;
+};
+
+
 //-------------------------------------------------------------------------
 // class XGParam - XG Generic parameter descriptor.
 //
@@ -226,6 +353,11 @@ public:
 	void set_value(unsigned short u, XGParamObserver *sender = nullptr);
 	unsigned short value() const;
 
+	// Dense state slot accessors.
+	void set_state(XGParamState *state, unsigned int index);
+	XGParamState *state() const;
+	unsigned int index() const;
+
 	// Virtual reset (to default).
 	virtual void reset(XGParamObserver *sender = nullptr);
 
@@ -260,9 +392,12 @@ protected:
 	// Parameter descriptor.
 	const XGParamItem *m_param;
 
-	// Parameter state.
+	// Parameter state (until attached to a dense state slot).
 	unsigned short m_value;
 
+	XGParamState  *m_state;
+	unsigned int   m_index;
+
 private:
 
 	// Parameter address.
@@ -288,6 +423,9 @@ public:
 	XGEffectParam(unsigned short high, unsigned short mid, unsigned short low,
 		unsigned short etype);
 
+	// Destructor.
+	~XGEffectParam();
+
 	// Sub-address accessors.
 	unsigned short etype() const;
 
@@ -393,6 +531,8 @@ class XGParamSet : public QHash<unsigned short, XGParam *> {};
 // class XGParamMap - XG Parameter mapper.
 //
 
+class XGParamMasterMap;
+
 class XGParamMap : public QMap<unsigned short, XGParamSet *>
 {
 public:
@@ -403,6 +543,10 @@ public:
 	// Destructor.
 	~XGParamMap();
 
+	// Owner master map (back-reference).
+	void set_master_map(XGParamMasterMap *master);
+	XGParamMasterMap *master_map() const;
+
 	// Append method.
 	void add_param(XGParam *param, unsigned short key);
 
@@ -444,8 +588,21 @@ public:
 	void randomize_value(int p = 100);
 	void randomize_def(int p = 100);
 
+	// Per-key bound parameters (in id order).
+	typedef QVector<XGParam *> Params;
+
+	const Params& key_params(unsigned short key) const;
+
 protected:
 
+	// Per-key (and per-element) parameter slices.
+	typedef Params::const_iterator ParamsIter;
+
+	void key_range(const Params& params,
+		ParamsIter& iter, ParamsIter& end) const;
+	void element_range(const Params& params,
+		unsigned short element, ParamsIter& iter, ParamsIter& end) const;
+
 	// Local observer.
 	class Observer : public XGParamObserver
 	{
@@ -468,6 +625,8 @@ protected:
 private:
 
 	// Instance variables.
+	XGParamMasterMap *m_master;
+
 	XGParam *m_key_param;
 	unsigned short m_key;
 
@@ -480,6 +639,9 @@ private:
 	// Special element stride settings (USERVOICE, QS300).
 	unsigned short m_elements;
 	unsigned short m_element;
+
+	// Per-key bound parameters (in id order).
+	QHash<unsigned short, Params> m_key_params;
 };
 
 
@@ -506,7 +668,7 @@ public:
 		if (m_channel != key.channel())
 			return (m_channel < key.channel());
 		else
-			return (m_channel < key.param());
+			return (m_param < key.param());
 	}
 
 private:
@@ -536,10 +698,11 @@ public:
 	XGParamMasterMap();
 
 	// Destructor.
-	~XGParamMasterMap();
+	virtual ~XGParamMasterMap();
 
-	// Pseudo-singleton accessor.
+	// Pseudo-singleton accessors (current master map).
 	static XGParamMasterMap *getInstance();
+	static void setInstance(XGParamMasterMap *pMasterMap);
 
 	// Parameter group-maps.
 	XGParamMap SYSTEM;
@@ -569,14 +732,73 @@ public:
 	// Find map from param.
 	XGParamMap *find_param_map(XGParam *param) const;
 
+	// Dense parameter state (in master map key order).
+	XGParamState *state() const;
+
+	const QList<XGParam *>& params() const;
+
+	// Dense state layout signature.
+	unsigned int layout() const;
+
+	// Contiguous dense state slices (first index and count).
+	struct Range
+	{
+		unsigned int first;
+		unsigned int count;
+	};
+
+	// Whole block (eg. drum set) and sub-block (eg. part, drum note,
+	// user voice) address ranges; empty if not found.
+	Range range(unsigned short high) const;
+	Range range(unsigned short high, unsigned short mid) const;
+
+	// Modified from default parameters (in key order).
+	int modified_params(QList<XGParam *>& list) const;
+
+	// Whether any sub-block parameter is modified from default
+	// or has changed since last save (eg. part, drum note, user voice).
+	bool is_modified(unsigned short high, unsigned short mid) const;
+	bool is_unsaved(unsigned short high, unsigned short mid) const;
+
+	// Mark all as saved.
+	void reset_unsaved();
+
 	// NRPN parameter map.
 	XGRpnParamMap NRPN;
 
+	// Direct SysEx data receiver.
+	typedef QMultiMap<XGParamKey, QByteArray> SysexData;
+
+	bool add_sysex_data(SysexData& sysex_data,
+		unsigned char *data, unsigned short len) const;
+	bool set_sysex_data(const SysexData& sysex_data, bool bNotify = false);
+
+	// Direct parameter data access.
+	virtual bool set_param_data(
+		XGParam *param, unsigned char *data, bool bNotify = false);
+
+protected:
+
+	// Parameter data decoder (raw SysEx data to value).
+	static void decode_param_data(XGParam *param,
+		unsigned char *data, XGParamObserver *sender = nullptr);
+
 private:
 
 	// Instance variables.
 	QHash<XGParam *, XGParamMap *> m_params_map;
 
+	// Dense parameter state.
+	XGParamState *m_state;
+
+	QList<XGParam *> m_params;
+
+	unsigned int m_layout;
+
+	// Dense state slices, by high and by (high << 8) | mid.
+	QHash<unsigned short, Range> m_high_ranges;
+	QHash<unsigned short, Range> m_mid_ranges;
+
 	// Pseudo-singleton reference.
 	static XGParamMasterMap *g_pParamMasterMap;
 };
@@ -0,0 +1,278 @@
+// XGParamEncoder.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "XGParamEncoder.h"
+#include "XGParamSysex.h"
+#include "XGParam.h"
+
+
+// Table size helper.
+#define TSIZE(tab)	(sizeof(tab) / sizeof(tab[0]))
+
+
+//-------------------------------------------------------------------------
+// XG MULTIPART Control Change equivalents.
+//
+typedef
+struct _XGControlItem
+{
+	unsigned short   low;   // MULTIPART low address (id).
+	unsigned char    cc;    // Control Change number.
+	unsigned short   rcv;   // MULTIPART receive switch (id).
+
+} XGControlItem;
+
+
+static
+XGControlItem MULTIPARTControlTab[] =
+{	//low    cc    rcv
+
+	{ 0x0b,    7, 0x39 }, // Volume
+	{ 0x0e,   10, 0x3a }, // Pan (but 0=random)
+	{ 0x12,   93, 0x33 }, // Chorus Send
+	{ 0x13,   91, 0x33 }, // Reverb Send
+	{ 0x14,   94, 0x33 }, // Variation Send
+	{ 0x18,   74, 0x33 }, // Filter Cutoff
+	{ 0x19,   71, 0x33 }, // Filter Resonance
+	{ 0x1a,   73, 0x33 }, // EG Attack
+	{ 0x1c,   72, 0x33 }  // EG Release
+};
+
+
+//-------------------------------------------------------------------------
+// XG Parameter change encoder (cheapest wire encoding).
+
+// Constructor.
+XGParamEncoder::XGParamEncoder ( XGParamMasterMap *master )
+	: m_master(master), m_bytes(0), m_sysex_bytes(0)
+{
+	if (m_master == nullptr)
+		m_master = XGParamMasterMap::getInstance();
+
+	// Reverse NRPN map...
+	if (m_master) {
+		XGRpnParamMap::const_iterator iter = m_master->NRPN.constBegin();
+		for (; iter != m_master->NRPN.constEnd(); ++iter)
+			m_nrpn.insert(iter.value(), iter.key().param());
+	}
+
+	reset();
+}
+
+
+// Encode a parameter change, the cheapest way.
+XGParamEncoder::Type XGParamEncoder::encode (
+	XGParam *param, QByteArray& data )
+{
+	data.clear();
+
+	const unsigned short high = param->high();
+	const unsigned short mid  = param->mid();
+	const unsigned short low  = param->low();
+
+	// XG Parameter Change: F0 43 1n 4C hi mid lo <data> F7
+	unsigned short cost = 8 + param->size();
+	m_sysex_bytes += cost;
+
+	Type type = Sysex;
+	int ch = -1;
+	unsigned char cc = 0;
+	unsigned short nrpn = 0xffff;
+	unsigned char val = 0;
+
+	if (m_master && param->size() == 1) {
+		param->set_data_value(&val, param->value());
+		val &= 0x7f;
+		// Control Change equivalent?
+		if (high == 0x08) {
+			for (unsigned short i = 0; i < TSIZE(MULTIPARTControlTab); ++i) {
+				const XGControlItem *item = &MULTIPARTControlTab[i];
+				if (item->low != low || (low == 0x0e && val == 0))
+					continue;
+				const int ch1 = part_channel(mid, item->rcv);
+				if (ch1 >= 0 && control_cost(ch1) < cost) {
+					cost = control_cost(ch1);
+					type = Control;
+					ch = ch1;
+					cc = item->cc;
+				}
+				break;
+			}
+		}
+		// NRPN equivalent?
+		QHash<XGParam *, unsigned short>::const_iterator iter
+			= m_nrpn.constFind(param);
+		if (type == Sysex && iter != m_nrpn.constEnd()) {
+			const int part = (high == 0x08 ? int(mid) : drum_part(high - 0x30));
+			const int ch2 = (part >= 0 ? part_channel(part, 0x37) : -1);
+			if (ch2 >= 0) {
+				// Data Entry, after NRPN MSB/LSB select, if not already...
+				unsigned short cost2 = control_cost(ch2);
+				if (m_select[ch2] != iter.value())
+					cost2 += 4;
+				if (cost2 < cost) {
+					cost = cost2;
+					type = Nrpn;
+					ch = ch2;
+					nrpn = iter.value();
+				}
+			}
+		}
+	}
+
+	switch (type) {
+	case Control:
+		add_control(data, ch, cc, val);
+		break;
+	case Nrpn:
+		if (m_select[ch] != nrpn) {
+			add_control(data, ch, 0x63, (nrpn >> 7) & 0x7f);
+			add_control(data, ch, 0x62, nrpn & 0x7f);
+			m_select[ch] = nrpn;
+		}
+		add_control(data, ch, 0x06, val);
+		break;
+	case Sysex:
+	default: {
+		XGParamSysex sysex(param);
+		data.append((const char *) sysex.data(), sysex.size());
+		m_bytes += sysex.size();
+		m_status = 0;
+		// Part channel or mode changes void NRPN selections...
+		if (high == 0x08 && (low == 0x04 || low == 0x07))
+			reset();
+		else
+		// XG System On, All Parameter Reset void them all...
+		if (high == 0x00 && mid == 0x00 && low >= 0x7d)
+			reset();
+		break;
+	}}
+
+	return type;
+}
+
+
+// Forget running status and NRPN selections (eg. device reset).
+void XGParamEncoder::reset (void)
+{
+	m_status = 0;
+
+	for (unsigned short i = 0; i < 16; ++i)
+		m_select[i] = 0xffff;
+}
+
+
+// Account for a SysEx message sent elsewhere.
+void XGParamEncoder::sysex_sent ( unsigned short size )
+{
+	// SysEx cancels running status...
+	m_status = 0;
+
+	m_bytes += size;
+	m_sysex_bytes += size;
+}
+
+
+// Wire statistics (actual and SysEx only bytes).
+unsigned long XGParamEncoder::bytes (void) const
+{
+	return m_bytes;
+}
+
+unsigned long XGParamEncoder::sysex_bytes (void) const
+{
+	return m_sysex_bytes;
+}
+
+
+// Part receive channel, when exclusive (-1 otherwise).
+int XGParamEncoder::part_channel (
+	unsigned short part, unsigned short rcv ) const
+{
+	const unsigned short ch = part_value(part, 0x04);
+	if (ch > 15)
+		return -1;
+
+	// Receive Control Change (and the specific one)...
+	if (part_value(part, 0x33) == 0)
+		return -1;
+	if (rcv != 0x33 && part_value(part, rcv) == 0)
+		return -1;
+
+	// Must be the only part receiving on this channel...
+	for (unsigned short i = 0; i < 16; ++i) {
+		if (i != part && part_value(i, 0x04) == ch)
+			return -1;
+	}
+
+	return ch;
+}
+
+
+// Part assigned to a drum setup, when exclusive (-1 otherwise).
+int XGParamEncoder::drum_part ( unsigned short drumset ) const
+{
+	int part = -1;
+
+	for (unsigned short i = 0; i < 16; ++i) {
+		// Part Mode: 1=Drum, 2=DrumS1, 3=DrumS2.
+		const unsigned short mode = part_value(i, 0x07);
+		if (mode == drumset + 2 || (mode == 1 && drumset == 0)) {
+			if (part >= 0)
+				return -1;
+			part = i;
+		}
+	}
+
+	return part;
+}
+
+
+// Part parameter value lookup.
+unsigned short XGParamEncoder::part_value (
+	unsigned short part, unsigned short low ) const
+{
+	XGParam *param = m_master->find_param(0x08, part, low);
+	return (param ? param->value() : 0);
+}
+
+
+// Control Change helpers.
+unsigned short XGParamEncoder::control_cost ( unsigned char ch ) const
+{
+	return (m_status == (0xb0 | ch) ? 2 : 3);
+}
+
+
+void XGParamEncoder::add_control ( QByteArray& data,
+	unsigned char ch, unsigned char cc, unsigned char val )
+{
+	m_bytes += control_cost(ch);
+	m_status = 0xb0 | ch;
+
+	// Always the complete message, running status is up to the driver.
+	data.append(char(m_status));
+	data.append(char(cc & 0x7f));
+	data.append(char(val & 0x7f));
+}
+
+
+// end of XGParamEncoder.cpp
@@ -0,0 +1,103 @@
+// XGParamEncoder.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __XGParamEncoder_h
+#define __XGParamEncoder_h
+
+#include <QByteArray>
+#include <QHash>
+
+// Forward declarations.
+class XGParam;
+class XGParamMasterMap;
+
+
+//-------------------------------------------------------------------------
+// XG Parameter change encoder (cheapest wire encoding).
+//
+// Picks, for each outgoing parameter change, the shortest of an XG
+// Parameter Change SysEx, an NRPN (with running status and a per
+// channel NRPN selection cache) or an equivalent Control Change.
+// NRPN and CC are only ever used when the target part is the sole
+// receiver on its channel and it's set to receive them.
+
+class XGParamEncoder
+{
+public:
+
+	// Constructor.
+	XGParamEncoder(XGParamMasterMap *master = nullptr);
+
+	// Encoding types.
+	enum Type { Sysex = 0, Nrpn = 1, Control = 2 };
+
+	// Encode a parameter change, the cheapest way.
+	Type encode(XGParam *param, QByteArray& data);
+
+	// Forget running status and NRPN selections (eg. device reset).
+	void reset();
+
+	// Account for a SysEx message sent elsewhere.
+	void sysex_sent(unsigned short size);
+
+	// Wire statistics (actual and SysEx only bytes).
+	unsigned long bytes() const;
+	unsigned long sysex_bytes() const;
+
+protected:
+
+	// Part receive channel, when exclusive (-1 otherwise).
+	int part_channel(unsigned short part, unsigned short rcv) const;
+
+	// Part assigned to a drum setup, when exclusive (-1 otherwise).
+	int drum_part(unsigned short drumset) const;
+
+	// Part parameter value lookup.
+	unsigned short part_value(unsigned short part, unsigned short low) const;
+
+	// Control Change helpers.
+	unsigned short control_cost(unsigned char ch) const;
+	void add_control(QByteArray& data,
+		unsigned char ch, unsigned char cc, unsigned char val);
+
+private:
+
+	// Instance variables.
+	XGParamMasterMap *m_master;
+
+	// Reverse NRPN map.
+	QHash<XGParam *, unsigned short> m_nrpn;
+
+	// Running status (0 = none).
+	unsigned char m_status;
+
+	// Last selected NRPN, per channel (0xffff = none).
+	unsigned short m_select[16];
+
+	// Wire statistics.
+	unsigned long m_bytes;
+	unsigned long m_sysex_bytes;
+};
+
+
+#endif	// __XGParamEncoder_h
+
+// end of XGParamEncoder.h
@@ -88,10 +88,12 @@ XGParamSysex::XGParamSysex ( XGParam *param )
 // (QS300) USER VOICE Bulk Dump SysEx message.
 
 // Constructor.
-XGUserVoiceSysex::XGUserVoiceSysex ( unsigned short id )
+XGUserVoiceSysex::XGUserVoiceSysex (
+	unsigned short id, XGParamMasterMap *pMasterMap )
 	: XGSysex(0x188) // (size = 0x188 = 11 + 0x17d)
 {
-	XGParamMasterMap *pMasterMap = XGParamMasterMap::getInstance();
+	if (pMasterMap == nullptr)
+		pMasterMap = XGParamMasterMap::getInstance();
 	if (pMasterMap == nullptr) {
 		::memset(m_data, 0, m_size);
 		return;
@@ -149,5 +151,214 @@ XGUserVoiceSysex::XGUserVoiceSysex ( unsigned short id )
 }
 
 
+//-------------------------------------------------------------------------
+// XG Native Bulk Dump SysEx message.
+
+// Constructor.
+XGBulkDumpSysex::XGBulkDumpSysex ( unsigned short high,
+	unsigned short mid, unsigned short low, unsigned short count,
+	XGParamMasterMap *pMasterMap )
+	: XGSysex(11 + count)
+{
+	if (pMasterMap == nullptr)
+		pMasterMap = XGParamMasterMap::getInstance();
+
+	unsigned short i = 0;
+
+	m_data[i++] = 0xf0;	// SysEx status (SOX)
+	m_data[i++] = 0x43;	// Yamaha id.
+	m_data[i++] = 0x00;	// Device no.
+	m_data[i++] = 0x4c;	// XG Model id.
+	m_data[i++] = (count >> 7) & 0x7f;	// Byte count MSB.
+	m_data[i++] = (count & 0x7f);		// Byte count LSB.
+
+	m_data[i++] = high;
+	m_data[i++] = mid;
+	m_data[i++] = low;
+
+	const unsigned short i0 = i;
+	while (i < m_size - 2) {
+		XGParam *param = nullptr;
+		if (pMasterMap)
+			param = pMasterMap->find_param(high, mid, low + (i - i0));
+		if (param && i + param->size() <= m_size - 2) {
+			if (param->size() > 4) {
+				XGDataParam *dataparam = static_cast<XGDataParam *> (param);
+				::memcpy(&m_data[i], dataparam->data(), dataparam->size());
+			}
+			else
+			if (high == 0x08 && param->low() == 0x09) { // DETUNE (2byte, 4bit).
+				param->set_data_value2(&m_data[i], param->value());
+			}
+			else {
+				param->set_data_value(&m_data[i], param->value());
+			}
+			i += param->size();
+		} else {
+			m_data[i++] = 0x00;
+		}
+	}
+
+	// Compute checksum...
+	unsigned char cksum = 0;
+	for (unsigned short j = 4; j < i; ++j) {
+		cksum += m_data[j];
+		cksum &= 0x7f;
+	}
+	m_data[i++] = (0x80 - cksum) & 0x7f;
+
+	// Coda...
+	m_data[i] = 0xf7;		// SysEx status (EOX)
+}
+
+
+//-------------------------------------------------------------------------
+// XG Dump Request / Parameter Request SysEx message.
+
+// Constructor.
+XGRequestSysex::XGRequestSysex ( unsigned short high,
+	unsigned short mid, unsigned short low, Type type )
+	: XGSysex(8)
+{
+	unsigned short i = 0;
+
+	m_data[i++] = 0xf0;	// SysEx status (SOX)
+	m_data[i++] = 0x43;	// Yamaha id.
+	m_data[i++] = type;	// Request type | Device no.
+	m_data[i++] = (high == 0x11 ? 0x4b : 0x4c); // QS300/XG Model id.
+
+	m_data[i++] = high;
+	m_data[i++] = mid;
+	m_data[i++] = low;
+
+	m_data[i] = 0xf7;		// SysEx status (EOX)
+}
+
+
+//-------------------------------------------------------------------------
+// XG Parameter Change / Native Bulk Dump SysEx message decoder.
+
+// Constructor.
+XGSysexDecoder::XGSysexDecoder ( const unsigned char *data, unsigned int len )
+	: m_status(TooShort), m_mode(0), m_high(0), m_mid(0), m_low(0),
+		m_data(nullptr), m_size(0)
+{
+	// Shortest: F0 43 1n 4C hh mm ll dd F7.
+	if (data == nullptr || len < 9 || len > 0xffff)
+		return;
+
+	m_status = NotSysex;
+	if (data[0] != 0xf0 || data[len - 1] != 0xf7)
+		return;
+
+	m_status = NotYamaha;
+	if (data[1] != 0x43)
+		return;
+
+	m_status = NotXG;
+	if (data[3] != 0x4c && data[3] != 0x4b)
+		return;
+
+	m_status = BadMode;
+	if (data[2] & 0x80)
+		return;
+
+	unsigned int i;
+
+	m_mode = (data[2] & 0x70);
+	if (m_mode == 0x00) {
+		// Native Bulk Dump: F0 43 0n 4C sh sl hh mm ll dd... cc F7.
+		m_status = BadData;
+		if ((data[4] | data[5]) & 0x80)
+			return;
+		const unsigned int size = (data[4] << 7) + data[5];
+		m_status = BadSize;
+		if (size < 1 || size + 11 != len)
+			return;
+		// Checksum covers the byte count, address, data and itself...
+		m_status = BadData;
+		unsigned char cksum = 0;
+		for (i = 4; i < len - 1; ++i) {
+			const unsigned char c = data[i];
+			if (c & 0x80)
+				return;
+			cksum += c;
+		}
+		m_status = BadChecksum;
+		if (cksum & 0x7f)
+			return;
+		m_high = data[6];
+		m_mid  = data[7];
+		m_low  = data[8];
+		m_data = &data[9];
+		m_size = size;
+	}
+	else
+	if (m_mode == 0x10) {
+		// Parameter Change: F0 43 1n 4C hh mm ll dd... F7.
+		m_status = BadData;
+		for (i = 4; i < len - 1; ++i) {
+			if (data[i] & 0x80)
+				return;
+		}
+		m_high = data[4];
+		m_mid  = data[5];
+		m_low  = data[6];
+		m_data = &data[7];
+		m_size = len - 8;
+	}
+	else return;
+
+	m_status = Ok;
+}
+
+
+// Decoder status accessors.
+XGSysexDecoder::Status XGSysexDecoder::status (void) const
+{
+	return m_status;
+}
+
+bool XGSysexDecoder::is_valid (void) const
+{
+	return (m_status == Ok);
+}
+
+
+// Native Bulk Dump (otherwise Parameter Change).
+bool XGSysexDecoder::is_bulk_dump (void) const
+{
+	return (m_mode == 0x00);
+}
+
+
+// Start address.
+unsigned short XGSysexDecoder::high (void) const
+{
+	return m_high;
+}
+
+unsigned short XGSysexDecoder::mid (void) const
+{
+	return m_mid;
+}
+
+unsigned short XGSysexDecoder::low (void) const
+{
+	return m_low;
+}
+
+
+// Parameter data block (points into the message).
+const unsigned char *XGSysexDecoder::data (void) const
+{
+	return m_data;
+}
+
+unsigned short XGSysexDecoder::size (void) const
+{
+	return m_size;
+}
+
 
 // end of XGParamSysex.cpp
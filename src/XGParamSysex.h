@@ -24,6 +24,7 @@
 
 // Forward ddeclarations.
 class XGParam;
+class XGParamMasterMap;
 
 
 //-------------------------------------------------------------------------
@@ -72,7 +73,90 @@ class XGUserVoiceSysex : public XGSysex
 public:
 
 	// Constructor.
-	XGUserVoiceSysex(unsigned short id);
+	XGUserVoiceSysex(unsigned short id, XGParamMasterMap *pMasterMap = nullptr);
+};
+
+
+//-------------------------------------------------------------------------
+// XG Native Bulk Dump SysEx message (one contiguous address block,
+// current values; eg. a MULTIPART or DRUMSETUP sub-block).
+
+class XGBulkDumpSysex : public XGSysex
+{
+public:
+
+	// Constructor.
+	XGBulkDumpSysex(unsigned short high, unsigned short mid,
+		unsigned short low, unsigned short count,
+		XGParamMasterMap *pMasterMap = nullptr);
+};
+
+
+//-------------------------------------------------------------------------
+// XG Dump Request / Parameter Request SysEx message.
+
+class XGRequestSysex : public XGSysex
+{
+public:
+
+	// Request types.
+	enum Type { DumpRequest = 0x20, ParamRequest = 0x30 };
+
+	// Constructor.
+	XGRequestSysex(unsigned short high, unsigned short mid,
+		unsigned short low, Type type = DumpRequest);
+};
+
+
+//-------------------------------------------------------------------------
+// XG Parameter Change / Native Bulk Dump SysEx message decoder.
+//
+// Validates the whole message in one single pass: framing, Yamaha and
+// model ids, declared size against actual length, 7bit data bytes and
+// bulk dump checksum; nothing gets copied nor allocated.
+
+class XGSysexDecoder
+{
+public:
+
+	// Decoder status.
+	enum Status {
+		Ok = 0, TooShort, NotSysex, NotYamaha, NotXG,
+		BadMode, BadSize, BadData, BadChecksum
+	};
+
+	// Constructor.
+	XGSysexDecoder(const unsigned char *data, unsigned int len);
+
+	// Decoder status accessors.
+	Status status() const;
+	bool is_valid() const;
+
+	// Native Bulk Dump (otherwise Parameter Change).
+	bool is_bulk_dump() const;
+
+	// Start address.
+	unsigned short high() const;
+	unsigned short mid()  const;
+	unsigned short low()  const;
+
+	// Parameter data block (points into the message).
+	const unsigned char *data() const;
+	unsigned short size() const;
+
+private:
+
+	// Instance variables.
+	Status m_status;
+
+	unsigned char m_mode;
+
+	unsigned short m_high;
+	unsigned short m_mid;
+	unsigned short m_low;
+
+	const unsigned char *m_data;
+	unsigned short m_size;
 };
 
 
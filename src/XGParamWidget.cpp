@@ -21,6 +21,25 @@
 
 #include "XGParamWidget.h"
 
+
+//-------------------------------------------------------------------------
+// class XGParamWidgetMenu - XGParam widget context menu handler.
+//
+// Pseudo-singleton reference.
+XGParamWidgetMenu *XGParamWidgetMenu::g_pParamWidgetMenu = nullptr;
+
+// Pseudo-singleton accessors (static).
+XGParamWidgetMenu *XGParamWidgetMenu::getInstance (void)
+{
+	return g_pParamWidgetMenu;
+}
+
+void XGParamWidgetMenu::setInstance ( XGParamWidgetMenu *menu )
+{
+	g_pParamWidgetMenu = menu;
+}
+
+
 #ifdef XGPARAM_WIDGET_MAP
 
 #include <QWidget>
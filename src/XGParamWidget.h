@@ -24,8 +24,36 @@
 
 #include "XGParam.h"
 
+#include "qxgeditAlloc.h"
+
 // Forward decl.
 class QWidget;
+class QContextMenuEvent;
+
+
+//-------------------------------------------------------------------------
+// class XGParamWidgetMenu - XGParam widget context menu handler.
+//
+class XGParamWidgetMenu
+{
+public:
+
+	// Virtual destructor.
+	virtual ~XGParamWidgetMenu() {}
+
+	// Context menu handler (true if handled).
+	virtual bool context_menu(QWidget *widget,
+		XGParam *param, QContextMenuEvent *event) = 0;
+
+	// Pseudo-singleton accessors.
+	static XGParamWidgetMenu *getInstance();
+	static void setInstance(XGParamWidgetMenu *menu);
+
+private:
+
+	// Pseudo-singleton reference.
+	static XGParamWidgetMenu *g_pParamWidgetMenu;
+};
 
 
 #ifdef XGPARAM_WIDGET_MAP
@@ -130,7 +158,12 @@ public:
 	public:
 		// Constructor.
 		Observer(XGParam *param, XGParamWidget<W> *widget)
-			: XGParamObserver(param), m_widget(widget) {}
+			: XGParamObserver(param), m_widget(widget)
+			{ qxgeditAlloc::acquire(qxgeditAlloc::WidgetObserver, sizeof(Observer)); }
+
+		// Destructor.
+		~Observer()
+			{ qxgeditAlloc::release(qxgeditAlloc::WidgetObserver, sizeof(Observer)); }
 
 	protected:
 		// Observer resetter.
@@ -224,6 +257,17 @@ public:
 
 protected:
 
+	// Context menu (eg. MIDI Learn) handler.
+	void contextMenuEvent(QContextMenuEvent *event)
+	{
+		XGParamWidgetMenu *menu = XGParamWidgetMenu::getInstance();
+		XGParam *param_ = param();
+		if (menu && param_ && menu->context_menu(this, param_, event))
+			return;
+
+		W::contextMenuEvent(event);
+	}
+
 	// Paramset observers.
 	XGParamSet *add_paramset(unsigned short id)
 	{
@@ -53,6 +53,9 @@
 /* Define if debugger stack-trace is enabled. */
 #cmakedefine CONFIG_STACKTRACE @CONFIG_STACKTRACE@
 
+/* Define if hot-path trace points are enabled. */
+#cmakedefine CONFIG_TRACE @CONFIG_TRACE@
+
 /* Define if Wayland is supported */
 #cmakedefine CONFIG_WAYLAND @CONFIG_WAYLAND@
 
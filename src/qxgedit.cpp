@@ -26,6 +26,9 @@
 
 #include "qxgeditPaletteForm.h"
 
+#include "qxgeditTrace.h"
+#include "qxgeditStartup.h"
+
 #include <QDir>
 
 #include <QStyleFactory>
@@ -34,6 +37,8 @@
 #include <QTranslator>
 #include <QLocale>
 
+#include <cstdio>
+
 #ifndef CONFIG_PREFIX
 #define CONFIG_PREFIX	"/usr/local"
 #endif
@@ -88,6 +93,7 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QHostInfo>
+#include "qxgeditControl.h"
 #endif
 
 #endif	// CONFIG_XUNIQUE
@@ -445,6 +451,19 @@ void qxgeditApplication::readyReadSlot (void)
 {
 	QLocalSocket *pSocket = qobject_cast<QLocalSocket *> (sender());
 	if (pSocket) {
+		// Remote control session? hand it over...
+		const QByteArray& magic = pSocket->peek(4);
+		if (QByteArray(qxgeditControl::magic()).startsWith(magic)) {
+			if (magic.length() < 4)
+				return;
+			QObject::disconnect(pSocket,
+				SIGNAL(readyRead()),
+				this, SLOT(readyReadSlot()));
+			// Must survive any server reset...
+			pSocket->setParent(this);
+			new qxgeditControl(pSocket);
+			return;
+		}
 		const qint64 nread = pSocket->bytesAvailable();
 		if (nread > 0) {
 			const QByteArray data = pSocket->read(nread);
@@ -549,6 +568,8 @@ int main ( int argc, char **argv )
 
 	qxgeditApplication app(argc, argv);
 
+	qxgeditStartup::mark("application");
+
 	// Construct default settings; override with command line arguments.
 	qxgeditOptions options;
 	if (!options.parse_args(app.arguments())) {
@@ -556,12 +577,16 @@ int main ( int argc, char **argv )
 		return 1;
 	}
 
+	qxgeditStartup::mark("settings");
+
 	// Have another instance running?
 	if (app.setup()) {
 		app.quit();
 		return 2;
 	}
 
+	qxgeditStartup::mark("single instance");
+
 	// Set default base font...
 	if (options.iBaseFontSize > 0)
 		app.setFont(QFont(app.font().family(), options.iBaseFontSize));
@@ -604,15 +629,44 @@ int main ( int argc, char **argv )
 			&options.settings(), options.sColorTheme, pal))
 		app.setPalette(pal);
 
+	qxgeditStartup::mark("style");
+
 	// Construct, setup and show the main form (a pseudo-singleton).
 	qxgeditMainForm w;
 	w.setup(&options);
 	w.show();
 
+	qxgeditStartup::mark("show");
+
+	// Startup profile mode (report on first paint)...
+	if (options.bProfileStartup)
+		qxgeditStartup::profile(&w, options.iStartupBudget);
+	else
+		qxgeditStartup::finish();
+
 	// Settle this one as application main widget...
 	app.setMainWidget(&w);
 
-	return app.exec();
+	const int ret = app.exec();
+
+	// Allocation accounting report (all modules still alive)...
+	if (options.bAllocReport) {
+		::fprintf(stderr, "\nAllocation report:\n\n");
+		foreach (const QString& sLine, w.allocReport())
+			::fprintf(stderr, "  %s\n", sLine.toUtf8().constData());
+		::fprintf(stderr, "\n");
+	}
+
+#ifdef CONFIG_TRACE
+	// Hot-path trace points export...
+	if (!options.sTraceFile.isEmpty()
+		&& !qxgeditTrace::save(options.sTraceFile)) {
+		qWarning("Warning: could not save trace file: %s.",
+			options.sTraceFile.toUtf8().constData());
+	}
+#endif
+
+	return ret;
 }
 
 
@@ -0,0 +1,144 @@
+// qxgeditAlloc.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAlloc.h"
+
+#include "XGParam.h"
+
+
+//----------------------------------------------------------------------------
+// qxgeditAlloc -- Live object and byte accounting (per subsystem).
+
+// Counters.
+std::atomic<long> qxgeditAlloc::g_counts[qxgeditAlloc::KindCount];
+std::atomic<long> qxgeditAlloc::g_bytes[qxgeditAlloc::KindCount];
+
+
+// Current figures.
+long qxgeditAlloc::count ( Kind kind )
+{
+	return g_counts[kind].load(std::memory_order_relaxed);
+}
+
+long qxgeditAlloc::bytes ( Kind kind )
+{
+	return g_bytes[kind].load(std::memory_order_relaxed);
+}
+
+
+const char *qxgeditAlloc::name ( Kind kind )
+{
+	switch (kind) {
+	case Param:          return "XGParam";
+	case EffectParam:    return "XGEffectParam";
+	case DataParam:      return "XGDataParam";
+	case MasterObserver: return "Master map observers";
+	case WidgetObserver: return "Widget observers";
+	case MidiBuffer:     return "Queued MIDI buffers";
+	default:             return "?";
+	}
+}
+
+
+// Report line formatter.
+QString qxgeditAlloc::line ( const char *name, long count, long bytes )
+{
+	return QString("%1 %2 %3")
+		.arg(QString::fromLatin1(name), -28)
+		.arg(count, 10)
+		.arg(bytes, 12);
+}
+
+
+// Report lines (one per subsystem, plus totals).
+QStringList qxgeditAlloc::report ( const QList<XGParamMasterMap *>& maps )
+{
+	QStringList lines;
+	lines.append(QString("%1 %2 %3")
+		.arg(QString("subsystem"), -28)
+		.arg(QString("objects"), 10)
+		.arg(QString("bytes"), 12));
+
+	long nobjects = 0;
+	long nbytes = 0;
+
+	// Counted objects...
+	for (int i = 0; i < KindCount; ++i) {
+		const Kind kind = Kind(i);
+		const long n = count(kind);
+		const long b = bytes(kind);
+		lines.append(line(name(kind), n, b));
+		nobjects += n;
+		nbytes += b;
+	}
+
+	// Container nodes (estimated, by walking all master maps)...
+	long nsets = 0;
+	long nsets_bytes = 0;
+	long nkeys = 0;
+	long nkeys_bytes = 0;
+
+	const long set_node = 2 * sizeof(void *)
+		+ sizeof(unsigned int) + sizeof(unsigned short);
+	const long map_node = 3 * sizeof(void *)
+		+ sizeof(XGParamKey) + sizeof(XGParam *);
+
+	QListIterator<XGParamMasterMap *> iter(maps);
+	while (iter.hasNext()) {
+		XGParamMasterMap *pMasterMap = iter.next();
+		if (pMasterMap == nullptr)
+			continue;
+		const XGParamMap *param_maps[] = {
+			&pMasterMap->SYSTEM,
+			&pMasterMap->REVERB,
+			&pMasterMap->CHORUS,
+			&pMasterMap->VARIATION,
+			&pMasterMap->MULTIPART,
+			&pMasterMap->DRUMSETUP,
+			&pMasterMap->USERVOICE
+		};
+		for (const XGParamMap *param_map : param_maps) {
+			XGParamMap::ConstIterator it = param_map->constBegin();
+			for (; it != param_map->constEnd(); ++it) {
+				const XGParamSet *paramset = it.value();
+				nsets += paramset->count();
+				nsets_bytes += sizeof(XGParamSet)
+					+ paramset->count() * set_node
+					+ paramset->capacity() * sizeof(void *);
+			}
+		}
+		nkeys += pMasterMap->count();
+		nkeys_bytes += pMasterMap->count() * map_node;
+	}
+
+	lines.append(line("XGParamSet nodes (est.)", nsets, nsets_bytes));
+	lines.append(line("Master map nodes (est.)", nkeys, nkeys_bytes));
+
+	nobjects += nsets + nkeys;
+	nbytes += nsets_bytes + nkeys_bytes;
+
+	lines.append(line("total", nobjects, nbytes));
+
+	return lines;
+}
+
+
+// end of qxgeditAlloc.cpp
@@ -0,0 +1,94 @@
+// qxgeditAlloc.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditAlloc_h
+#define __qxgeditAlloc_h
+
+#include <QStringList>
+#include <QList>
+
+#include <atomic>
+
+
+// Forward declarations.
+class XGParamMasterMap;
+
+
+//----------------------------------------------------------------------------
+// qxgeditAlloc -- Live object and byte accounting (per subsystem).
+//
+// Counted objects account for themselves on construction and
+// destruction, so that the figures stand for what is alive right
+// now, whether still reachable or leaked; container nodes are
+// estimated by walking the given master maps on report.
+
+class qxgeditAlloc
+{
+public:
+
+	// Accounted subsystems (concrete classes).
+	enum Kind {
+		Param = 0,          // XGParam (plain).
+		EffectParam,        // XGEffectParam.
+		DataParam,          // XGDataParam (and its data buffer).
+		MasterObserver,     // qxgeditXGMasterMap::Observer.
+		WidgetObserver,     // XGParamWidget<W>::Observer.
+		MidiBuffer,         // Queued MIDI output messages.
+		KindCount
+	};
+
+	// Object accounting (any thread).
+	static void acquire(Kind kind, long nbytes)
+	{
+		g_counts[kind].fetch_add(1, std::memory_order_relaxed);
+		g_bytes[kind].fetch_add(nbytes, std::memory_order_relaxed);
+	}
+
+	static void release(Kind kind, long nbytes)
+	{
+		g_counts[kind].fetch_sub(1, std::memory_order_relaxed);
+		g_bytes[kind].fetch_sub(nbytes, std::memory_order_relaxed);
+	}
+
+	// Current figures.
+	static long count(Kind kind);
+	static long bytes(Kind kind);
+
+	static const char *name(Kind kind);
+
+	// Report lines (one per subsystem, plus totals).
+	static QStringList report(const QList<XGParamMasterMap *>& maps);
+
+	// Report line formatter.
+	static QString line(const char *name, long count, long bytes);
+
+private:
+
+	// Counters.
+	static std::atomic<long> g_counts[KindCount];
+	static std::atomic<long> g_bytes[KindCount];
+};
+
+
+#endif	// __qxgeditAlloc_h
+
+
+// end of qxgeditAlloc.h
@@ -22,6 +22,8 @@
 #include "qxgeditAbout.h"
 #include "qxgeditAmpEg.h"
 
+#include "qxgeditTrace.h"
+
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
@@ -152,6 +154,8 @@ unsigned short qxgeditAmpEg::level2 (void) const
 // Draw curve.
 void qxgeditAmpEg::paintEvent ( QPaintEvent *pPaintEvent )
 {
+	QXGEDIT_TRACE("qxgeditAmpEg::paintEvent");
+
 	QPainter painter(this);
 
 	const int h  = height();
@@ -0,0 +1,665 @@
+// qxgeditBench.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "XGParam.h"
+#include "XGParamSysex.h"
+
+#include "qxgeditMidiRpn.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <cstdio>
+#include <cstdlib>
+
+
+//-------------------------------------------------------------------------
+// qxgeditBenchObserver - Counting observer (stands for a widget).
+
+class qxgeditBenchObserver : public XGParamObserver
+{
+public:
+
+	qxgeditBenchObserver(XGParam *param)
+		: XGParamObserver(param) {}
+
+	static unsigned long resets;
+	static unsigned long updates;
+
+protected:
+
+	void reset()  { ++resets;  }
+	void update() { ++updates; }
+};
+
+unsigned long qxgeditBenchObserver::resets  = 0;
+unsigned long qxgeditBenchObserver::updates = 0;
+
+
+//-------------------------------------------------------------------------
+// qxgeditBenchResult - One benchmark result record.
+
+struct qxgeditBenchResult
+{
+	const char   *name;     // Benchmark name.
+	int           count;    // Timed operations.
+	unsigned long items;    // Items (params, events, messages) per operation.
+	double        ns;       // Nanoseconds per operation.
+	double        ref;      // Reference nanoseconds per operation (0=n/a).
+};
+
+static bool g_bench_csv = false;
+
+
+static void qxgedit_bench_header (void)
+{
+	if (g_bench_csv) {
+		::printf("name,count,items,ns_per_op,ref_ns_per_op,speedup\n");
+	} else {
+		::printf("%-12s %8s %8s %12s %12s %9s\n",
+			"bench", "count", "items", "ns/op", "ns/ref", "speedup");
+	}
+}
+
+
+static void qxgedit_bench_print ( const qxgeditBenchResult& result )
+{
+	const double speedup
+		= (result.ref > 0.0 && result.ns > 0.0 ? result.ref / result.ns : 0.0);
+
+	if (g_bench_csv) {
+		::printf("%s,%d,%lu,%.1f,%.1f,%.2f\n",
+			result.name, result.count, result.items,
+			result.ns, result.ref, speedup);
+	}
+	else
+	if (result.ref > 0.0) {
+		::printf("%-12s %8d %8lu %12.1f %12.1f %8.2fx\n",
+			result.name, result.count, result.items,
+			result.ns, result.ref, speedup);
+	} else {
+		::printf("%-12s %8d %8lu %12.1f %12s %9s\n",
+			result.name, result.count, result.items,
+			result.ns, "-", "-");
+	}
+
+	::fflush(stdout);
+}
+
+
+static double qxgedit_bench_ns ( const QElapsedTimer& timer, int count )
+{
+	return double(timer.nsecsElapsed()) / double(count);
+}
+
+
+//-------------------------------------------------------------------------
+// Master map construction timing.
+
+static void qxgedit_bench_construct ( int count )
+{
+	QElapsedTimer timer;
+
+	unsigned long items = 0;
+
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		XGParamMasterMap master;
+		items = master.size();
+	}
+
+	const qxgeditBenchResult result
+		= { "construct", count, items, qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// Master map finder timing (every address, in turn).
+
+static void qxgedit_bench_find ( XGParamMasterMap& master, int count )
+{
+	QElapsedTimer timer;
+
+	const QList<XGParam *>& params = master.params();
+	const int nparams = params.count();
+
+	unsigned long found = 0;
+
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		XGParam *param = params.at(i % nparams);
+		if (master.find_param(param->high(), param->mid(), param->low()))
+			++found;
+	}
+
+	const qxgeditBenchResult result
+		= { "find_param", count, found / count, qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// SysEx message encoding timing.
+
+static void qxgedit_bench_encode ( XGParamMasterMap& master, int count )
+{
+	QElapsedTimer timer;
+
+	const QList<XGParam *>& params = master.params();
+	const int nparams = params.count();
+
+	unsigned long bytes = 0;
+
+	// Parameter change messages (every address, in turn)...
+	timer.start();
+	for (int i = 0, j = 0; i < count; ++j) {
+		XGParam *param = params.at(j % nparams);
+		if (param->size() > 4)
+			continue;
+		XGParamSysex sysex(param);
+		bytes += sysex.size();
+		++i;
+	}
+
+	const qxgeditBenchResult result1
+		= { "param_sysex", count, bytes / count, qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result1);
+
+	// User voice bulk dumps (every user voice, in turn)...
+	const int nusers = count / 100 + 1;
+	bytes = 0;
+	timer.start();
+	for (int i = 0; i < nusers; ++i) {
+		XGUserVoiceSysex sysex(i % 32, &master);
+		bytes += sysex.size();
+	}
+
+	const qxgeditBenchResult result2
+		= { "user_sysex", nusers, bytes / nusers, qxgedit_bench_ns(timer, nusers), 0.0 };
+	qxgedit_bench_print(result2);
+}
+
+
+//-------------------------------------------------------------------------
+// SysEx full dump decoding timing (add_sysex_data + set_sysex_data).
+
+static void qxgedit_bench_reset ( XGParamMasterMap& master )
+{
+	QListIterator<XGParam *> iter(master.params());
+	while (iter.hasNext())
+		iter.next()->reset();
+}
+
+
+static void qxgedit_bench_decode ( XGParamMasterMap& master, int count )
+{
+	QElapsedTimer timer;
+
+	// Build the full dump (every parameter change, all user voices)...
+	QList<QByteArray> dump;
+	const QList<XGParam *>& params = master.params();
+	QListIterator<XGParam *> iter(params);
+	while (iter.hasNext()) {
+		XGParam *param = iter.next();
+		if (param->size() > 4 || param->high() == 0x11)
+			continue;
+		param->randomize_value(100.0f);
+		XGParamSysex sysex(param);
+		dump.append(QByteArray((const char *) sysex.data(), sysex.size()));
+	}
+	for (unsigned short id = 0; id < 32; ++id) {
+		XGUserVoiceSysex sysex(id, &master);
+		dump.append(QByteArray((const char *) sysex.data(), sysex.size()));
+	}
+
+	qxgedit_bench_reset(master);
+
+	qxgeditBenchObserver::updates = 0;
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		XGParamMasterMap::SysexData sysex_data;
+		QListIterator<QByteArray> iter2(dump);
+		while (iter2.hasNext()) {
+			QByteArray data = iter2.next();
+			master.add_sysex_data(sysex_data,
+				(unsigned char *) data.data(), data.size());
+		}
+		master.set_sysex_data(sysex_data);
+		if (i < count - 1)
+			qxgedit_bench_reset(master);
+	}
+
+	const qxgeditBenchResult result
+		= { "sysex_dump", count, (unsigned long) dump.count(),
+			qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// Observer fan-out timing (eight more observers per part parameter).
+
+static void qxgedit_bench_fanout ( XGParamMasterMap& master, int count )
+{
+	QElapsedTimer timer;
+
+	const QList<XGParam *>& params = master.params();
+	const XGParamMasterMap::Range range = master.range(0x08, 0x00);
+	const unsigned int last = range.first + range.count;
+
+	QList<qxgeditBenchObserver *> observers;
+	for (unsigned int j = range.first; j < last; ++j) {
+		for (int k = 0; k < 8; ++k)
+			observers.append(new qxgeditBenchObserver(params.at(j)));
+	}
+
+	qxgeditBenchObserver::updates = 0;
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		XGParam *param = params.at(range.first + (i % range.count));
+		param->set_value(param->value() == param->min()
+			? param->max() : param->min());
+	}
+
+	const qxgeditBenchResult result
+		= { "fanout", count, qxgeditBenchObserver::updates / count,
+			qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result);
+
+	qDeleteAll(observers);
+}
+
+
+//-------------------------------------------------------------------------
+// (N)RPN decoding timing (one 14 bit NRPN message per operation).
+
+static void qxgedit_bench_nrpn ( int count )
+{
+	QElapsedTimer timer;
+
+	qxgeditMidiRpn xrpn;
+	qxgeditMidiRpn::Event event;
+
+	event.time = 0;
+	event.port = 0;
+
+	static const unsigned short controllers[] = { 0x63, 0x62, 0x06, 0x26 };
+
+	unsigned long events = 0;
+
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		const unsigned short values[] = {
+			(unsigned short) ((i >> 7) & 0x7f), (unsigned short) (i & 0x7f),
+			(unsigned short) ((i >> 3) & 0x7f), (unsigned short) (i & 0x7f) };
+		event.time = i;
+		event.status = qxgeditMidiRpn::CC | (i & 0x0f);
+		for (int k = 0; k < 4; ++k) {
+			event.param = controllers[k];
+			event.value = values[k];
+			xrpn.process(event);
+		}
+		qxgeditMidiRpn::Event event2;
+		while (xrpn.dequeue(event2))
+			++events;
+	}
+	xrpn.flush();
+
+	const qxgeditBenchResult result
+		= { "nrpn", count, events / count, qxgedit_bench_ns(timer, count), 0.0 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// Full map walk key switch (reference, as before per-key vectors).
+
+static void qxgedit_bench_walk ( XGParamMap& map, unsigned short key )
+{
+	const unsigned short elements = map.elements();
+	const unsigned short id0 = 0x3d + (map.current_element() * 0x50);
+	XGParamMap::const_iterator iter = map.constBegin();
+	for (; iter != map.constEnd(); ++iter) {
+		const unsigned short id = iter.key();
+		if (elements > 0 && id >= 0x3d && (id < id0 || id >= id0 + 0x50))
+			continue;
+		XGParamSet *paramset = iter.value();
+		if (paramset->contains(key)) {
+			XGParam *param = paramset->value(key);
+			if (param)
+				param->notify_reset();
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// Key switch timing, per map.
+
+typedef unsigned short (*qxgedit_bench_key) ( int i );
+
+static unsigned short qxgedit_bench_part ( int i )
+	{ return (i % 16); }
+
+static unsigned short qxgedit_bench_note ( int i )
+	{ return ((i / 72) & 1) << 7 | (13 + (i % 72)); }
+
+static unsigned short qxgedit_bench_user ( int i )
+	{ return (i % 32); }
+
+
+static void qxgedit_bench_map ( const char *name,
+	XGParamMap& map, qxgedit_bench_key key, int count )
+{
+	QElapsedTimer timer;
+
+	// Per-key vectors (current)...
+	qxgeditBenchObserver::resets = 0;
+	timer.start();
+	for (int i = 0; i < count; ++i)
+		map.set_current_key(key(i));
+	const double t1 = qxgedit_bench_ns(timer, count);
+	const unsigned long n1 = qxgeditBenchObserver::resets / count;
+
+	// Full map walk (reference)...
+	timer.start();
+	for (int i = 0; i < count; ++i)
+		qxgedit_bench_walk(map, key(i));
+	const double t2 = qxgedit_bench_ns(timer, count);
+
+	const qxgeditBenchResult result = { name, count, n1, t1, t2 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// Block reset timing (drum set ranges vs. full master map walk).
+
+static void qxgedit_bench_drums ( XGParamMasterMap& master, int count )
+{
+	QElapsedTimer timer;
+
+	const QList<XGParam *>& params = master.params();
+
+	// Contiguous range (current)...
+	qxgeditBenchObserver::resets = 0;
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		const XGParamMasterMap::Range range = master.range(0x30 + (i & 1));
+		const unsigned int last = range.first + range.count;
+		for (unsigned int j = range.first; j < last; ++j)
+			params.at(j)->reset();
+	}
+	const double t1 = qxgedit_bench_ns(timer, count);
+	const unsigned long n1 = qxgeditBenchObserver::resets / count;
+
+	// Full master map walk (reference)...
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		const unsigned short high = 0x30 + (i & 1);
+		XGParamMasterMap::const_iterator iter = master.constBegin();
+		for (; iter != master.constEnd(); ++iter) {
+			XGParam *param = iter.value();
+			if (param->high() == high)
+				param->reset();
+		}
+	}
+	const double t2 = qxgedit_bench_ns(timer, count);
+
+	const qxgeditBenchResult result = { "drum_reset", count, n1, t1, t2 };
+	qxgedit_bench_print(result);
+}
+
+
+//-------------------------------------------------------------------------
+// SysEx file corpus decoding timing (validating vs. unchecked decoder).
+
+// Split a .syx file image into messages, on F7 markers.
+static void qxgedit_bench_split ( QList<QByteArray>& corpus, const QByteArray& data )
+{
+	int i0 = 0;
+	const int n = data.size();
+	for (int i = 0; i < n; ++i) {
+		if ((unsigned char) data.at(i) == 0xf7) {
+			corpus.append(data.mid(i0, i + 1 - i0));
+			i0 = i + 1;
+		}
+	}
+}
+
+
+// Load a .syx file (or a directory full of them) into the corpus.
+static void qxgedit_bench_load ( QList<QByteArray>& corpus, const QString& sPath )
+{
+	const QFileInfo info(sPath);
+	if (info.isDir()) {
+		const QDir dir(sPath);
+		const QStringList& files
+			= dir.entryList(QStringList() << "*.syx" << "*.SYX", QDir::Files);
+		QStringListIterator iter(files);
+		while (iter.hasNext())
+			qxgedit_bench_load(corpus, dir.filePath(iter.next()));
+		return;
+	}
+
+	QFile file(sPath);
+	if (file.open(QIODevice::ReadOnly)) {
+		qxgedit_bench_split(corpus, file.readAll());
+		file.close();
+	}
+}
+
+
+// Former (unchecked) SysEx header decoder, for reference only;
+// trusts the declared byte count, hence valid messages only.
+static bool qxgedit_bench_unchecked (
+	const unsigned char *data, unsigned short len, unsigned long& sum )
+{
+	if (data[0] != 0xf0 || data[len - 1] != 0xf7)
+		return false;
+
+	if (data[1] != 0x43)
+		return false;
+
+	const unsigned char mode = (data[2] & 0x70);
+	if (data[3] == 0x4c || data[3] == 0x4b) {
+		if (mode == 0x00) {
+			const unsigned short size = (data[4] << 7) + data[5];
+			unsigned char cksum = 0;
+			for (unsigned short i = 0; i < size + 5; ++i) {
+				cksum += data[4 + i];
+				cksum &= 0x7f;
+			}
+			if (data[9 + size] == 0x80 - cksum) {
+				sum += data[6] + data[7] + data[8] + size;
+				return true;
+			}
+		}
+		else
+		if (mode == 0x10) {
+			sum += data[4] + data[5] + data[6] + (len - 7);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+static void qxgedit_bench_syx ( XGParamMasterMap& master,
+	const QList<QByteArray>& corpus, int count )
+{
+	QElapsedTimer timer;
+
+	// Keep only what the validating decoder accepts...
+	QList<QByteArray> valid;
+	unsigned long bytes = 0;
+	QListIterator<QByteArray> iter(corpus);
+	while (iter.hasNext()) {
+		const QByteArray& data = iter.next();
+		const XGSysexDecoder sysex(
+			(const unsigned char *) data.constData(), data.size());
+		if (sysex.is_valid()) {
+			valid.append(data);
+			bytes += data.size();
+		}
+	}
+
+	if (valid.isEmpty())
+		return;
+
+	const int nvalid = valid.count();
+	unsigned long sum = 0;
+
+	// Reference: unchecked header decoder...
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		for (int j = 0; j < nvalid; ++j) {
+			const QByteArray& data = valid.at(j);
+			qxgedit_bench_unchecked(
+				(const unsigned char *) data.constData(), data.size(), sum);
+		}
+	}
+	const double ref = qxgedit_bench_ns(timer, count);
+
+	// Validating single-pass decoder...
+	timer.start();
+	for (int i = 0; i < count; ++i) {
+		for (int j = 0; j < nvalid; ++j) {
+			const QByteArray& data = valid.at(j);
+			const XGSysexDecoder sysex(
+				(const unsigned char *) data.constData(), data.size());
+			sum += sysex.high() + sysex.mid() + sysex.low() + sysex.size();
+		}
+	}
+
+	const qxgeditBenchResult result1
+		= { "syx_decode", count, bytes, qxgedit_bench_ns(timer, count), ref };
+	qxgedit_bench_print(result1);
+
+	// Whole load (add_sysex_data + set_sysex_data), as from a session file...
+	const int nloads = count / 10 + 1;
+	timer.start();
+	for (int i = 0; i < nloads; ++i) {
+		XGParamMasterMap::SysexData sysex_data;
+		for (int j = 0; j < nvalid; ++j) {
+			QByteArray data = valid.at(j);
+			master.add_sysex_data(sysex_data,
+				(unsigned char *) data.data(), data.size());
+		}
+		master.set_sysex_data(sysex_data);
+	}
+
+	const qxgeditBenchResult result2
+		= { "syx_load", nloads, (unsigned long) nvalid,
+			qxgedit_bench_ns(timer, nloads), 0.0 };
+	qxgedit_bench_print(result2);
+
+	if (!g_bench_csv) {
+		::printf("%-12s %lu of %d message(s) valid, %.1f MB/s (checksum %lu)\n",
+			"syx_corpus", (unsigned long) nvalid, int(corpus.count()),
+			result1.ns > 0.0 ? 1000.0 * double(bytes) / result1.ns : 0.0,
+			sum & 0xffff);
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// main - The bench program trunk.
+//
+// Usage: qxgedit_bench [--csv] [--syx file|dir]... [count]
+//
+// Without --syx, the SysEx corpus is made of the current state full dump
+// (every parameter change and all user voice bulk dumps).
+
+int main ( int argc, char **argv )
+{
+	QCoreApplication app(argc, argv);
+
+	int count = 10000;
+	QList<QByteArray> corpus;
+	const QStringList& args = app.arguments();
+	for (int i = 1; i < args.count(); ++i) {
+		const QString& sArg = args.at(i);
+		if (sArg == "--csv")
+			g_bench_csv = true;
+		else
+		if (sArg == "--syx" && i + 1 < args.count())
+			qxgedit_bench_load(corpus, args.at(++i));
+		else
+			count = sArg.toInt();
+	}
+	if (count < 1)
+		count = 1;
+
+	qxgedit_bench_header();
+
+	qxgedit_bench_construct(count / 1000 + 1);
+
+	XGParamMasterMap master;
+
+	// One observer per parameter, as if all were on screen...
+	QList<qxgeditBenchObserver *> observers;
+	XGParamMasterMap::const_iterator iter = master.constBegin();
+	for (; iter != master.constEnd(); ++iter)
+		observers.append(new qxgeditBenchObserver(iter.value()));
+
+	qxgedit_bench_find(master, count * 10);
+	qxgedit_bench_encode(master, count * 10);
+	qxgedit_bench_decode(master, count / 1000 + 1);
+	qxgedit_bench_fanout(master, count * 10);
+	qxgedit_bench_nrpn(count * 10);
+
+	qxgedit_bench_map("MULTIPART", master.MULTIPART, qxgedit_bench_part, count);
+	qxgedit_bench_map("DRUMSETUP", master.DRUMSETUP, qxgedit_bench_note, count);
+	qxgedit_bench_map("USERVOICE", master.USERVOICE, qxgedit_bench_user, count);
+
+	qxgedit_bench_drums(master, count / 100 + 1);
+
+	if (corpus.isEmpty()) {
+		QListIterator<XGParam *> iter2(master.params());
+		while (iter2.hasNext()) {
+			XGParam *param = iter2.next();
+			if (param->size() > 4 || param->high() == 0x11)
+				continue;
+			XGParamSysex sysex(param);
+			corpus.append(QByteArray((const char *) sysex.data(), sysex.size()));
+		}
+		for (unsigned short id = 0; id < 32; ++id) {
+			XGUserVoiceSysex sysex(id, &master);
+			corpus.append(QByteArray((const char *) sysex.data(), sysex.size()));
+		}
+	}
+
+	qxgedit_bench_syx(master, corpus, count / 100 + 1);
+
+	qDeleteAll(observers);
+
+	return 0;
+}
+
+
+// end of qxgeditBench.cpp
@@ -0,0 +1,584 @@
+// qxgeditControl.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditControl.h"
+
+#include "qxgeditMainForm.h"
+#include "qxgeditOptions.h"
+
+#include <QLocalSocket>
+#include <QFileInfo>
+#include <QDir>
+#include <QMetaObject>
+
+
+// Protocol version.
+static const unsigned short c_iVersion = 1;
+
+// Maximum frame length (bytes).
+static const unsigned int c_iMaxFrame = (1 << 24);
+
+
+// Big-endian helpers.
+static inline unsigned int qxgedit_get_u32 ( const char *data )
+{
+	const unsigned char *p = (const unsigned char *) data;
+	return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline unsigned short qxgedit_get_u16 ( const char *data )
+{
+	const unsigned char *p = (const unsigned char *) data;
+	return (p[0] << 8) | p[1];
+}
+
+static inline void qxgedit_put_u32 ( QByteArray& data, unsigned int u )
+{
+	data.append(char((u >> 24) & 0xff));
+	data.append(char((u >> 16) & 0xff));
+	data.append(char((u >> 8) & 0xff));
+	data.append(char(u & 0xff));
+}
+
+static inline void qxgedit_put_u16 ( QByteArray& data, unsigned short u )
+{
+	data.append(char((u >> 8) & 0xff));
+	data.append(char(u & 0xff));
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditControl -- Local socket remote control session.
+
+// Parameter name registry.
+QHash<QString, QList<qxgeditControl::NameKey> > qxgeditControl::g_names;
+
+
+// Constructor.
+qxgeditControl::qxgeditControl ( QLocalSocket *pSocket )
+	: QObject(pSocket), m_pSocket(pSocket),
+		m_bSubscribed(false), m_bPosted(false)
+{
+	// Skip handshake magic...
+	m_pSocket->read(4);
+
+	QObject::connect(m_pSocket,
+		SIGNAL(readyRead()),
+		SLOT(readyReadSlot()));
+	QObject::connect(m_pSocket,
+		SIGNAL(disconnected()),
+		m_pSocket, SLOT(deleteLater()));
+
+	// Anything left already?
+	if (m_pSocket->bytesAvailable() > 0)
+		readyReadSlot();
+}
+
+
+// Destructor.
+qxgeditControl::~qxgeditControl (void)
+{
+	qxgeditXGMasterMap::remove_listener(this);
+}
+
+
+// Session handshake magic.
+const char *qxgeditControl::magic (void)
+{
+	return "XGC1";
+}
+
+
+// Change notification (listener callback).
+void qxgeditControl::param_changed (
+	qxgeditXGMasterMap *pMasterMap, XGParam *pParam )
+{
+	if (!m_bSubscribed || pMasterMap != qxgeditXGMasterMap::getInstance())
+		return;
+
+	const unsigned int addr
+		= (pParam->high() << 16) | (pParam->mid() << 8) | pParam->low();
+	if (m_changed.contains(addr))
+		return;
+
+	m_changed.insert(addr);
+	m_changes.append(addr);
+
+	// Coalesce till next event loop turn...
+	if (!m_bPosted) {
+		m_bPosted = true;
+		QMetaObject::invokeMethod(this, "flushChanges", Qt::QueuedConnection);
+	}
+}
+
+
+// Socket data-ready slot.
+void qxgeditControl::readyReadSlot (void)
+{
+	m_buffer.append(m_pSocket->readAll());
+
+	int iOffset = 0;
+	while (m_buffer.size() - iOffset >= 5) {
+		const unsigned int iLength = qxgedit_get_u32(m_buffer.constData() + iOffset);
+		if (iLength < 1 || iLength > c_iMaxFrame) {
+		#ifdef CONFIG_DEBUG
+			qDebug("qxgeditControl::readyReadSlot(): bad frame length (%u).", iLength);
+		#endif
+			m_buffer.clear();
+			m_pSocket->disconnectFromServer();
+			return;
+		}
+		if (m_buffer.size() - iOffset < int(4 + iLength))
+			break;
+		const unsigned char opcode = m_buffer.at(iOffset + 4);
+		process(opcode, m_buffer.mid(iOffset + 5, iLength - 1));
+		iOffset += 4 + iLength;
+	}
+
+	if (iOffset > 0)
+		m_buffer.remove(0, iOffset);
+
+	m_pSocket->flush();
+}
+
+
+// Send pending change notifications.
+void qxgeditControl::flushChanges (void)
+{
+	m_bPosted = false;
+
+	if (m_changes.isEmpty())
+		return;
+
+	QByteArray data;
+	QListIterator<unsigned int> iter(m_changes);
+	while (iter.hasNext()) {
+		const unsigned int addr = iter.next();
+		XGParam *pParam = findParam(
+			(addr >> 16) & 0xff, (addr >> 8) & 0xff, addr & 0xff);
+		if (pParam)
+			addParam(data, pParam);
+	}
+
+	m_changes.clear();
+	m_changed.clear();
+
+	if (!data.isEmpty() && m_bSubscribed) {
+		writeFrame(Changed, data);
+		m_pSocket->flush();
+	}
+}
+
+
+// Frame dispatcher.
+void qxgeditControl::process (
+	unsigned char opcode, const QByteArray& payload )
+{
+	QByteArray reply;
+	unsigned char status = BadRequest;
+
+	switch (opcode) {
+	case Hello:
+		qxgedit_put_u16(reply, c_iVersion);
+		status = Ok;
+		break;
+	case Get:
+		status = getParams(payload, reply);
+		break;
+	case Set:
+		status = setParams(payload, reply);
+		break;
+	case GetName:
+		status = getNames(payload, reply);
+		break;
+	case SetName:
+		status = setNames(payload, reply);
+		break;
+	case Load:
+		status = loadSession(payload);
+		break;
+	case Save:
+		status = saveSession(payload);
+		break;
+	case Subscribe:
+		status = subscribe(payload);
+		break;
+	default:
+		break;
+	}
+
+	reply.prepend(char(status));
+	writeFrame(opcode | Reply, reply);
+}
+
+
+// Get parameters by address.
+unsigned char qxgeditControl::getParams (
+	const QByteArray& payload, QByteArray& reply )
+{
+	if (payload.size() % 3)
+		return BadRequest;
+
+	unsigned char status = Ok;
+
+	const char *data = payload.constData();
+	const int iSize = payload.size();
+	for (int i = 0; i < iSize; i += 3) {
+		XGParam *pParam = findParam(
+			(unsigned char) data[i + 0],
+			(unsigned char) data[i + 1],
+			(unsigned char) data[i + 2]);
+		if (pParam) {
+			addParam(reply, pParam);
+		} else {
+			reply.append(data + i, 3);
+			qxgedit_put_u16(reply, 0xffff);
+			status = NotFound;
+		}
+	}
+
+	return status;
+}
+
+
+// Set parameters by address (one batched update).
+unsigned char qxgeditControl::setParams (
+	const QByteArray& payload, QByteArray& reply )
+{
+	if (payload.size() % 5)
+		return BadRequest;
+
+	qxgeditXGMasterMap *pMasterMap = qxgeditXGMasterMap::getInstance();
+	if (pMasterMap == nullptr)
+		return Failed;
+
+	unsigned char status = Ok;
+	unsigned short iCount = 0;
+
+	pMasterMap->begin_update();
+
+	const char *data = payload.constData();
+	const int iSize = payload.size();
+	for (int i = 0; i < iSize; i += 5) {
+		XGParam *pParam = findParam(
+			(unsigned char) data[i + 0],
+			(unsigned char) data[i + 1],
+			(unsigned char) data[i + 2]);
+		const unsigned short u = qxgedit_get_u16(data + i + 3);
+		if (pParam && pParam->size() <= 4
+			&& u >= pParam->min() && u <= pParam->max()) {
+			pParam->set_value(u);
+			++iCount;
+		}
+		else status = NotFound;
+	}
+
+	pMasterMap->end_update();
+
+	qxgedit_put_u16(reply, iCount);
+
+	return status;
+}
+
+
+// Get parameters by name.
+unsigned char qxgeditControl::getNames (
+	const QByteArray& payload, QByteArray& reply )
+{
+	unsigned char status = Ok;
+
+	const char *data = payload.constData();
+	const int iSize = payload.size();
+	int i = 0;
+	while (i < iSize) {
+		const int iLength = (unsigned char) data[i++];
+		if (i + iLength > iSize)
+			return BadRequest;
+		XGParam *pParam = findName(QString::fromUtf8(data + i, iLength));
+		i += iLength;
+		if (pParam) {
+			addParam(reply, pParam);
+		} else {
+			reply.append(3, char(0xff));
+			qxgedit_put_u16(reply, 0xffff);
+			status = NotFound;
+		}
+	}
+
+	return status;
+}
+
+
+// Set parameters by name (one batched update).
+unsigned char qxgeditControl::setNames (
+	const QByteArray& payload, QByteArray& reply )
+{
+	qxgeditXGMasterMap *pMasterMap = qxgeditXGMasterMap::getInstance();
+	if (pMasterMap == nullptr)
+		return Failed;
+
+	unsigned char status = Ok;
+	unsigned short iCount = 0;
+
+	pMasterMap->begin_update();
+
+	const char *data = payload.constData();
+	const int iSize = payload.size();
+	int i = 0;
+	while (i < iSize) {
+		const int iLength = (unsigned char) data[i++];
+		if (i + iLength + 2 > iSize) {
+			status = BadRequest;
+			break;
+		}
+		XGParam *pParam = findName(QString::fromUtf8(data + i, iLength));
+		i += iLength;
+		const unsigned short u = qxgedit_get_u16(data + i);
+		i += 2;
+		if (pParam && pParam->size() <= 4
+			&& u >= pParam->min() && u <= pParam->max()) {
+			pParam->set_value(u);
+			++iCount;
+		}
+		else status = NotFound;
+	}
+
+	pMasterMap->end_update();
+
+	qxgedit_put_u16(reply, iCount);
+
+	return status;
+}
+
+
+// Session file path resolver (empty if outside session directory).
+QString qxgeditControl::sessionPath ( const QByteArray& payload ) const
+{
+	qxgeditOptions *pOptions = qxgeditOptions::getInstance();
+	if (pOptions == nullptr)
+		return QString();
+
+	QString sSessionDir = pOptions->sSessionDir;
+	if (sSessionDir.isEmpty())
+		sSessionDir = QDir::homePath();
+
+	const QString& sRoot = QDir(sSessionDir).canonicalPath();
+	if (sRoot.isEmpty())
+		return QString();
+
+	const QFileInfo info(QDir::cleanPath(
+		QDir(sRoot).absoluteFilePath(QString::fromUtf8(payload))));
+
+	// Resolve symlinks: the existing file itself, or its parent...
+	QString sPath = info.canonicalFilePath();
+	if (sPath.isEmpty()) {
+		const QString& sDir = QFileInfo(info.absolutePath()).canonicalFilePath();
+		if (sDir.isEmpty())
+			return QString();
+		sPath = QDir(sDir).absoluteFilePath(info.fileName());
+	}
+
+	if (!sPath.startsWith(sRoot + '/'))
+		return QString();
+
+	return sPath;
+}
+
+
+// Load session file (current module).
+unsigned char qxgeditControl::loadSession ( const QByteArray& payload )
+{
+	qxgeditMainForm *pMainForm = qxgeditMainForm::getInstance();
+	if (pMainForm == nullptr || payload.isEmpty())
+		return BadRequest;
+
+	const QString& sFilename = sessionPath(payload);
+	if (sFilename.isEmpty())
+		return Denied;
+
+	return (pMainForm->loadSessionFile(sFilename) ? Ok : Failed);
+}
+
+
+// Save session file (current module).
+unsigned char qxgeditControl::saveSession ( const QByteArray& payload )
+{
+	qxgeditMainForm *pMainForm = qxgeditMainForm::getInstance();
+	if (pMainForm == nullptr || payload.isEmpty())
+		return BadRequest;
+
+	const QString& sFilename = sessionPath(payload);
+	if (sFilename.isEmpty())
+		return Denied;
+
+	return (pMainForm->saveSessionFile(sFilename) ? Ok : Failed);
+}
+
+
+// Change subscription on/off.
+unsigned char qxgeditControl::subscribe ( const QByteArray& payload )
+{
+	if (payload.size() != 1)
+		return BadRequest;
+
+	m_bSubscribed = (payload.at(0) != 0);
+
+	if (m_bSubscribed) {
+		qxgeditXGMasterMap::add_listener(this);
+	} else {
+		qxgeditXGMasterMap::remove_listener(this);
+		m_changes.clear();
+		m_changed.clear();
+	}
+
+	return Ok;
+}
+
+
+// Frame writer.
+void qxgeditControl::writeFrame (
+	unsigned char opcode, const QByteArray& payload )
+{
+	QByteArray frame;
+	frame.reserve(5 + payload.size());
+	qxgedit_put_u32(frame, 1 + payload.size());
+	frame.append(char(opcode));
+	frame.append(payload);
+
+	m_pSocket->write(frame);
+}
+
+
+// Parameter finders (current module).
+XGParam *qxgeditControl::findParam ( unsigned short high,
+	unsigned short mid, unsigned short low ) const
+{
+	qxgeditXGMasterMap *pMasterMap = qxgeditXGMasterMap::getInstance();
+	if (pMasterMap == nullptr)
+		return nullptr;
+
+	return pMasterMap->find_param(high, mid, low);
+}
+
+
+XGParam *qxgeditControl::findName ( const QString& sName ) const
+{
+	if (g_names.isEmpty())
+		buildNames();
+
+	const QList<NameKey>& keys = g_names.value(sName);
+	QListIterator<NameKey> iter(keys);
+	while (iter.hasNext()) {
+		const NameKey& key = iter.next();
+		XGParam *pParam = findParam(key.high, key.mid, key.low);
+		if (pParam == nullptr)
+			continue;
+		// Effect parameters must be of the current effect type...
+		if (key.etype && static_cast<XGEffectParam *> (pParam)->etype() != key.etype)
+			continue;
+		return pParam;
+	}
+
+	return nullptr;
+}
+
+
+// Parameter name registry.
+void qxgeditControl::buildNames (void)
+{
+	XGParamMasterMap *pMasterMap = XGParamMasterMap::getInstance();
+	if (pMasterMap == nullptr)
+		return;
+
+	XGParamMasterMap::const_iterator iter = pMasterMap->constBegin();
+	for (; iter != pMasterMap->constEnd(); ++iter) {
+		XGParam *pParam = iter.value();
+		const QString& sName = paramName(pParam);
+		if (sName.isEmpty())
+			continue;
+		NameKey key;
+		key.high  = pParam->high();
+		key.mid   = pParam->mid();
+		key.low   = pParam->low();
+		key.etype = 0;
+		if (key.high == 0x02 && key.mid == 0x01
+			&& key.low != 0x00 && key.low != 0x20 && key.low != 0x40)
+			key.etype = static_cast<XGEffectParam *> (pParam)->etype();
+		g_names[sName].append(key);
+	}
+}
+
+
+// Parameter name (eg. "MULTIPART/1/Volume", "DRUMSETUP/1/36/Level").
+QString qxgeditControl::paramName ( XGParam *pParam )
+{
+	const QString& sLabel = pParam->label().simplified();
+	if (sLabel.isEmpty())
+		return QString();
+
+	const unsigned short high = pParam->high();
+	const unsigned short mid  = pParam->mid();
+	const unsigned short low  = pParam->low();
+
+	if (high == 0x00)
+		return QString("SYSTEM/%1").arg(sLabel);
+	else
+	if (high == 0x02 && mid == 0x01) {
+		if (low < 0x20)
+			return QString("REVERB/%1").arg(sLabel);
+		else
+		if (low < 0x40)
+			return QString("CHORUS/%1").arg(sLabel);
+		else
+			return QString("VARIATION/%1").arg(sLabel);
+	}
+	else
+	if (high == 0x08)
+		return QString("MULTIPART/%1/%2").arg(mid + 1).arg(sLabel);
+	else
+	if (high == 0x30 || high == 0x31)
+		return QString("DRUMSETUP/%1/%2/%3").arg(high - 0x2f).arg(mid).arg(sLabel);
+	else
+	if (high == 0x11) {
+		// Element parameters (element 2 offset by 0x50)...
+		if (low >= 0x3d)
+			return QString("USERVOICE/%1/%2/%3")
+				.arg(mid + 1).arg(low < 0x3d + 0x50 ? 1 : 2).arg(sLabel);
+		return QString("USERVOICE/%1/%2").arg(mid + 1).arg(sLabel);
+	}
+
+	return QString();
+}
+
+
+// Address/value encoders.
+void qxgeditControl::addParam ( QByteArray& data, XGParam *pParam )
+{
+	data.append(char(pParam->high()));
+	data.append(char(pParam->mid()));
+	data.append(char(pParam->low()));
+
+	qxgedit_put_u16(data, pParam->value());
+}
+
+
+// end of qxgeditControl.cpp
@@ -0,0 +1,172 @@
+// qxgeditControl.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditControl_h
+#define __qxgeditControl_h
+
+#include "qxgeditXGMasterMap.h"
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+
+// Forward decls.
+class QLocalSocket;
+
+
+//----------------------------------------------------------------------------
+// qxgeditControl -- Local socket remote control session.
+//
+// A client opens the running instance local socket and writes the
+// 4 byte magic "XGC1"; from then on, every frame is a big-endian
+// 32 bit length, followed by an opcode byte and its payload:
+//
+//   Get       addr*                    -> status, (addr value)*
+//   Set       (addr value)*            -> status, count
+//   GetName   (name)*                  -> status, (addr value)*
+//   SetName   (name value)*            -> status, count
+//   Load      path                     -> status
+//   Save      path                     -> status
+//   Subscribe on                       -> status
+//
+// where addr is 3 bytes (high, mid, low), value is 16 bit, name is
+// a length byte plus UTF-8 text (eg. "MULTIPART/1/Volume") and path
+// is the remaining UTF-8 text, relative to the session directory
+// (anything resolving outside of it is Denied). Replies carry the opcode OR'ed 0x80
+// and a status byte; subscribers also get asynchronous Changed frames,
+// (addr value)*, coalesced per event loop turn. All changes in one
+// Set or SetName frame are applied in one batched update, always on
+// the current module.
+
+class qxgeditControl : public QObject, public qxgeditXGMasterMap::Listener
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditControl(QLocalSocket *pSocket);
+
+	// Destructor.
+	~qxgeditControl();
+
+	// Session handshake magic.
+	static const char *magic();
+
+	// Request opcodes.
+	enum Opcode {
+		Hello     = 0x00,
+		Get       = 0x01,
+		Set       = 0x02,
+		GetName   = 0x03,
+		SetName   = 0x04,
+		Load      = 0x05,
+		Save      = 0x06,
+		Subscribe = 0x07,
+		Reply     = 0x80,
+		Changed   = 0xc0
+	};
+
+	// Reply status codes.
+	enum Status {
+		Ok         = 0,
+		NotFound   = 1,
+		BadRequest = 2,
+		Failed     = 3,
+		Denied     = 4
+	};
+
+	// Change notification (listener callback).
+	void param_changed(qxgeditXGMasterMap *pMasterMap, XGParam *pParam);
+
+protected slots:
+
+	// Socket data-ready slot.
+	void readyReadSlot();
+
+	// Send pending change notifications.
+	void flushChanges();
+
+protected:
+
+	// Frame dispatcher.
+	void process(unsigned char opcode, const QByteArray& payload);
+
+	// Request handlers.
+	unsigned char getParams(const QByteArray& payload, QByteArray& reply);
+	unsigned char setParams(const QByteArray& payload, QByteArray& reply);
+	unsigned char getNames(const QByteArray& payload, QByteArray& reply);
+	unsigned char setNames(const QByteArray& payload, QByteArray& reply);
+	unsigned char loadSession(const QByteArray& payload);
+	unsigned char saveSession(const QByteArray& payload);
+	unsigned char subscribe(const QByteArray& payload);
+
+	// Session file path resolver (empty if outside session directory).
+	QString sessionPath(const QByteArray& payload) const;
+
+	// Frame writer.
+	void writeFrame(unsigned char opcode, const QByteArray& payload);
+
+	// Parameter finders (current module).
+	XGParam *findParam(unsigned short high,
+		unsigned short mid, unsigned short low) const;
+	XGParam *findName(const QString& sName) const;
+
+	// Parameter name registry.
+	static void buildNames();
+	static QString paramName(XGParam *pParam);
+
+	// Address/value encoders.
+	static void addParam(QByteArray& data, XGParam *pParam);
+
+private:
+
+	// Instance variables.
+	QLocalSocket *m_pSocket;
+
+	QByteArray m_buffer;
+
+	// Change subscription.
+	bool m_bSubscribed;
+	bool m_bPosted;
+
+	QList<unsigned int> m_changes;
+	QSet<unsigned int> m_changed;
+
+	// Parameter name registry (shared, address and effect type;
+	// effect parameter names may well map to several of these).
+	struct NameKey
+	{
+		unsigned short high, mid, low, etype;
+	};
+
+	static QHash<QString, QList<NameKey> > g_names;
+};
+
+
+#endif	// __qxgeditControl_h
+
+
+// end of qxgeditControl.h
@@ -1,7 +1,7 @@
 // qxgeditDial.cpp
 //
 /****************************************************************************
-   Copyright (C) 2005-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License
@@ -22,80 +22,77 @@
 #include "qxgeditAbout.h"
 #include "qxgeditDial.h"
 
-#include "qxgeditKnob.h"
 #include "qxgeditSpin.h"
 #include "qxgeditDrop.h"
 
 #include "XGParam.h"
 
-#include <QVBoxLayout>
-#include <QLabel>
+#include <QStyleOptionSlider>
+#include <QStyle>
+#include <QPainter>
+
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QFocusEvent>
+
+#include <cmath>
+
+
+// Knob stepping (as the former QDial based knob used to have it).
+static const int c_iKnobSingleStep = 7;
+static const int c_iKnobPageStep   = 10;
+
+// Knob notch target (pixels, QDial's default).
+static const double c_fKnobNotchTarget = 3.7;
 
 
 //-------------------------------------------------------------------------
-// qxgeditDial - Custom composite widget.
+// qxgeditDial - Custom parameter strip widget.
 //
 
 // Constructor.
 qxgeditDial::qxgeditDial ( QWidget *pParent )
-	: XGParamWidget<QWidget> (pParent)
+	: XGParamWidget<QWidget> (pParent), m_pParam(nullptr),
+		m_pSpin(nullptr), m_pDrop(nullptr), m_bKnobPressed(false), m_iBusy(0)
 {
-	m_pLabel = new QLabel();
-	m_pKnob  = new qxgeditKnob();
-	m_pSpin  = new qxgeditSpin();
-	m_pDrop  = new qxgeditDrop();
-
-	m_iBusy = 0;
-
-	m_pLabel->setAlignment(Qt::AlignCenter);
-	m_pKnob->setSingleStep(7);
-	m_pKnob->setNotchesVisible(true);
-	m_pSpin->setAlignment(Qt::AlignCenter);
-
-	int iMaximumHeight = QFontMetrics(QWidget::font()).lineSpacing() + 2;
-	m_pSpin->setMaximumHeight(iMaximumHeight);
-	m_pDrop->setMaximumHeight(iMaximumHeight);
-
-	QVBoxLayout *pVBoxLayout = new QVBoxLayout();
-	pVBoxLayout->setContentsMargins(0, 0, 0, 0);
-	pVBoxLayout->setSpacing(0);
-	pVBoxLayout->addWidget(m_pLabel);
-	pVBoxLayout->addWidget(m_pKnob);
-	pVBoxLayout->addWidget(m_pSpin);
-	pVBoxLayout->addWidget(m_pDrop);
-	QWidget::setLayout(pVBoxLayout);
+	QWidget::setFocusPolicy(Qt::WheelFocus);
 
 	setMaximumSize(QSize(56, 76));
-
-	QObject::connect(m_pKnob,
-		SIGNAL(valueChanged(int)),
-		SLOT(knobValueChanged(int)));
-	QObject::connect(m_pSpin,
-		SIGNAL(valueChanged(unsigned short)),
-		SLOT(spinValueChanged(unsigned short)));
-	QObject::connect(m_pDrop,
-		SIGNAL(valueChanged(unsigned short)),
-		SLOT(dropValueChanged(unsigned short)));
-
-//	m_pDrop->hide();
 }
 
 
 // Destructor.
 qxgeditDial::~qxgeditDial (void)
 {
+	closeEditor();
 }
 
 
 // Special value text accessor.
 void qxgeditDial::setSpecialValueText ( const QString& sText )
 {
-	m_pSpin->setSpecialValueText(sText);
+	m_sSpecialValueText = sText;
+
+	QWidget::update();
 }
 	
 QString qxgeditDial::specialValueText (void) const
 {
-	return m_pSpin->specialValueText();
+	return m_sSpecialValueText;
+}
+
+
+// Size hints.
+QSize qxgeditDial::sizeHint (void) const
+{
+	return QSize(56, 76);
+}
+
+QSize qxgeditDial::minimumSizeHint (void) const
+{
+	const int iLineSpacing = QWidget::fontMetrics().lineSpacing();
+	return QSize(40, iLineSpacing + iLineSpacing + 2 + 30);
 }
 
 
@@ -117,35 +114,35 @@ void qxgeditDial::set_value_update ( unsigned short iValue )
 
 void qxgeditDial::set_value ( unsigned short iValue, Observer *pSender )
 {
-	if (m_iBusy > 0)
+	if (m_iBusy > 0 || m_pParam == nullptr)
 		return;
 
 	++m_iBusy;
 
-	if (m_pSpin->param()) {
+	if (iValue < m_pParam->min())
+		iValue = m_pParam->min();
+	if (iValue > m_pParam->max() && m_pParam->max() > m_pParam->min())
+		iValue = m_pParam->max();
+
+	m_pParam->set_value(iValue, pSender);
+
+	// Keep the inline editor in sync, if any...
+	if (m_pSpin)
 		m_pSpin->setValue(iValue, pSender);
-		m_pKnob->setValue(int(m_pSpin->value()));
-		emit valueChanged(m_pSpin->value());
-	}
 	else
-	if (m_pDrop->param()) {
+	if (m_pDrop)
 		m_pDrop->setValue(iValue, pSender);
-		m_pKnob->setValue(int(m_pDrop->value()));
-		emit valueChanged(m_pDrop->value());
-	}
+
+	QWidget::update();
+
+	emit valueChanged(m_pParam->value());
 
 	--m_iBusy;
 }
 
 unsigned short qxgeditDial::value (void) const
 {
-	if (m_pSpin->param())
-		return m_pSpin->value();
-	else
-	if (m_pDrop->param())
-		return m_pDrop->value();
-
-	return 0;
+	return (m_pParam ? m_pParam->value() : 0);
 }
 
 
@@ -157,47 +154,31 @@ void qxgeditDial::set_param ( XGParam *pParam, Observer *pSender )
 
 	++m_iBusy;
 
+	closeEditor();
+
 	if (pParam && pParam->name()) {
+		m_pParam = pParam;
+		m_sLabel = pParam->label();
 		QWidget::setEnabled(true);
-		m_pLabel->setText(pParam->label());
-		m_pKnob->setMinimum(int(pParam->min()));
-		m_pKnob->setMaximum(int(pParam->max()));
-		m_pKnob->setDefaultValue(int(pParam->def()));
-		m_pKnob->setValue(int(pParam->value()));
-		if (pParam->gets(pParam->min())) {
-			m_pSpin->setParam(nullptr);
-			m_pSpin->hide();
-			m_pDrop->setParam(pParam, pSender);
-			m_pDrop->show();
-		} else {
-			m_pSpin->setParam(pParam, pSender);
-			m_pSpin->show();
-			m_pDrop->setParam(nullptr);
-			m_pDrop->hide();
-		}
 		QWidget::setToolTip(pParam->text());
-		emit valueChanged(pParam->value());
 	} else {
+		m_pParam = nullptr;
+		m_sLabel.clear();
 		QWidget::setEnabled(false);
-		m_pLabel->clear();
-		m_pSpin->setParam(nullptr);
-		m_pSpin->show();
-		m_pDrop->setParam(nullptr);
-		m_pDrop->hide();
 	}
 
+	QWidget::update();
+
 	--m_iBusy;
+
+	// Settle (and announce) the current value...
+	if (m_pParam)
+		set_value(m_pParam->value(), pSender);
 }
 
 XGParam *qxgeditDial::param (void) const
 {
-	if (m_pSpin->param())
-		return m_pSpin->param();
-	else
-	if (m_pDrop->param())
-		return m_pDrop->param();
-	else
-		return nullptr;
+	return m_pParam;
 }
 
 
@@ -208,20 +189,405 @@ void qxgeditDial::setValue ( unsigned short iValue )
 }
 
 
-// Internal widget slots.
-void qxgeditDial::knobValueChanged ( int iKnobValue )
+// Inline editor slots.
+void qxgeditDial::editorValueChanged ( unsigned short iValue )
+{
+	setValue(iValue);
+}
+
+void qxgeditDial::editorFinished (void)
+{
+	QWidget *pEditor = nullptr;
+	if (m_pSpin)
+		pEditor = m_pSpin;
+	else
+	if (m_pDrop)
+		pEditor = m_pDrop;
+
+	if (pEditor == nullptr || QObject::sender() != pEditor)
+		return;
+
+	const bool bFocus = pEditor->hasFocus();
+
+	closeEditor();
+
+	if (bFocus)
+		QWidget::setFocus();
+}
+
+
+// Geometry helpers.
+QRect qxgeditDial::labelRect (void) const
+{
+	const int iLineSpacing = QWidget::fontMetrics().lineSpacing();
+	return QRect(0, 0, QWidget::width(), iLineSpacing);
+}
+
+QRect qxgeditDial::knobRect (void) const
+{
+	const int iLineSpacing = QWidget::fontMetrics().lineSpacing();
+	const int y0 = iLineSpacing;
+	const int y1 = QWidget::height() - (iLineSpacing + 2);
+	const int w  = QWidget::width();
+	const int d  = qMax(0, qMin(w, y1 - y0));
+	return QRect((w - d) >> 1, y0 + ((y1 - y0 - d) >> 1), d, d);
+}
+
+QRect qxgeditDial::valueRect (void) const
+{
+	const int h = QWidget::fontMetrics().lineSpacing() + 2;
+	return QRect(0, QWidget::height() - h, QWidget::width(), h);
+}
+
+
+// Knob style option (as QDial would have it).
+void qxgeditDial::initKnobOption ( QStyleOptionSlider *pOption ) const
+{
+	const int iMinimum = (m_pParam ? int(m_pParam->min()) : 0);
+	const int iMaximum = (m_pParam ? qMax(int(m_pParam->max()), iMinimum) : 0);
+
+	pOption->initFrom(this);
+	pOption->rect = knobRect();
+	pOption->minimum = iMinimum;
+	pOption->maximum = iMaximum;
+	pOption->sliderPosition = int(value());
+	pOption->sliderValue = int(value());
+	pOption->singleStep = c_iKnobSingleStep;
+	pOption->pageStep = c_iKnobPageStep;
+	pOption->upsideDown = true;
+	pOption->notchTarget = c_fKnobNotchTarget;
+	pOption->dialWrapping = false;
+	pOption->subControls = QStyle::SC_All;
+	pOption->activeSubControls = QStyle::SC_None;
+	pOption->tickPosition = QSlider::NoTicks;
+
+	// Notch size (a non-zero multiple of the single step)...
+	const int r = (pOption->rect.width() >> 1);
+	int l = int(r * 5 * M_PI / 6);
+	if (iMaximum > iMinimum + c_iKnobPageStep)
+		l = int(0.5 + l * c_iKnobPageStep / (iMaximum - iMinimum));
+	l = l * c_iKnobSingleStep / c_iKnobPageStep;
+	if (l < 1)
+		l = 1;
+	l = int(0.5 + c_fKnobNotchTarget / l);
+	if (l < 1)
+		l = 1;
+	pOption->tickInterval = c_iKnobSingleStep * l;
+}
+
+
+// Knob value from mouse position (as QDial would have it).
+int qxgeditDial::knobValueFromPoint ( const QPoint& pos ) const
+{
+	if (m_pParam == nullptr)
+		return 0;
+
+	const QRect& rect = knobRect();
+	const double yy = rect.y() + 0.5 * rect.height() - pos.y();
+	const double xx = pos.x() - rect.x() - 0.5 * rect.width();
+	double a = (xx != 0.0 || yy != 0.0 ? ::atan2(yy, xx) : 0.0);
+	if (a < M_PI / -2)
+		a += M_PI * 2;
+
+	const int iMinimum = int(m_pParam->min());
+	const int iMaximum = qMax(int(m_pParam->max()), iMinimum);
+	const int iValue = int(0.5 + iMinimum
+		+ (iMaximum - iMinimum) * (M_PI * 4 / 3 - a) / (M_PI * 10 / 6));
+
+	return qBound(iMinimum, iValue, iMaximum);
+}
+
+
+// Relative value stepping.
+void qxgeditDial::stepValue ( int iSteps )
+{
+	if (m_pParam == nullptr)
+		return;
+
+	const int iMinimum = int(m_pParam->min());
+	const int iMaximum = qMax(int(m_pParam->max()), iMinimum);
+
+	setValue(qBound(iMinimum, int(value()) + iSteps, iMaximum));
+}
+
+
+// Value box display text.
+QString qxgeditDial::valueText (void) const
+{
+	if (m_pParam == nullptr)
+		return QString();
+
+	const unsigned short iValue = m_pParam->value();
+
+	if (m_pParam->gets(m_pParam->min())) {
+		const char *pszItem = m_pParam->gets(iValue);
+		return (pszItem ? QString(pszItem) : QString::number(iValue));
+	}
+
+	if (!m_sSpecialValueText.isEmpty() && iValue == m_pParam->min())
+		return m_sSpecialValueText;
+
+	float fValue = m_pParam->getv(iValue);
+	if (fValue >= 1000.0f) {
+		fValue /= 1000.0f;
+		return QString::number(fValue) + 'k';
+	} else {
+		return QString::number(fValue);
+	}
+}
+
+
+// Widget painter.
+void qxgeditDial::paintEvent ( QPaintEvent */*pPaintEvent*/ )
 {
-	setValue(iKnobValue);
+	QPainter painter(this);
+
+	const QPalette& pal = QWidget::palette();
+	const QFontMetrics& fm = QWidget::fontMetrics();
+
+	// Label...
+	const QRect& rectLabel = labelRect();
+	painter.setPen(pal.windowText().color());
+	painter.drawText(rectLabel, Qt::AlignCenter,
+		fm.elidedText(m_sLabel, Qt::ElideRight, rectLabel.width()));
+
+	// Knob...
+	QStyleOptionSlider opt;
+	initKnobOption(&opt);
+	QWidget::style()->drawComplexControl(QStyle::CC_Dial, &opt, &painter, this);
+
+	// Value box (unless being edited)...
+	if (m_pSpin || m_pDrop)
+		return;
+
+	const QRect& rectValue = valueRect();
+	QColor rgbBase = pal.base().color();
+	if (QWidget::isEnabled() && m_pParam
+		&& m_pParam->value() != m_pParam->def()) {
+		rgbBase = (pal.window().color().value() < 0x7f
+			? QColor(Qt::darkYellow).darker()
+			: QColor(Qt::yellow).lighter());
+	}
+	painter.fillRect(rectValue, rgbBase);
+	painter.setPen(pal.mid().color());
+	painter.drawRect(rectValue.adjusted(0, 0, -1, -1));
+
+	QRect rectText = rectValue.adjusted(2, 0, -2, 0);
+	if (m_pParam && m_pParam->gets(m_pParam->min())) {
+		// Drop-down list indicator...
+		const int h = rectValue.height();
+		QStyleOption optArrow;
+		optArrow.initFrom(this);
+		optArrow.rect = QRect(rectValue.right() - h + 2, rectValue.top() + 2, h - 4, h - 4);
+		QWidget::style()->drawPrimitive(
+			QStyle::PE_IndicatorArrowDown, &optArrow, &painter, this);
+		rectText.setRight(optArrow.rect.left() - 1);
+	}
+
+	painter.setPen(pal.text().color());
+	painter.drawText(rectText, Qt::AlignCenter,
+		fm.elidedText(valueText(), Qt::ElideRight, rectText.width()));
 }
 
-void qxgeditDial::spinValueChanged ( unsigned short iSpinValue )
+
+// Mouse interaction.
+void qxgeditDial::mousePressEvent ( QMouseEvent *pMouseEvent )
 {
-	setValue(iSpinValue);
+	if (m_pParam == nullptr) {
+		XGParamWidget<QWidget>::mousePressEvent(pMouseEvent);
+		return;
+	}
+
+	const QPoint& pos = pMouseEvent->pos();
+
+	if (pMouseEvent->button() == Qt::MiddleButton) {
+		// Reset to default value...
+		setValue(m_pParam->def());
+	}
+	else
+	if (pMouseEvent->button() == Qt::LeftButton) {
+		if (valueRect().contains(pos)) {
+			openEditor();
+		} else {
+			m_bKnobPressed = true;
+			setValue(knobValueFromPoint(pos));
+		}
+	}
+	else XGParamWidget<QWidget>::mousePressEvent(pMouseEvent);
 }
 
-void qxgeditDial::dropValueChanged ( unsigned short iDropValue )
+
+void qxgeditDial::mouseMoveEvent ( QMouseEvent *pMouseEvent )
 {
-	setValue(iDropValue);
+	if (m_bKnobPressed && m_pParam)
+		setValue(knobValueFromPoint(pMouseEvent->pos()));
+	else
+		XGParamWidget<QWidget>::mouseMoveEvent(pMouseEvent);
+}
+
+
+void qxgeditDial::mouseReleaseEvent ( QMouseEvent *pMouseEvent )
+{
+	m_bKnobPressed = false;
+
+	XGParamWidget<QWidget>::mouseReleaseEvent(pMouseEvent);
+}
+
+
+void qxgeditDial::wheelEvent ( QWheelEvent *pWheelEvent )
+{
+	const int iDelta = pWheelEvent->angleDelta().y();
+	if (m_pParam == nullptr || iDelta == 0) {
+		XGParamWidget<QWidget>::wheelEvent(pWheelEvent);
+		return;
+	}
+
+	int iSteps = (iDelta * c_iKnobPageStep) / 120;
+	if (iSteps == 0)
+		iSteps = (iDelta > 0 ? +1 : -1);
+
+	stepValue(iSteps);
+
+	pWheelEvent->accept();
+}
+
+
+// Keyboard interaction.
+void qxgeditDial::keyPressEvent ( QKeyEvent *pKeyEvent )
+{
+	if (m_pParam == nullptr) {
+		XGParamWidget<QWidget>::keyPressEvent(pKeyEvent);
+		return;
+	}
+
+	switch (pKeyEvent->key()) {
+	case Qt::Key_Up:
+	case Qt::Key_Right:
+		stepValue(+1);
+		break;
+	case Qt::Key_Down:
+	case Qt::Key_Left:
+		stepValue(-1);
+		break;
+	case Qt::Key_PageUp:
+		stepValue(+c_iKnobPageStep);
+		break;
+	case Qt::Key_PageDown:
+		stepValue(-c_iKnobPageStep);
+		break;
+	case Qt::Key_Home:
+		setValue(m_pParam->min());
+		break;
+	case Qt::Key_End:
+		setValue(m_pParam->max());
+		break;
+	case Qt::Key_Return:
+	case Qt::Key_Enter:
+	case Qt::Key_F2:
+		openEditor();
+		break;
+	default:
+		XGParamWidget<QWidget>::keyPressEvent(pKeyEvent);
+		break;
+	}
+}
+
+
+// Inline editor key/focus watcher.
+bool qxgeditDial::eventFilter ( QObject *pObject, QEvent *pEvent )
+{
+	if (pObject == m_pSpin || pObject == m_pDrop) {
+		if (pEvent->type() == QEvent::KeyPress) {
+			QKeyEvent *pKeyEvent = static_cast<QKeyEvent *> (pEvent);
+			if (pKeyEvent->key() == Qt::Key_Escape) {
+				closeEditor();
+				QWidget::setFocus();
+				return true;
+			}
+		}
+		else
+		if (pEvent->type() == QEvent::FocusOut && pObject == m_pDrop) {
+			// The spin-box gets done on editingFinished() already...
+			QFocusEvent *pFocusEvent = static_cast<QFocusEvent *> (pEvent);
+			if (pFocusEvent->reason() != Qt::PopupFocusReason)
+				closeEditor();
+		}
+	}
+
+	return XGParamWidget<QWidget>::eventFilter(pObject, pEvent);
+}
+
+
+// Inline editor lifecycle.
+void qxgeditDial::openEditor (void)
+{
+	if (m_pParam == nullptr || m_pSpin || m_pDrop)
+		return;
+
+	const QRect& rect = valueRect();
+
+	if (m_pParam->gets(m_pParam->min())) {
+		m_pDrop = new qxgeditDrop(this);
+		m_pDrop->setGeometry(rect);
+		m_pDrop->setParam(m_pParam, observer());
+		m_pDrop->installEventFilter(this);
+		QObject::connect(m_pDrop,
+			SIGNAL(valueChanged(unsigned short)),
+			SLOT(editorValueChanged(unsigned short)));
+		// Let activated() get through first...
+		QObject::connect(m_pDrop,
+			SIGNAL(popupHidden()),
+			SLOT(editorFinished()),
+			Qt::QueuedConnection);
+		m_pDrop->show();
+		m_pDrop->setFocus();
+		m_pDrop->showPopup();
+	} else {
+		m_pSpin = new qxgeditSpin(this);
+		m_pSpin->setAlignment(Qt::AlignCenter);
+		m_pSpin->setSpecialValueText(m_sSpecialValueText);
+		m_pSpin->setGeometry(rect);
+		m_pSpin->setParam(m_pParam, observer());
+		m_pSpin->installEventFilter(this);
+		QObject::connect(m_pSpin,
+			SIGNAL(valueChanged(unsigned short)),
+			SLOT(editorValueChanged(unsigned short)));
+		QObject::connect(m_pSpin,
+			SIGNAL(editingFinished()),
+			SLOT(editorFinished()));
+		m_pSpin->show();
+		m_pSpin->setFocus();
+		m_pSpin->selectAll();
+	}
+
+	QWidget::update();
+}
+
+
+void qxgeditDial::closeEditor (void)
+{
+	// Detach first, as hiding may well trigger editingFinished()...
+	if (m_pSpin) {
+		qxgeditSpin *pSpin = m_pSpin;
+		m_pSpin = nullptr;
+		QObject::disconnect(pSpin, nullptr, this, nullptr);
+		pSpin->removeEventFilter(this);
+		pSpin->setParam(nullptr);
+		pSpin->hide();
+		pSpin->deleteLater();
+	}
+
+	if (m_pDrop) {
+		qxgeditDrop *pDrop = m_pDrop;
+		m_pDrop = nullptr;
+		QObject::disconnect(pDrop, nullptr, this, nullptr);
+		pDrop->removeEventFilter(this);
+		pDrop->setParam(nullptr);
+		pDrop->hide();
+		pDrop->deleteLater();
+	}
+
+	QWidget::update();
 }
 
 
@@ -1,7 +1,7 @@
 // qxgeditDial.h
 //
 /****************************************************************************
-   Copyright (C) 2005-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License
@@ -27,14 +27,18 @@
 #include <QWidget>
 
 // Forward declarations.
-class QLabel;
-class qxgeditKnob;
 class qxgeditSpin;
 class qxgeditDrop;
 
+class QStyleOptionSlider;
+
 
 //-------------------------------------------------------------------------
-// qxgeditDial - Custom composite widget.
+// qxgeditDial - Custom parameter strip widget.
+//
+// One single widget that paints its own label, knob and value box;
+// an inline spin-box or drop-down list editor gets created over the
+// value box only while editing, and is gone when editing is over.
 
 class qxgeditDial : public XGParamWidget<QWidget>
 {
@@ -61,6 +65,10 @@ public:
 	void setSpecialValueText(const QString& sText);
 	QString specialValueText() const;
 
+	// Size hints.
+	QSize sizeHint() const;
+	QSize minimumSizeHint() const;
+
 signals:
 
 	// Value change signal.
@@ -73,19 +81,62 @@ public slots:
 
 protected slots:
 
-	// Internal widget slots.
-	void knobValueChanged(int);
-	void spinValueChanged(unsigned short);
-	void dropValueChanged(unsigned short);
+	// Inline editor slots.
+	void editorValueChanged(unsigned short);
+	void editorFinished();
+
+protected:
+
+	// Widget painter.
+	void paintEvent(QPaintEvent *pPaintEvent);
+
+	// Mouse interaction.
+	void mousePressEvent(QMouseEvent *pMouseEvent);
+	void mouseMoveEvent(QMouseEvent *pMouseEvent);
+	void mouseReleaseEvent(QMouseEvent *pMouseEvent);
+	void wheelEvent(QWheelEvent *pWheelEvent);
+
+	// Keyboard interaction.
+	void keyPressEvent(QKeyEvent *pKeyEvent);
+
+	// Inline editor key/focus watcher.
+	bool eventFilter(QObject *pObject, QEvent *pEvent);
+
+	// Geometry helpers.
+	QRect labelRect() const;
+	QRect knobRect() const;
+	QRect valueRect() const;
+
+	// Knob style option (as QDial would have it).
+	void initKnobOption(QStyleOptionSlider *pOption) const;
+
+	// Knob value from mouse position (as QDial would have it).
+	int knobValueFromPoint(const QPoint& pos) const;
+
+	// Relative value stepping.
+	void stepValue(int iSteps);
+
+	// Value box display text.
+	QString valueText() const;
+
+	// Inline editor lifecycle.
+	void openEditor();
+	void closeEditor();
 
 private:
 
-	// Widget members.
-	QLabel      *m_pLabel;
-	qxgeditKnob *m_pKnob;
+	// Parameter and attributes.
+	XGParam *m_pParam;
+	QString  m_sLabel;
+	QString  m_sSpecialValueText;
+
+	// Inline editor (only while editing).
 	qxgeditSpin *m_pSpin;
 	qxgeditDrop *m_pDrop;
 
+	// Knob dragging state.
+	bool m_bKnobPressed;
+
 	// Fake-mutex.
 	int m_iBusy;
 };
@@ -1,7 +1,7 @@
 // qxgeditDrop.cpp
 //
 /****************************************************************************
-   Copyright (C) 2005-2019, rncbc aka Rui Nuno Capela. All rights reserved.
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License
@@ -111,6 +111,15 @@ XGParam *qxgeditDrop::param (void) const
 }
 
 
+// Popup list override (notifying).
+void qxgeditDrop::hidePopup (void)
+{
+	QComboBox::hidePopup();
+
+	emit popupHidden();
+}
+
+
 // Internal widget slots.
 void qxgeditDrop::comboActivated ( int iCombo )
 {
@@ -1,7 +1,7 @@
 // qxgeditDrop.h
 //
 /****************************************************************************
-   Copyright (C) 2005-2019, rncbc aka Rui Nuno Capela. All rights reserved.
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License
@@ -51,11 +51,17 @@ public:
 	void setValue(unsigned short iValue, XGParamObserver *pSender = nullptr);
 	unsigned short value() const;
 
+	// Popup list override (notifying).
+	void hidePopup();
+
 signals:
 
 	// Value change signal.
 	void valueChanged(unsigned short);
 
+	// Popup list closed (whether an item got activated or not).
+	void popupHidden();
+
 protected slots:
 
 	// Internal widget slots.
@@ -22,6 +22,8 @@
 #include "qxgeditAbout.h"
 #include "qxgeditDrumEg.h"
 
+#include "qxgeditTrace.h"
+
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
@@ -99,6 +101,8 @@ unsigned short qxgeditDrumEg::decay2 (void) const
 // Draw curve.
 void qxgeditDrumEg::paintEvent ( QPaintEvent *pPaintEvent )
 {
+	QXGEDIT_TRACE("qxgeditDrumEg::paintEvent");
+
 	QPainter painter(this);
 
 	const int h  = height();
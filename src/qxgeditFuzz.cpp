@@ -0,0 +1,156 @@
+// qxgeditFuzz.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "XGParam.h"
+#include "XGParamSysex.h"
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+
+//-------------------------------------------------------------------------
+// qxgedit_fuzz_check - Decoder invariants (abort on violation).
+
+static void qxgedit_fuzz_check (
+	const unsigned char *data, unsigned int len )
+{
+	const XGSysexDecoder sysex(data, len);
+	if (!sysex.is_valid())
+		return;
+
+	// Data block must lie within the message, framing excluded...
+	if (sysex.data() < data + 7
+		|| sysex.data() + sysex.size() > data + len - 1)
+		::abort();
+
+	// Nothing but 7bit data bytes...
+	for (unsigned short i = 0; i < sysex.size(); ++i) {
+		if (sysex.data()[i] & 0x80)
+			::abort();
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// LLVMFuzzerTestOneInput - The fuzzing entry point (libFuzzer style).
+//
+// The input is taken both as one single message and as a whole .syx
+// file, split on F7 markers just like qxgeditMainForm::loadSessionFile,
+// all fed through the master map SysEx data decoder and setter.
+
+extern "C" int LLVMFuzzerTestOneInput ( const uint8_t *data, size_t size )
+{
+	static XGParamMasterMap master;
+
+	if (size > 0x100000)
+		return 0;
+
+	qxgedit_fuzz_check(data, (unsigned int) size);
+
+	// Mutable copy, as the master map decoder wants it...
+	QByteArray buff((const char *) data, int(size));
+	unsigned char *pBuff = (unsigned char *) buff.data();
+
+	XGParamMasterMap::SysexData sysex_data;
+
+	unsigned int i0 = 0;
+	for (unsigned int i = 0; i < (unsigned int) size; ++i) {
+		if (pBuff[i] != 0xf7)
+			continue;
+		const unsigned int len = i + 1 - i0;
+		if (len <= 0xffff) {
+			qxgedit_fuzz_check(pBuff + i0, len);
+			master.add_sysex_data(sysex_data, pBuff + i0, len);
+		}
+		i0 = i + 1;
+	}
+
+	master.set_sysex_data(sysex_data);
+
+	return 0;
+}
+
+
+#ifdef CONFIG_FUZZ_MAIN
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+//-------------------------------------------------------------------------
+// qxgedit_fuzz_file - Corpus file replay.
+
+static bool qxgedit_fuzz_file ( const QString& sFilename )
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	const QByteArray data = file.readAll();
+	file.close();
+
+	LLVMFuzzerTestOneInput(
+		(const uint8_t *) data.constData(), size_t(data.size()));
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// main - Corpus replay trunk (when not linked with libFuzzer).
+//
+// Usage: qxgedit_fuzz <file|directory>...
+
+int main ( int argc, char **argv )
+{
+	int nfiles = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		const QString sPath = QString::fromLocal8Bit(argv[i]);
+		const QFileInfo info(sPath);
+		if (info.isDir()) {
+			const QDir dir(sPath);
+			const QStringList& files = dir.entryList(QDir::Files);
+			QStringListIterator iter(files);
+			while (iter.hasNext()) {
+				if (qxgedit_fuzz_file(dir.filePath(iter.next())))
+					++nfiles;
+			}
+		}
+		else
+		if (qxgedit_fuzz_file(sPath))
+			++nfiles;
+	}
+
+	::printf("qxgedit_fuzz: %d input(s) replayed.\n", nfiles);
+
+	return 0;
+}
+
+#endif	// CONFIG_FUZZ_MAIN
+
+
+// end of qxgeditFuzz.cpp
@@ -0,0 +1,458 @@
+// qxgeditLatency.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditLatency.h"
+
+#include "qxgeditOptions.h"
+#include "qxgeditMainForm.h"
+#include "qxgeditXGMasterMap.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+// Common monotonic clock.
+static QElapsedTimer g_latency_clock;
+
+// Give up waiting this long after the last message sent (ns).
+static const qint64 c_iLatencyTimeout = 5000000000LL;
+
+// Unthrottled output path commits per event loop turn.
+static const int c_iLatencyBatch = 64;
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyRun -- One measured run (path, offered rate, timestamps).
+
+qxgeditLatencyRun::qxgeditLatencyRun ( bool bOut, int iRate, int iCount )
+	: bOut(bOut), iRate(iRate), iCount(iCount), v0(0), v1(0),
+		t0(iCount), t1(iCount), n0(0), n1(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyTap -- Output port stand-in (output thread side).
+
+void qxgeditLatencyTap::midiOut ( const unsigned char *, unsigned int )
+{
+	qxgeditLatencyRun *pRun = m_pRun.load();
+	if (pRun == nullptr || !pRun->bOut)
+		return;
+
+	const int i = pRun->n1.fetch_add(1);
+	if (i < pRun->iCount)
+		pRun->t1[i] = qxgeditLatency::now();
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyProbe -- Last parameter observer (stands for a widget).
+
+void qxgeditLatencyProbe::update (void)
+{
+	if (m_pRun == nullptr || m_pRun->bOut)
+		return;
+
+	const int i = m_pRun->n1.fetch_add(1);
+	if (i < m_pRun->iCount)
+		m_pRun->t1[i] = qxgeditLatency::now();
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyDriver -- Input port stand-in (paced injector thread).
+
+// Constructor.
+qxgeditLatencyDriver::qxgeditLatencyDriver ( qxgeditMidiDevice *pMidiDevice,
+	XGParam *pParam, qxgeditLatencyRun *pRun )
+	: QThread(), m_pMidiDevice(pMidiDevice), m_pParam(pParam), m_pRun(pRun)
+{
+}
+
+
+// The main thread executive.
+void qxgeditLatencyDriver::run (void)
+{
+	// XG Parameter Change template...
+	QByteArray sysex(9, char(0));
+	sysex[0] = char(0xf0);
+	sysex[1] = char(0x43);
+	sysex[2] = char(0x10);
+	sysex[3] = char(0x4c);
+	sysex[4] = char(m_pParam->high());
+	sysex[5] = char(m_pParam->mid());
+	sysex[6] = char(m_pParam->low());
+	sysex[8] = char(0xf7);
+
+	const qint64 t0 = qxgeditLatency::now();
+	for (int i = 0; i < m_pRun->iCount; ++i) {
+		// Pace to the offered rate, if any...
+		if (m_pRun->iRate > 0) {
+			const qint64 due = t0 + (qint64(i) * 1000000000LL) / m_pRun->iRate;
+			for (;;) {
+				const qint64 remain = due - qxgeditLatency::now();
+				if (remain <= 0)
+					break;
+				if (remain > 2000000)
+					QThread::usleep((remain - 1000000) / 1000);
+				else
+					QThread::yieldCurrentThread();
+			}
+		}
+		sysex[7] = char((i & 1) ? m_pRun->v1 : m_pRun->v0);
+		m_pRun->t0[i] = qxgeditLatency::now();
+		m_pRun->n0.store(i + 1);
+		m_pMidiDevice->injectMidi(sysex);
+	}
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatency -- End-to-end MIDI latency harness.
+
+// Constructor.
+qxgeditLatency::qxgeditLatency ( qxgeditMidiDevice *pMidiDevice,
+	XGParam *pParam, int iRate, int iCount, bool bCsv )
+	: QObject(nullptr), m_pMidiDevice(pMidiDevice), m_pParam(pParam),
+		m_bCsv(bCsv), m_pRun(nullptr), m_iRun(-1), m_pDriver(nullptr),
+		m_t0(0), m_tEnd(0), m_iIncomplete(0)
+{
+	// Each path, at the offered rate then unthrottled...
+	if (iRate > 0)
+		m_runs.append(new qxgeditLatencyRun(false, iRate, iCount));
+	m_runs.append(new qxgeditLatencyRun(false, 0, iCount));
+	if (iRate > 0)
+		m_runs.append(new qxgeditLatencyRun(true, iRate, iCount));
+	m_runs.append(new qxgeditLatencyRun(true, 0, iCount));
+
+	// Attached last, so notified after all widgets...
+	m_pProbe = new qxgeditLatencyProbe(m_pParam);
+
+	m_pMidiDevice->setTap(&m_tap);
+
+	m_pCommitTimer = new QTimer(this);
+	m_pCommitTimer->setInterval(0);
+	m_pPollTimer = new QTimer(this);
+	m_pPollTimer->setInterval(10);
+
+	QObject::connect(m_pCommitTimer,
+		SIGNAL(timeout()),
+		SLOT(commitSlot()));
+	QObject::connect(m_pPollTimer,
+		SIGNAL(timeout()),
+		SLOT(pollSlot()));
+
+	g_latency_clock.start();
+}
+
+
+// Destructor.
+qxgeditLatency::~qxgeditLatency (void)
+{
+	if (m_pDriver) {
+		m_pDriver->wait();
+		delete m_pDriver;
+	}
+
+	m_pMidiDevice->setTap(nullptr);
+
+	delete m_pProbe;
+
+	qDeleteAll(m_runs);
+	m_runs.clear();
+}
+
+
+// Monotonic clock (ns).
+qint64 qxgeditLatency::now (void)
+{
+	return g_latency_clock.nsecsElapsed();
+}
+
+
+// Whether all runs went through.
+bool qxgeditLatency::isComplete (void) const
+{
+	return (m_iRun >= m_runs.count() && m_iIncomplete == 0);
+}
+
+
+// Start measuring.
+void qxgeditLatency::start (void)
+{
+	if (m_bCsv) {
+		::printf("path,rate,count,done,msg_per_sec,"
+			"p50_us,p90_us,p99_us,p999_us,max_us\n");
+	} else {
+		::printf("%-4s %8s %8s %8s %10s %10s %10s %10s %10s %10s\n",
+			"path", "rate", "count", "done", "msg/s",
+			"p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+	}
+
+	m_iRun = -1;
+	m_iIncomplete = 0;
+
+	nextRun();
+}
+
+
+// Run sequencer.
+void qxgeditLatency::nextRun (void)
+{
+	if (++m_iRun >= m_runs.count()) {
+		m_pRun = nullptr;
+		QCoreApplication::quit();
+		return;
+	}
+
+	m_pRun = m_runs.at(m_iRun);
+
+	// Alternate against the current value, so that
+	// every single message makes for an actual change...
+	const unsigned short v = m_pParam->value();
+	m_pRun->v0 = (v ^ 1) & 0x7f;
+	m_pRun->v1 = v;
+
+	m_t0 = now();
+	m_tEnd = 0;
+
+	if (m_pRun->bOut) {
+		m_tap.setRun(m_pRun);
+		m_pCommitTimer->start();
+	} else {
+		m_pProbe->setRun(m_pRun);
+		m_pDriver = new qxgeditLatencyDriver(m_pMidiDevice, m_pParam, m_pRun);
+		m_pDriver->start(QThread::TimeCriticalPriority);
+		m_pPollTimer->start();
+	}
+}
+
+
+void qxgeditLatency::finishRun (void)
+{
+	m_pPollTimer->stop();
+
+	if (m_pDriver) {
+		m_pDriver->wait();
+		delete m_pDriver;
+		m_pDriver = nullptr;
+	}
+
+	m_tap.setRun(nullptr);
+	m_pProbe->setRun(nullptr);
+
+	if (m_pRun->n1.load() < m_pRun->iCount)
+		++m_iIncomplete;
+
+	report(m_pRun);
+
+	nextRun();
+}
+
+
+// Output path committer (main thread, as if from a knob).
+void qxgeditLatency::commitSlot (void)
+{
+	if (m_pRun == nullptr)
+		return;
+
+	for (int k = 0; m_pRun->iRate > 0 || k < c_iLatencyBatch; ++k) {
+		const int i = m_pRun->n0.load();
+		if (i >= m_pRun->iCount) {
+			m_pCommitTimer->stop();
+			m_tEnd = now();
+			m_pPollTimer->start();
+			return;
+		}
+		if (m_pRun->iRate > 0) {
+			const qint64 due = m_t0 + (qint64(i) * 1000000000LL) / m_pRun->iRate;
+			if (now() < due)
+				return;
+		}
+		m_pRun->t0[i] = now();
+		m_pRun->n0.store(i + 1);
+		m_pParam->set_value((i & 1) ? m_pRun->v1 : m_pRun->v0);
+	}
+}
+
+
+// Run completion poller.
+void qxgeditLatency::pollSlot (void)
+{
+	if (m_pRun == nullptr)
+		return;
+
+	if (m_pDriver && !m_pDriver->isFinished())
+		return;
+
+	if (m_tEnd == 0)
+		m_tEnd = now();
+
+	if (m_pRun->n1.load() >= m_pRun->iCount
+		|| now() - m_tEnd > c_iLatencyTimeout)
+		finishRun();
+}
+
+
+// Report a finished run.
+void qxgeditLatency::report ( qxgeditLatencyRun *pRun )
+{
+	const int n = qMin(pRun->iCount, qMin(pRun->n0.load(), pRun->n1.load()));
+
+	QVector<qint64> lat(n);
+	for (int i = 0; i < n; ++i)
+		lat[i] = pRun->t1.at(i) - pRun->t0.at(i);
+	std::sort(lat.begin(), lat.end());
+
+	double pct[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+	const double ps[4] = { 0.50, 0.90, 0.99, 0.999 };
+	if (n > 0) {
+		for (int k = 0; k < 4; ++k) {
+			int i = int(std::ceil(ps[k] * n)) - 1;
+			if (i < 0)
+				i = 0;
+			pct[k] = double(lat.at(i)) / 1000.0;
+		}
+		pct[4] = double(lat.at(n - 1)) / 1000.0;
+	}
+
+	double thru = 0.0;
+	if (n > 1) {
+		const qint64 dt = pRun->t1.at(n - 1) - pRun->t0.at(0);
+		if (dt > 0)
+			thru = double(n) * 1e9 / double(dt);
+	}
+
+	const char *path = (pRun->bOut ? "out" : "in");
+	if (m_bCsv) {
+		::printf("%s,%d,%d,%d,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+			path, pRun->iRate, pRun->iCount, n, thru,
+			pct[0], pct[1], pct[2], pct[3], pct[4]);
+	} else {
+		char rate[16];
+		if (pRun->iRate > 0)
+			::snprintf(rate, sizeof(rate), "%d", pRun->iRate);
+		else
+			::snprintf(rate, sizeof(rate), "max");
+		::printf("%-4s %8s %8d %8d %10.0f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+			path, rate, pRun->iCount, n, thru,
+			pct[0], pct[1], pct[2], pct[3], pct[4]);
+	}
+
+	::fflush(stdout);
+}
+
+
+//-------------------------------------------------------------------------
+// main - The latency harness trunk.
+//
+// Usage: qxgedit_latency [--rate msg/s] [--count n] [--direct] [--csv]
+//
+// Runs the complete application model and main form on the offscreen
+// platform, with an in-process stand-in for the MIDI ports: incoming
+// XG Parameter Change messages are injected from a paced thread and
+// timed until the last observer of the target parameter is notified
+// (in path); outgoing ones are committed from the main thread, as if
+// from a knob, and timed until written by the output thread (out path).
+// With --direct, incoming messages are committed from the input thread
+// and picked up through the coalesced notification instead.
+
+int main ( int argc, char **argv )
+{
+	Q_INIT_RESOURCE(qxgedit);
+
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+
+	int iRate  = 1000;
+	int iCount = 2000;
+	bool bCsv  = false;
+	bool bDirect = false;
+
+	const QStringList& args = app.arguments();
+	for (int i = 1; i < args.count(); ++i) {
+		const QString& sArg = args.at(i);
+		if (sArg == "--csv")
+			bCsv = true;
+		else
+		if (sArg == "--direct")
+			bDirect = true;
+		else
+		if (sArg == "--rate" && i + 1 < args.count())
+			iRate = args.at(++i).toInt();
+		else
+		if (sArg == "--count" && i + 1 < args.count())
+			iCount = args.at(++i).toInt();
+	}
+	if (iRate < 0)
+		iRate = 0;
+	if (iCount < 1)
+		iCount = 1;
+
+	// Keep away from the user settings...
+	QTemporaryDir tmpdir;
+	QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, tmpdir.path());
+	QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, tmpdir.path());
+
+	qxgeditOptions options;
+	options.bMidiDirect = bDirect;
+
+	qxgeditMainForm w;
+	w.setup(&options);
+	w.show();
+
+	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
+	qxgeditXGMasterMap *pMasterMap = qxgeditXGMasterMap::getInstance();
+	if (pMidiDevice == nullptr || pMasterMap == nullptr) {
+		::fprintf(stderr, "qxgedit_latency: no MIDI device or master map.\n");
+		return 1;
+	}
+
+	// Target: MULTIPART Part 1 Volume.
+	XGParam *pParam = pMasterMap->find_param(0x08, 0x00, 0x0b);
+	if (pParam == nullptr) {
+		::fprintf(stderr, "qxgedit_latency: no target parameter.\n");
+		return 1;
+	}
+
+	qxgeditLatency latency(pMidiDevice, pParam, iRate, iCount, bCsv);
+
+	// Let the main form settle first...
+	QTimer::singleShot(500, &latency, SLOT(start()));
+
+	app.exec();
+
+	return (latency.isComplete() ? 0 : 2);
+}
+
+
+// end of qxgeditLatency.cpp
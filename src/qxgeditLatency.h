@@ -0,0 +1,211 @@
+// qxgeditLatency.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditLatency_h
+#define __qxgeditLatency_h
+
+#include "qxgeditMidiDevice.h"
+
+#include "XGParamObserver.h"
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QList>
+
+#include <atomic>
+
+
+// Forward decls.
+class XGParam;
+
+class QTimer;
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyRun -- One measured run (path, offered rate, timestamps).
+
+struct qxgeditLatencyRun
+{
+	// Constructor.
+	qxgeditLatencyRun(bool bOut, int iRate, int iCount);
+
+	bool bOut;                      // Path: false=in, true=out.
+	int  iRate;                     // Offered rate (msg/s, 0=unthrottled).
+	int  iCount;                    // Messages to go.
+
+	unsigned short v0, v1;          // Alternating values.
+
+	QVector<qint64> t0;             // Injected/committed (ns).
+	QVector<qint64> t1;             // Notified/written (ns).
+
+	std::atomic<int> n0;            // Injected/committed so far.
+	std::atomic<int> n1;            // Notified/written so far.
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyTap -- Output port stand-in (output thread side).
+
+class qxgeditLatencyTap : public qxgeditMidiDevice::Tap
+{
+public:
+
+	// Constructor.
+	qxgeditLatencyTap() : m_pRun(nullptr) {}
+
+	// Current run accessor.
+	void setRun(qxgeditLatencyRun *pRun) { m_pRun.store(pRun); }
+
+	// Tap callbacks.
+	void midiIn(const unsigned char *, unsigned int) {}
+	void midiOut(const unsigned char *pMidi, unsigned int iMidi);
+
+private:
+
+	std::atomic<qxgeditLatencyRun *> m_pRun;
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyProbe -- Last parameter observer (stands for a widget).
+
+class qxgeditLatencyProbe : public XGParamObserver
+{
+public:
+
+	// Constructor.
+	qxgeditLatencyProbe(XGParam *pParam)
+		: XGParamObserver(pParam), m_pRun(nullptr) {}
+
+	// Current run accessor.
+	void setRun(qxgeditLatencyRun *pRun) { m_pRun = pRun; }
+
+protected:
+
+	// Observer callbacks.
+	void reset() {}
+	void update();
+
+private:
+
+	qxgeditLatencyRun *m_pRun;
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatencyDriver -- Input port stand-in (paced injector thread).
+
+class qxgeditLatencyDriver : public QThread
+{
+public:
+
+	// Constructor.
+	qxgeditLatencyDriver(qxgeditMidiDevice *pMidiDevice,
+		XGParam *pParam, qxgeditLatencyRun *pRun);
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	qxgeditMidiDevice *m_pMidiDevice;
+	XGParam *m_pParam;
+	qxgeditLatencyRun *m_pRun;
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditLatency -- End-to-end MIDI latency harness.
+
+class qxgeditLatency : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditLatency(qxgeditMidiDevice *pMidiDevice, XGParam *pParam,
+		int iRate, int iCount, bool bCsv);
+
+	// Destructor.
+	~qxgeditLatency();
+
+	// Monotonic clock (ns).
+	static qint64 now();
+
+	// Whether all runs went through.
+	bool isComplete() const;
+
+public slots:
+
+	// Start measuring.
+	void start();
+
+protected slots:
+
+	// Output path committer (main thread).
+	void commitSlot();
+
+	// Run completion poller.
+	void pollSlot();
+
+protected:
+
+	// Run sequencer.
+	void nextRun();
+	void finishRun();
+
+	// Report a finished run.
+	void report(qxgeditLatencyRun *pRun);
+
+private:
+
+	// Instance variables.
+	qxgeditMidiDevice *m_pMidiDevice;
+	XGParam *m_pParam;
+
+	bool m_bCsv;
+
+	QList<qxgeditLatencyRun *> m_runs;
+	qxgeditLatencyRun *m_pRun;
+	int m_iRun;
+
+	qxgeditLatencyTap m_tap;
+	qxgeditLatencyProbe *m_pProbe;
+	qxgeditLatencyDriver *m_pDriver;
+
+	QTimer *m_pCommitTimer;
+	QTimer *m_pPollTimer;
+
+	qint64 m_t0;
+	qint64 m_tEnd;
+
+	int m_iIncomplete;
+};
+
+
+#endif	// __qxgeditLatency_h
+
+
+// end of qxgeditLatency.h
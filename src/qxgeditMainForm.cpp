@@ -26,14 +26,23 @@
 
 #include "qxgeditXGMasterMap.h"
 #include "qxgeditMidiDevice.h"
+#include "qxgeditXGModule.h"
+#include "qxgeditXGFetch.h"
+#include "qxgeditMidiLearn.h"
 
 #include "XGParamSysex.h"
 
+#include "qxgeditSmfFile.h"
+
 #include "qxgeditDial.h"
 #include "qxgeditCombo.h"
 
 #include "qxgeditOptionsForm.h"
 #include "qxgeditPaletteForm.h"
+#include "qxgeditMidiMonitorForm.h"
+
+#include "qxgeditStartup.h"
+#include "qxgeditAlloc.h"
 
 #include <QApplication>
 #include <QMessageBox>
@@ -41,6 +50,11 @@
 #include <QFileInfo>
 #include <QUrl>
 
+#include <QProgressDialog>
+
+#include <QMenu>
+#include <QContextMenuEvent>
+
 #include <QTreeWidget>
 #include <QHeaderView>
 
@@ -55,6 +69,8 @@
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <QMimeData>
+
+#include <QPixmapCache>
 #endif
 
 
@@ -112,11 +128,21 @@ qxgeditMainForm::qxgeditMainForm ( QWidget *pParent )
 	// Pseudo-singleton reference setup.
 	g_pMainForm = this;
 
+	// Parameter widgets context menu (MIDI Learn).
+	XGParamWidgetMenu::setInstance(this);
+
 	// Initialize some pointer references.
 	m_pOptions = nullptr;
 	m_pMidiDevice = nullptr;
 	m_pMasterMap = nullptr;
 
+	m_pFetch = nullptr;
+
+	// MIDI traffic monitor (tool window).
+	m_pMidiMonitorForm = new qxgeditMidiMonitorForm(this, Qt::Window);
+
+	m_iCurrentModule = -1;
+
 	// We'll start clean.
 	m_iUntitled   = 0;
 	m_iDirtyCount = 0;
@@ -221,6 +247,18 @@ qxgeditMainForm::qxgeditMainForm ( QWidget *pParent )
 	QObject::connect(m_ui.fileSaveAsAction,
 		SIGNAL(triggered(bool)),
 		SLOT(fileSaveAs()));
+	QObject::connect(m_ui.fileLoadSnapshotAction,
+		SIGNAL(triggered(bool)),
+		SLOT(fileLoadSnapshot()));
+	QObject::connect(m_ui.fileSaveSnapshotAction,
+		SIGNAL(triggered(bool)),
+		SLOT(fileSaveSnapshot()));
+	QObject::connect(m_ui.fileExportAction,
+		SIGNAL(triggered(bool)),
+		SLOT(fileExport()));
+	QObject::connect(m_ui.fileFetchAction,
+		SIGNAL(triggered(bool)),
+		SLOT(fileFetch()));
 	QObject::connect(m_ui.fileExitAction,
 		SIGNAL(triggered(bool)),
 		SLOT(fileExit()));
@@ -237,13 +275,26 @@ qxgeditMainForm::qxgeditMainForm ( QWidget *pParent )
 	QObject::connect(m_ui.viewRandomizeAction,
 		SIGNAL(triggered(bool)),
 		SLOT(viewRandomize()));
+	QObject::connect(m_ui.viewMidiMonitorAction,
+		SIGNAL(triggered(bool)),
+		SLOT(viewMidiMonitor(bool)));
 	QObject::connect(m_ui.viewOptionsAction,
 		SIGNAL(triggered(bool)),
 		SLOT(viewOptions()));
 
+	QObject::connect(m_ui.moduleNewAction,
+		SIGNAL(triggered(bool)),
+		SLOT(moduleNew()));
+	QObject::connect(m_ui.moduleRemoveAction,
+		SIGNAL(triggered(bool)),
+		SLOT(moduleRemove()));
+
 	QObject::connect(m_ui.helpAboutAction,
 		SIGNAL(triggered(bool)),
 		SLOT(helpAbout()));
+	QObject::connect(m_ui.helpAllocReportAction,
+		SIGNAL(triggered(bool)),
+		SLOT(helpAllocReport()));
 	QObject::connect(m_ui.helpAboutQtAction,
 		SIGNAL(triggered(bool)),
 		SLOT(helpAboutQt()));
@@ -258,6 +309,10 @@ qxgeditMainForm::qxgeditMainForm ( QWidget *pParent )
 	QObject::connect(m_ui.SystemEffectToolBox,
 		SIGNAL(currentChanged(int)),
 		SLOT(stabilizeForm()));
+
+	QObject::connect(m_pMidiMonitorForm,
+		SIGNAL(visibilityChanged(bool)),
+		SLOT(midiMonitorVisibilityChanged(bool)));
 }
 
 
@@ -271,11 +326,19 @@ qxgeditMainForm::~qxgeditMainForm (void)
 		delete m_pSigtermNotifier;
 #endif
 
-	// Free designated devices.
-	if (m_pMidiDevice)
-		delete m_pMidiDevice;
-	if (m_pMasterMap)
-		delete m_pMasterMap;
+	// Stop monitoring before devices are gone.
+	m_pMidiMonitorForm->setMidiDevice(nullptr, nullptr);
+
+	// Free designated devices (all modules).
+	qxgeditXGModule::setInstance(nullptr);
+	qDeleteAll(m_modules);
+	m_modules.clear();
+
+	m_pMidiDevice = nullptr;
+	m_pMasterMap = nullptr;
+
+	// Parameter widgets context menu shut-down.
+	XGParamWidgetMenu::setInstance(nullptr);
 
 	// Pseudo-singleton reference shut-down.
 	g_pMainForm = nullptr;
@@ -311,26 +374,23 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 	// Primary startup stabilization...
 	updateRecentFilesMenu();
 
-	// XG master database...
-	m_pMasterMap = new qxgeditXGMasterMap();
-	m_pMasterMap->set_auto_send(m_pOptions->bUservoiceAutoSend);
+	qxgeditStartup::mark("main form");
 
-	// Start proper devices...
-	m_pMidiDevice = new qxgeditMidiDevice(QXGEDIT_TITLE);
+	// XG modules (master database and devices);
+	// the first one always keeps the legacy bindings...
+	addModule(m_pOptions->midiInputs, m_pOptions->midiOutputs);
+	const int iModules = m_pOptions->moduleInputs.count();
+	for (int i = 0; i < iModules; ++i) {
+		addModule(m_pOptions->moduleInputs.at(i),
+			m_pOptions->moduleOutputs.value(i));
+	}
 
-	QObject::connect(m_pMidiDevice,
-		SIGNAL(receiveSysex(const QByteArray&)),
-		SLOT(sysexReceived(const QByteArray&)));
-	QObject::connect(m_pMidiDevice,
-		SIGNAL(receiveRpn(unsigned char, unsigned short, unsigned short)),
-		SLOT(rpnReceived(unsigned char, unsigned short, unsigned short)));
-	QObject::connect(m_pMidiDevice,
-		SIGNAL(receiveNrpn(unsigned char, unsigned short, unsigned short)),
-		SLOT(nrpnReceived(unsigned char, unsigned short, unsigned short)));
+	// Start with the first one...
+	selectModule(0);
+	updateModuleMenu();
 
-	// And respective connections...
-	m_pMidiDevice->connectInputs(m_pOptions->midiInputs);
-	m_pMidiDevice->connectOutputs(m_pOptions->midiOutputs);
+	// MIDI monitor window, as last left...
+	m_pOptions->loadWidgetGeometry(m_pMidiMonitorForm);
 
 	// Change to last known session dir...
 	if (!m_pOptions->sSessionDir.isEmpty())
@@ -341,112 +401,26 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 	const QFont& font = pCentralWidget->font();
 	pCentralWidget->setFont(QFont(font.family(), font.pointSize() - 2));
 
-	XGParamMap *SYSTEM    = &(m_pMasterMap->SYSTEM);
-	XGParamMap *REVERB    = &(m_pMasterMap->REVERB);
-	XGParamMap *CHORUS    = &(m_pMasterMap->CHORUS);
-	XGParamMap *VARIATION = &(m_pMasterMap->VARIATION);
-	XGParamMap *MULTIPART = &(m_pMasterMap->MULTIPART);
-	XGParamMap *DRUMSETUP = &(m_pMasterMap->DRUMSETUP);
-	XGParamMap *USERVOICE = &(m_pMasterMap->USERVOICE);
-
 	// SYSTEM...
 	QObject::connect(m_ui.MasterResetButton,
 		SIGNAL(clicked()),
 		SLOT(masterResetButtonClicked()));
 
-	// SYSTEM widget mapping...
-	m_ui.MasterTuneDial            -> set_param_map(SYSTEM, 0x00);
-	m_ui.MasterVolumeDial          -> set_param_map(SYSTEM, 0x04);
-	m_ui.MasterTransposeDial       -> set_param_map(SYSTEM, 0x06);
-
 	// REVERB...
 	QObject::connect(m_ui.ReverbResetButton,
 		SIGNAL(clicked()),
 		SLOT(reverbResetButtonClicked()));
 
-	// REVERB widget mapping...
-	m_ui.ReverbTypeCombo           -> set_param_map(REVERB, 0x00);
-	m_ui.ReverbParam1Dial          -> set_param_map(REVERB, 0x02);
-	m_ui.ReverbParam2Dial          -> set_param_map(REVERB, 0x03);
-	m_ui.ReverbParam3Dial          -> set_param_map(REVERB, 0x04);
-	m_ui.ReverbParam4Dial          -> set_param_map(REVERB, 0x05);
-	m_ui.ReverbParam5Dial          -> set_param_map(REVERB, 0x06);
-	m_ui.ReverbParam6Dial          -> set_param_map(REVERB, 0x07);
-	m_ui.ReverbParam7Dial          -> set_param_map(REVERB, 0x08);
-	m_ui.ReverbParam8Dial          -> set_param_map(REVERB, 0x09);
-	m_ui.ReverbParam9Dial          -> set_param_map(REVERB, 0x0a);
-	m_ui.ReverbParam10Dial         -> set_param_map(REVERB, 0x0b);
-	m_ui.ReverbReturnDial          -> set_param_map(REVERB, 0x0c);
-	m_ui.ReverbPanDial             -> set_param_map(REVERB, 0x0d);
-	m_ui.ReverbParam11Dial         -> set_param_map(REVERB, 0x10);
-	m_ui.ReverbParam12Dial         -> set_param_map(REVERB, 0x11);
-	m_ui.ReverbParam13Dial         -> set_param_map(REVERB, 0x12);
-	m_ui.ReverbParam14Dial         -> set_param_map(REVERB, 0x13);
-	m_ui.ReverbParam15Dial         -> set_param_map(REVERB, 0x14);
-	m_ui.ReverbParam16Dial         -> set_param_map(REVERB, 0x15);
-
 	// CHORUS...
 	QObject::connect(m_ui.ChorusResetButton,
 		SIGNAL(clicked()),
 		SLOT(chorusResetButtonClicked()));
 
-	// CHORUS widget mapping...
-	m_ui.ChorusTypeCombo           -> set_param_map(CHORUS, 0x20);
-	m_ui.ChorusParam1Dial          -> set_param_map(CHORUS, 0x22);
-	m_ui.ChorusParam2Dial          -> set_param_map(CHORUS, 0x23);
-	m_ui.ChorusParam3Dial          -> set_param_map(CHORUS, 0x24);
-	m_ui.ChorusParam4Dial          -> set_param_map(CHORUS, 0x25);
-	m_ui.ChorusParam5Dial          -> set_param_map(CHORUS, 0x26);
-	m_ui.ChorusParam6Dial          -> set_param_map(CHORUS, 0x27);
-	m_ui.ChorusParam7Dial          -> set_param_map(CHORUS, 0x28);
-	m_ui.ChorusParam8Dial          -> set_param_map(CHORUS, 0x29);
-	m_ui.ChorusParam9Dial          -> set_param_map(CHORUS, 0x2a);
-	m_ui.ChorusParam10Dial         -> set_param_map(CHORUS, 0x2b);
-	m_ui.ChorusReturnDial          -> set_param_map(CHORUS, 0x2c);
-	m_ui.ChorusPanDial             -> set_param_map(CHORUS, 0x2d);
-	m_ui.ChorusReverbDial          -> set_param_map(CHORUS, 0x2e);
-	m_ui.ChorusParam11Dial         -> set_param_map(CHORUS, 0x30);
-	m_ui.ChorusParam12Dial         -> set_param_map(CHORUS, 0x31);
-	m_ui.ChorusParam13Dial         -> set_param_map(CHORUS, 0x32);
-	m_ui.ChorusParam14Dial         -> set_param_map(CHORUS, 0x33);
-	m_ui.ChorusParam15Dial         -> set_param_map(CHORUS, 0x34);
-	m_ui.ChorusParam16Dial         -> set_param_map(CHORUS, 0x35);
-
 	// VARIATION...
 	QObject::connect(m_ui.VariationResetButton,
 		SIGNAL(clicked()),
 		SLOT(variationResetButtonClicked()));
 
-	// VARIATION widget mapping...
-	m_ui.VariationTypeCombo        -> set_param_map(VARIATION, 0x40);
-	m_ui.VariationParam1Dial       -> set_param_map(VARIATION, 0x42);
-	m_ui.VariationParam2Dial       -> set_param_map(VARIATION, 0x44);
-	m_ui.VariationParam3Dial       -> set_param_map(VARIATION, 0x46);
-	m_ui.VariationParam4Dial       -> set_param_map(VARIATION, 0x48);
-	m_ui.VariationParam5Dial       -> set_param_map(VARIATION, 0x4a);
-	m_ui.VariationParam6Dial       -> set_param_map(VARIATION, 0x4c);
-	m_ui.VariationParam7Dial       -> set_param_map(VARIATION, 0x4e);
-	m_ui.VariationParam8Dial       -> set_param_map(VARIATION, 0x50);
-	m_ui.VariationParam9Dial       -> set_param_map(VARIATION, 0x52);
-	m_ui.VariationParam10Dial      -> set_param_map(VARIATION, 0x54);
-	m_ui.VariationReturnDial       -> set_param_map(VARIATION, 0x56);
-	m_ui.VariationPanDial          -> set_param_map(VARIATION, 0x57);
-	m_ui.VariationReverbDial       -> set_param_map(VARIATION, 0x58);
-	m_ui.VariationChorusDial       -> set_param_map(VARIATION, 0x59);
-	m_ui.VariationConnectDial      -> set_param_map(VARIATION, 0x5a);
-	m_ui.VariationPartDial         -> set_param_map(VARIATION, 0x5b);
-	m_ui.VariationWheelDial        -> set_param_map(VARIATION, 0x5c);
-	m_ui.VariationBendDial         -> set_param_map(VARIATION, 0x5d);
-	m_ui.VariationCATDial          -> set_param_map(VARIATION, 0x5e);
-	m_ui.VariationAC1Dial          -> set_param_map(VARIATION, 0x5f);
-	m_ui.VariationAC2Dial          -> set_param_map(VARIATION, 0x60);
-	m_ui.VariationParam11Dial      -> set_param_map(VARIATION, 0x70);
-	m_ui.VariationParam12Dial      -> set_param_map(VARIATION, 0x71);
-	m_ui.VariationParam13Dial      -> set_param_map(VARIATION, 0x72);
-	m_ui.VariationParam14Dial      -> set_param_map(VARIATION, 0x73);
-	m_ui.VariationParam15Dial      -> set_param_map(VARIATION, 0x74);
-	m_ui.VariationParam16Dial      -> set_param_map(VARIATION, 0x75);
-
 	// MULTIPART...
 	m_ui.MultipartCombo->setMaxVisibleItems(16);
 	m_ui.MultipartCombo->clear();
@@ -509,6 +483,12 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		SIGNAL(activated(int)),
 		SLOT(multipartVoiceComboActivated(int)));
 
+	// MULTIPART block copy/swap...
+	m_ui.MultipartCombo->setContextMenuPolicy(Qt::CustomContextMenu);
+	QObject::connect(m_ui.MultipartCombo,
+		SIGNAL(customContextMenuRequested(const QPoint&)),
+		SLOT(multipartContextMenu(const QPoint&)));
+
 	QObject::connect(m_ui.MultipartBankMSBDial,
 		SIGNAL(valueChanged(unsigned short)),
 		SLOT(multipartVoiceChanged()));
@@ -602,111 +582,6 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		m_ui.MultipartDepthDial, SIGNAL(valueChanged(unsigned short)),
 		m_ui.MultipartVibra, SLOT(setDepth(unsigned short)));
 
-	// MULTIPART widget mapping...
-	m_ui.MultipartElementDial      -> set_param_map(MULTIPART, 0x00);
-	m_ui.MultipartBankMSBDial      -> set_param_map(MULTIPART, 0x01);
-	m_ui.MultipartBankLSBDial      -> set_param_map(MULTIPART, 0x02);
-	m_ui.MultipartProgramDial      -> set_param_map(MULTIPART, 0x03);
-	m_ui.MultipartChannelDial      -> set_param_map(MULTIPART, 0x04);
-	m_ui.MultipartPolyModeDial     -> set_param_map(MULTIPART, 0x05);
-	m_ui.MultipartKeyAssignDial    -> set_param_map(MULTIPART, 0x06);
-	m_ui.MultipartPartModeDial     -> set_param_map(MULTIPART, 0x07);
-	m_ui.MultipartNoteShiftDial    -> set_param_map(MULTIPART, 0x08);
-	m_ui.MultipartDetuneDial       -> set_param_map(MULTIPART, 0x09);
-	m_ui.MultipartVolumeDial       -> set_param_map(MULTIPART, 0x0b);
-	m_ui.MultipartVelDepthDial     -> set_param_map(MULTIPART, 0x0c);
-	m_ui.MultipartVelOffsetDial    -> set_param_map(MULTIPART, 0x0d);
-	m_ui.MultipartPanDial          -> set_param_map(MULTIPART, 0x0e);
-	m_ui.MultipartNoteLowDial      -> set_param_map(MULTIPART, 0x0f);
-	m_ui.MultipartNoteHighDial     -> set_param_map(MULTIPART, 0x10);
-	m_ui.MultipartDryWetDial       -> set_param_map(MULTIPART, 0x11);
-	m_ui.MultipartChorusDial       -> set_param_map(MULTIPART, 0x12);
-	m_ui.MultipartReverbDial       -> set_param_map(MULTIPART, 0x13);
-	m_ui.MultipartVariationDial    -> set_param_map(MULTIPART, 0x14);
-	m_ui.MultipartRateDial         -> set_param_map(MULTIPART, 0x15);
-	m_ui.MultipartDepthDial        -> set_param_map(MULTIPART, 0x16);
-	m_ui.MultipartDelayDial        -> set_param_map(MULTIPART, 0x17);
-	m_ui.MultipartCutoffDial       -> set_param_map(MULTIPART, 0x18);
-	m_ui.MultipartResonanceDial    -> set_param_map(MULTIPART, 0x19);
-	m_ui.MultipartAttackDial       -> set_param_map(MULTIPART, 0x1a);
-	m_ui.MultipartDecayDial        -> set_param_map(MULTIPART, 0x1b);
-	m_ui.MultipartReleaseDial      -> set_param_map(MULTIPART, 0x1c);
-	m_ui.MultipartWheelPitchDial   -> set_param_map(MULTIPART, 0x1d);
-	m_ui.MultipartWheelFilterDial  -> set_param_map(MULTIPART, 0x1e);
-	m_ui.MultipartWheelAmplDial    -> set_param_map(MULTIPART, 0x1f);
-	m_ui.MultipartWheelLFOPmodDial -> set_param_map(MULTIPART, 0x20);
-	m_ui.MultipartWheelLFOFmodDial -> set_param_map(MULTIPART, 0x21);
-	m_ui.MultipartWheelLFOAmodDial -> set_param_map(MULTIPART, 0x22);
-	m_ui.MultipartBendPitchDial    -> set_param_map(MULTIPART, 0x23);
-	m_ui.MultipartBendFilterDial   -> set_param_map(MULTIPART, 0x24);
-	m_ui.MultipartBendAmplDial     -> set_param_map(MULTIPART, 0x25);
-	m_ui.MultipartBendLFOPmodDial  -> set_param_map(MULTIPART, 0x26);
-	m_ui.MultipartBendLFOFmodDial  -> set_param_map(MULTIPART, 0x27);
-	m_ui.MultipartBendLFOAmodDial  -> set_param_map(MULTIPART, 0x28);
-	m_ui.MultipartPBCheck          -> set_param_map(MULTIPART, 0x30);
-	m_ui.MultipartCATCheck         -> set_param_map(MULTIPART, 0x31);
-	m_ui.MultipartPCCheck          -> set_param_map(MULTIPART, 0x32);
-	m_ui.MultipartCCCheck          -> set_param_map(MULTIPART, 0x33);
-	m_ui.MultipartPATCheck         -> set_param_map(MULTIPART, 0x34);
-	m_ui.MultipartNoteCheck        -> set_param_map(MULTIPART, 0x35);
-	m_ui.MultipartRPNCheck         -> set_param_map(MULTIPART, 0x36);
-	m_ui.MultipartNRPNCheck        -> set_param_map(MULTIPART, 0x37);
-	m_ui.MultipartModCheck         -> set_param_map(MULTIPART, 0x38);
-	m_ui.MultipartVolCheck         -> set_param_map(MULTIPART, 0x39);
-	m_ui.MultipartPanCheck         -> set_param_map(MULTIPART, 0x3a);
-	m_ui.MultipartExprCheck        -> set_param_map(MULTIPART, 0x3b);
-	m_ui.MultipartHold1Check       -> set_param_map(MULTIPART, 0x3c);
-	m_ui.MultipartPortaCheck       -> set_param_map(MULTIPART, 0x3d);
-	m_ui.MultipartSostCheck        -> set_param_map(MULTIPART, 0x3e);
-	m_ui.MultipartPedalCheck       -> set_param_map(MULTIPART, 0x3f);
-	m_ui.MultipartBankCheck        -> set_param_map(MULTIPART, 0x40);
-	m_ui.MultipartTuningC_Dial     -> set_param_map(MULTIPART, 0x41);
-	m_ui.MultipartTuningCsDial     -> set_param_map(MULTIPART, 0x42);
-	m_ui.MultipartTuningD_Dial     -> set_param_map(MULTIPART, 0x43);
-	m_ui.MultipartTuningDsDial     -> set_param_map(MULTIPART, 0x44);
-	m_ui.MultipartTuningE_Dial     -> set_param_map(MULTIPART, 0x45);
-	m_ui.MultipartTuningF_Dial     -> set_param_map(MULTIPART, 0x46);
-	m_ui.MultipartTuningFsDial     -> set_param_map(MULTIPART, 0x47);
-	m_ui.MultipartTuningG_Dial     -> set_param_map(MULTIPART, 0x48);
-	m_ui.MultipartTuningGsDial     -> set_param_map(MULTIPART, 0x49);
-	m_ui.MultipartTuningA_Dial     -> set_param_map(MULTIPART, 0x4a);
-	m_ui.MultipartTuningAsDial     -> set_param_map(MULTIPART, 0x4b);
-	m_ui.MultipartTuningB_Dial     -> set_param_map(MULTIPART, 0x4c);
-	m_ui.MultipartCATPitchDial     -> set_param_map(MULTIPART, 0x4d);
-	m_ui.MultipartCATFilterDial    -> set_param_map(MULTIPART, 0x4e);
-	m_ui.MultipartCATAmplDial      -> set_param_map(MULTIPART, 0x4f);
-	m_ui.MultipartCATLFOPmodDial   -> set_param_map(MULTIPART, 0x50);
-	m_ui.MultipartCATLFOFmodDial   -> set_param_map(MULTIPART, 0x51);
-	m_ui.MultipartCATLFOAmodDial   -> set_param_map(MULTIPART, 0x52);
-	m_ui.MultipartPATPitchDial     -> set_param_map(MULTIPART, 0x53);
-	m_ui.MultipartPATFilterDial    -> set_param_map(MULTIPART, 0x54);
-	m_ui.MultipartPATAmplDial      -> set_param_map(MULTIPART, 0x55);
-	m_ui.MultipartPATLFOPmodDial   -> set_param_map(MULTIPART, 0x56);
-	m_ui.MultipartPATLFOFmodDial   -> set_param_map(MULTIPART, 0x57);
-	m_ui.MultipartPATLFOAmodDial   -> set_param_map(MULTIPART, 0x58);
-	m_ui.MultipartAC1ControlDial   -> set_param_map(MULTIPART, 0x59);
-	m_ui.MultipartAC1PitchDial     -> set_param_map(MULTIPART, 0x5a);
-	m_ui.MultipartAC1FilterDial    -> set_param_map(MULTIPART, 0x5b);
-	m_ui.MultipartAC1AmplDial      -> set_param_map(MULTIPART, 0x5c);
-	m_ui.MultipartAC1LFOPmodDial   -> set_param_map(MULTIPART, 0x5d);
-	m_ui.MultipartAC1LFOFmodDial   -> set_param_map(MULTIPART, 0x5e);
-	m_ui.MultipartAC1LFOAmodDial   -> set_param_map(MULTIPART, 0x5f);
-	m_ui.MultipartAC2ControlDial   -> set_param_map(MULTIPART, 0x60);
-	m_ui.MultipartAC2PitchDial     -> set_param_map(MULTIPART, 0x61);
-	m_ui.MultipartAC2FilterDial    -> set_param_map(MULTIPART, 0x62);
-	m_ui.MultipartAC2AmplDial      -> set_param_map(MULTIPART, 0x63);
-	m_ui.MultipartAC2LFOPmodDial   -> set_param_map(MULTIPART, 0x64);
-	m_ui.MultipartAC2LFOFmodDial   -> set_param_map(MULTIPART, 0x65);
-	m_ui.MultipartAC2LFOAmodDial   -> set_param_map(MULTIPART, 0x66);
-	m_ui.MultipartPortamentoDial   -> set_param_map(MULTIPART, 0x67);
-	m_ui.MultipartPortaTimeDial    -> set_param_map(MULTIPART, 0x68);
-	m_ui.MultipartAttackLevelDial  -> set_param_map(MULTIPART, 0x69);
-	m_ui.MultipartAttackTimeDial   -> set_param_map(MULTIPART, 0x6a);
-	m_ui.MultipartReleaseLevelDial -> set_param_map(MULTIPART, 0x6b);
-	m_ui.MultipartReleaseTimeDial  -> set_param_map(MULTIPART, 0x6c);
-	m_ui.MultipartVelLowDial       -> set_param_map(MULTIPART, 0x6d);
-	m_ui.MultipartVelHighDial      -> set_param_map(MULTIPART, 0x6e);
-
 	// DRUMSETUP...
 	m_ui.DrumsetupCombo->clear();
 	for (int iDrumset = 0; iDrumset < 2; ++iDrumset)
@@ -740,6 +615,12 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		SIGNAL(activated(int)),
 		SLOT(drumsetupNoteComboActivated(int)));
 
+	// DRUMSETUP block copy...
+	m_ui.DrumsetupNoteCombo->setContextMenuPolicy(Qt::CustomContextMenu);
+	QObject::connect(m_ui.DrumsetupNoteCombo,
+		SIGNAL(customContextMenuRequested(const QPoint&)),
+		SLOT(drumsetupContextMenu(const QPoint&)));
+
 	// DRUMSETUP Filter...
 	QObject::connect(
 		m_ui.DrumsetupFilter, SIGNAL(cutoffChanged(unsigned short)),
@@ -774,24 +655,6 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		m_ui.DrumsetupDecay2Dial, SIGNAL(valueChanged(unsigned short)),
 		m_ui.DrumsetupAmpEg, SLOT(setDecay2(unsigned short)));
 
-	// DRUMSETUP widget mapping...
-	m_ui.DrumsetupCoarseDial       -> set_param_map(DRUMSETUP, 0x00);
-	m_ui.DrumsetupFineDial         -> set_param_map(DRUMSETUP, 0x01);
-	m_ui.DrumsetupLevelDial        -> set_param_map(DRUMSETUP, 0x02);
-	m_ui.DrumsetupGroupDial        -> set_param_map(DRUMSETUP, 0x03);
-	m_ui.DrumsetupPanDial          -> set_param_map(DRUMSETUP, 0x04);
-	m_ui.DrumsetupReverbDial       -> set_param_map(DRUMSETUP, 0x05);
-	m_ui.DrumsetupChorusDial       -> set_param_map(DRUMSETUP, 0x06);
-	m_ui.DrumsetupVariationDial    -> set_param_map(DRUMSETUP, 0x07);
-	m_ui.DrumsetupKeyAssignDial    -> set_param_map(DRUMSETUP, 0x08);
-	m_ui.DrumsetupNoteOffCheck     -> set_param_map(DRUMSETUP, 0x09);
-	m_ui.DrumsetupNoteOnCheck      -> set_param_map(DRUMSETUP, 0x0a);
-	m_ui.DrumsetupCutoffDial       -> set_param_map(DRUMSETUP, 0x0b);
-	m_ui.DrumsetupResonanceDial    -> set_param_map(DRUMSETUP, 0x0c);
-	m_ui.DrumsetupAttackDial       -> set_param_map(DRUMSETUP, 0x0d);
-	m_ui.DrumsetupDecay1Dial       -> set_param_map(DRUMSETUP, 0x0e);
-	m_ui.DrumsetupDecay2Dial       -> set_param_map(DRUMSETUP, 0x0f);
-
 	// USERVOICE...
 	m_ui.UservoiceCombo->setMaxVisibleItems(16);
 	m_ui.UservoiceCombo->clear();
@@ -799,6 +662,7 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		m_ui.UservoiceCombo->addItem(tr("QS300 User %1").arg(iUser + 1));
 
   	m_ui.UservoiceNameEdit->setMinimumWidth(200);
+	m_ui.UservoiceWaveDial->setMaximumWidth(86);
 
 	m_ui.UservoiceElementCombo->clear();
 	for (int iElem = 0; iElem < 2; ++iElem)
@@ -815,6 +679,12 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 	QObject::connect(m_ui.UservoiceElementCombo,
 		SIGNAL(activated(int)),
 		SLOT(uservoiceElementComboActivated(int)));
+
+	// USERVOICE block copy/swap...
+	m_ui.UservoiceCombo->setContextMenuPolicy(Qt::CustomContextMenu);
+	QObject::connect(m_ui.UservoiceCombo,
+		SIGNAL(customContextMenuRequested(const QPoint&)),
+		SLOT(uservoiceContextMenu(const QPoint&)));
 	QObject::connect(m_ui.UservoiceSendButton,
 		SIGNAL(clicked()),
 		SLOT(uservoiceSendButtonClicked()));
@@ -1104,18 +974,263 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 		m_ui.UservoiceAEGLevel2Dial, SIGNAL(valueChanged(unsigned short)),
 		m_ui.UservoiceAmpEg, SLOT(setLevel2(unsigned short)));
 
-  	m_ui.UservoiceNameEdit         -> set_param_map(USERVOICE, 0x00);
-	m_ui.UservoiceElementDial      -> set_param_map(USERVOICE, 0x0b);
-	m_ui.UservoiceLevelDial        -> set_param_map(USERVOICE, 0x0c);
+	qxgeditStartup::mark("widgets");
 
-	// Element 1
-	m_ui.UservoiceWaveDial         -> setMaximumWidth(86);
-	m_ui.UservoiceWaveDial         -> set_param_map(USERVOICE, 0x3d);
-	m_ui.UservoiceNoteLowDial      -> set_param_map(USERVOICE, 0x3f);
-	m_ui.UservoiceNoteHighDial     -> set_param_map(USERVOICE, 0x40);
-	m_ui.UservoiceVelLowDial       -> set_param_map(USERVOICE, 0x41);
-	m_ui.UservoiceVelHighDial      -> set_param_map(USERVOICE, 0x42);
-	m_ui.UservoiceFEGVelCurveDial  -> set_param_map(USERVOICE, 0x43);
+	// Parameter widget mapping...
+	setupParamMaps();
+
+	qxgeditStartup::mark("bindings");
+
+	// Make sure there's nothing pending...
+	m_pMasterMap->reset_part_dirty();
+	m_pMasterMap->reset_user_dirty();
+	m_pMasterMap->reset_unsaved();
+	m_iDirtyCount = 0;
+
+	// Is any session pending to be loaded?
+	if (!m_pOptions->sessionFiles.isEmpty()) {
+		// Just load the prabably startup session...
+		if (loadSessionFile(m_pOptions->sessionFiles.first()))
+			m_pOptions->sessionFiles.clear();
+	} else {
+		// Open up with a new empty session...
+		newSession();
+	}
+
+	qxgeditStartup::mark("session");
+
+	// Make it ready :-)
+	statusBar()->showMessage(tr("Ready"), 3000);
+}
+
+
+// Parameter widget mapping (current module).
+void qxgeditMainForm::setupParamMaps (void)
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	XGParamMap *SYSTEM    = &(m_pMasterMap->SYSTEM);
+	XGParamMap *REVERB    = &(m_pMasterMap->REVERB);
+	XGParamMap *CHORUS    = &(m_pMasterMap->CHORUS);
+	XGParamMap *VARIATION = &(m_pMasterMap->VARIATION);
+	XGParamMap *MULTIPART = &(m_pMasterMap->MULTIPART);
+	XGParamMap *DRUMSETUP = &(m_pMasterMap->DRUMSETUP);
+	XGParamMap *USERVOICE = &(m_pMasterMap->USERVOICE);
+
+	// SYSTEM widget mapping...
+	m_ui.MasterTuneDial            -> set_param_map(SYSTEM, 0x00);
+	m_ui.MasterVolumeDial          -> set_param_map(SYSTEM, 0x04);
+	m_ui.MasterTransposeDial       -> set_param_map(SYSTEM, 0x06);
+
+	// REVERB widget mapping...
+	m_ui.ReverbTypeCombo           -> set_param_map(REVERB, 0x00);
+	m_ui.ReverbParam1Dial          -> set_param_map(REVERB, 0x02);
+	m_ui.ReverbParam2Dial          -> set_param_map(REVERB, 0x03);
+	m_ui.ReverbParam3Dial          -> set_param_map(REVERB, 0x04);
+	m_ui.ReverbParam4Dial          -> set_param_map(REVERB, 0x05);
+	m_ui.ReverbParam5Dial          -> set_param_map(REVERB, 0x06);
+	m_ui.ReverbParam6Dial          -> set_param_map(REVERB, 0x07);
+	m_ui.ReverbParam7Dial          -> set_param_map(REVERB, 0x08);
+	m_ui.ReverbParam8Dial          -> set_param_map(REVERB, 0x09);
+	m_ui.ReverbParam9Dial          -> set_param_map(REVERB, 0x0a);
+	m_ui.ReverbParam10Dial         -> set_param_map(REVERB, 0x0b);
+	m_ui.ReverbReturnDial          -> set_param_map(REVERB, 0x0c);
+	m_ui.ReverbPanDial             -> set_param_map(REVERB, 0x0d);
+	m_ui.ReverbParam11Dial         -> set_param_map(REVERB, 0x10);
+	m_ui.ReverbParam12Dial         -> set_param_map(REVERB, 0x11);
+	m_ui.ReverbParam13Dial         -> set_param_map(REVERB, 0x12);
+	m_ui.ReverbParam14Dial         -> set_param_map(REVERB, 0x13);
+	m_ui.ReverbParam15Dial         -> set_param_map(REVERB, 0x14);
+	m_ui.ReverbParam16Dial         -> set_param_map(REVERB, 0x15);
+
+	// CHORUS widget mapping...
+	m_ui.ChorusTypeCombo           -> set_param_map(CHORUS, 0x20);
+	m_ui.ChorusParam1Dial          -> set_param_map(CHORUS, 0x22);
+	m_ui.ChorusParam2Dial          -> set_param_map(CHORUS, 0x23);
+	m_ui.ChorusParam3Dial          -> set_param_map(CHORUS, 0x24);
+	m_ui.ChorusParam4Dial          -> set_param_map(CHORUS, 0x25);
+	m_ui.ChorusParam5Dial          -> set_param_map(CHORUS, 0x26);
+	m_ui.ChorusParam6Dial          -> set_param_map(CHORUS, 0x27);
+	m_ui.ChorusParam7Dial          -> set_param_map(CHORUS, 0x28);
+	m_ui.ChorusParam8Dial          -> set_param_map(CHORUS, 0x29);
+	m_ui.ChorusParam9Dial          -> set_param_map(CHORUS, 0x2a);
+	m_ui.ChorusParam10Dial         -> set_param_map(CHORUS, 0x2b);
+	m_ui.ChorusReturnDial          -> set_param_map(CHORUS, 0x2c);
+	m_ui.ChorusPanDial             -> set_param_map(CHORUS, 0x2d);
+	m_ui.ChorusReverbDial          -> set_param_map(CHORUS, 0x2e);
+	m_ui.ChorusParam11Dial         -> set_param_map(CHORUS, 0x30);
+	m_ui.ChorusParam12Dial         -> set_param_map(CHORUS, 0x31);
+	m_ui.ChorusParam13Dial         -> set_param_map(CHORUS, 0x32);
+	m_ui.ChorusParam14Dial         -> set_param_map(CHORUS, 0x33);
+	m_ui.ChorusParam15Dial         -> set_param_map(CHORUS, 0x34);
+	m_ui.ChorusParam16Dial         -> set_param_map(CHORUS, 0x35);
+
+	// VARIATION widget mapping...
+	m_ui.VariationTypeCombo        -> set_param_map(VARIATION, 0x40);
+	m_ui.VariationParam1Dial       -> set_param_map(VARIATION, 0x42);
+	m_ui.VariationParam2Dial       -> set_param_map(VARIATION, 0x44);
+	m_ui.VariationParam3Dial       -> set_param_map(VARIATION, 0x46);
+	m_ui.VariationParam4Dial       -> set_param_map(VARIATION, 0x48);
+	m_ui.VariationParam5Dial       -> set_param_map(VARIATION, 0x4a);
+	m_ui.VariationParam6Dial       -> set_param_map(VARIATION, 0x4c);
+	m_ui.VariationParam7Dial       -> set_param_map(VARIATION, 0x4e);
+	m_ui.VariationParam8Dial       -> set_param_map(VARIATION, 0x50);
+	m_ui.VariationParam9Dial       -> set_param_map(VARIATION, 0x52);
+	m_ui.VariationParam10Dial      -> set_param_map(VARIATION, 0x54);
+	m_ui.VariationReturnDial       -> set_param_map(VARIATION, 0x56);
+	m_ui.VariationPanDial          -> set_param_map(VARIATION, 0x57);
+	m_ui.VariationReverbDial       -> set_param_map(VARIATION, 0x58);
+	m_ui.VariationChorusDial       -> set_param_map(VARIATION, 0x59);
+	m_ui.VariationConnectDial      -> set_param_map(VARIATION, 0x5a);
+	m_ui.VariationPartDial         -> set_param_map(VARIATION, 0x5b);
+	m_ui.VariationWheelDial        -> set_param_map(VARIATION, 0x5c);
+	m_ui.VariationBendDial         -> set_param_map(VARIATION, 0x5d);
+	m_ui.VariationCATDial          -> set_param_map(VARIATION, 0x5e);
+	m_ui.VariationAC1Dial          -> set_param_map(VARIATION, 0x5f);
+	m_ui.VariationAC2Dial          -> set_param_map(VARIATION, 0x60);
+	m_ui.VariationParam11Dial      -> set_param_map(VARIATION, 0x70);
+	m_ui.VariationParam12Dial      -> set_param_map(VARIATION, 0x71);
+	m_ui.VariationParam13Dial      -> set_param_map(VARIATION, 0x72);
+	m_ui.VariationParam14Dial      -> set_param_map(VARIATION, 0x73);
+	m_ui.VariationParam15Dial      -> set_param_map(VARIATION, 0x74);
+	m_ui.VariationParam16Dial      -> set_param_map(VARIATION, 0x75);
+
+	// MULTIPART widget mapping...
+	m_ui.MultipartElementDial      -> set_param_map(MULTIPART, 0x00);
+	m_ui.MultipartBankMSBDial      -> set_param_map(MULTIPART, 0x01);
+	m_ui.MultipartBankLSBDial      -> set_param_map(MULTIPART, 0x02);
+	m_ui.MultipartProgramDial      -> set_param_map(MULTIPART, 0x03);
+	m_ui.MultipartChannelDial      -> set_param_map(MULTIPART, 0x04);
+	m_ui.MultipartPolyModeDial     -> set_param_map(MULTIPART, 0x05);
+	m_ui.MultipartKeyAssignDial    -> set_param_map(MULTIPART, 0x06);
+	m_ui.MultipartPartModeDial     -> set_param_map(MULTIPART, 0x07);
+	m_ui.MultipartNoteShiftDial    -> set_param_map(MULTIPART, 0x08);
+	m_ui.MultipartDetuneDial       -> set_param_map(MULTIPART, 0x09);
+	m_ui.MultipartVolumeDial       -> set_param_map(MULTIPART, 0x0b);
+	m_ui.MultipartVelDepthDial     -> set_param_map(MULTIPART, 0x0c);
+	m_ui.MultipartVelOffsetDial    -> set_param_map(MULTIPART, 0x0d);
+	m_ui.MultipartPanDial          -> set_param_map(MULTIPART, 0x0e);
+	m_ui.MultipartNoteLowDial      -> set_param_map(MULTIPART, 0x0f);
+	m_ui.MultipartNoteHighDial     -> set_param_map(MULTIPART, 0x10);
+	m_ui.MultipartDryWetDial       -> set_param_map(MULTIPART, 0x11);
+	m_ui.MultipartChorusDial       -> set_param_map(MULTIPART, 0x12);
+	m_ui.MultipartReverbDial       -> set_param_map(MULTIPART, 0x13);
+	m_ui.MultipartVariationDial    -> set_param_map(MULTIPART, 0x14);
+	m_ui.MultipartRateDial         -> set_param_map(MULTIPART, 0x15);
+	m_ui.MultipartDepthDial        -> set_param_map(MULTIPART, 0x16);
+	m_ui.MultipartDelayDial        -> set_param_map(MULTIPART, 0x17);
+	m_ui.MultipartCutoffDial       -> set_param_map(MULTIPART, 0x18);
+	m_ui.MultipartResonanceDial    -> set_param_map(MULTIPART, 0x19);
+	m_ui.MultipartAttackDial       -> set_param_map(MULTIPART, 0x1a);
+	m_ui.MultipartDecayDial        -> set_param_map(MULTIPART, 0x1b);
+	m_ui.MultipartReleaseDial      -> set_param_map(MULTIPART, 0x1c);
+	m_ui.MultipartWheelPitchDial   -> set_param_map(MULTIPART, 0x1d);
+	m_ui.MultipartWheelFilterDial  -> set_param_map(MULTIPART, 0x1e);
+	m_ui.MultipartWheelAmplDial    -> set_param_map(MULTIPART, 0x1f);
+	m_ui.MultipartWheelLFOPmodDial -> set_param_map(MULTIPART, 0x20);
+	m_ui.MultipartWheelLFOFmodDial -> set_param_map(MULTIPART, 0x21);
+	m_ui.MultipartWheelLFOAmodDial -> set_param_map(MULTIPART, 0x22);
+	m_ui.MultipartBendPitchDial    -> set_param_map(MULTIPART, 0x23);
+	m_ui.MultipartBendFilterDial   -> set_param_map(MULTIPART, 0x24);
+	m_ui.MultipartBendAmplDial     -> set_param_map(MULTIPART, 0x25);
+	m_ui.MultipartBendLFOPmodDial  -> set_param_map(MULTIPART, 0x26);
+	m_ui.MultipartBendLFOFmodDial  -> set_param_map(MULTIPART, 0x27);
+	m_ui.MultipartBendLFOAmodDial  -> set_param_map(MULTIPART, 0x28);
+	m_ui.MultipartPBCheck          -> set_param_map(MULTIPART, 0x30);
+	m_ui.MultipartCATCheck         -> set_param_map(MULTIPART, 0x31);
+	m_ui.MultipartPCCheck          -> set_param_map(MULTIPART, 0x32);
+	m_ui.MultipartCCCheck          -> set_param_map(MULTIPART, 0x33);
+	m_ui.MultipartPATCheck         -> set_param_map(MULTIPART, 0x34);
+	m_ui.MultipartNoteCheck        -> set_param_map(MULTIPART, 0x35);
+	m_ui.MultipartRPNCheck         -> set_param_map(MULTIPART, 0x36);
+	m_ui.MultipartNRPNCheck        -> set_param_map(MULTIPART, 0x37);
+	m_ui.MultipartModCheck         -> set_param_map(MULTIPART, 0x38);
+	m_ui.MultipartVolCheck         -> set_param_map(MULTIPART, 0x39);
+	m_ui.MultipartPanCheck         -> set_param_map(MULTIPART, 0x3a);
+	m_ui.MultipartExprCheck        -> set_param_map(MULTIPART, 0x3b);
+	m_ui.MultipartHold1Check       -> set_param_map(MULTIPART, 0x3c);
+	m_ui.MultipartPortaCheck       -> set_param_map(MULTIPART, 0x3d);
+	m_ui.MultipartSostCheck        -> set_param_map(MULTIPART, 0x3e);
+	m_ui.MultipartPedalCheck       -> set_param_map(MULTIPART, 0x3f);
+	m_ui.MultipartBankCheck        -> set_param_map(MULTIPART, 0x40);
+	m_ui.MultipartTuningC_Dial     -> set_param_map(MULTIPART, 0x41);
+	m_ui.MultipartTuningCsDial     -> set_param_map(MULTIPART, 0x42);
+	m_ui.MultipartTuningD_Dial     -> set_param_map(MULTIPART, 0x43);
+	m_ui.MultipartTuningDsDial     -> set_param_map(MULTIPART, 0x44);
+	m_ui.MultipartTuningE_Dial     -> set_param_map(MULTIPART, 0x45);
+	m_ui.MultipartTuningF_Dial     -> set_param_map(MULTIPART, 0x46);
+	m_ui.MultipartTuningFsDial     -> set_param_map(MULTIPART, 0x47);
+	m_ui.MultipartTuningG_Dial     -> set_param_map(MULTIPART, 0x48);
+	m_ui.MultipartTuningGsDial     -> set_param_map(MULTIPART, 0x49);
+	m_ui.MultipartTuningA_Dial     -> set_param_map(MULTIPART, 0x4a);
+	m_ui.MultipartTuningAsDial     -> set_param_map(MULTIPART, 0x4b);
+	m_ui.MultipartTuningB_Dial     -> set_param_map(MULTIPART, 0x4c);
+	m_ui.MultipartCATPitchDial     -> set_param_map(MULTIPART, 0x4d);
+	m_ui.MultipartCATFilterDial    -> set_param_map(MULTIPART, 0x4e);
+	m_ui.MultipartCATAmplDial      -> set_param_map(MULTIPART, 0x4f);
+	m_ui.MultipartCATLFOPmodDial   -> set_param_map(MULTIPART, 0x50);
+	m_ui.MultipartCATLFOFmodDial   -> set_param_map(MULTIPART, 0x51);
+	m_ui.MultipartCATLFOAmodDial   -> set_param_map(MULTIPART, 0x52);
+	m_ui.MultipartPATPitchDial     -> set_param_map(MULTIPART, 0x53);
+	m_ui.MultipartPATFilterDial    -> set_param_map(MULTIPART, 0x54);
+	m_ui.MultipartPATAmplDial      -> set_param_map(MULTIPART, 0x55);
+	m_ui.MultipartPATLFOPmodDial   -> set_param_map(MULTIPART, 0x56);
+	m_ui.MultipartPATLFOFmodDial   -> set_param_map(MULTIPART, 0x57);
+	m_ui.MultipartPATLFOAmodDial   -> set_param_map(MULTIPART, 0x58);
+	m_ui.MultipartAC1ControlDial   -> set_param_map(MULTIPART, 0x59);
+	m_ui.MultipartAC1PitchDial     -> set_param_map(MULTIPART, 0x5a);
+	m_ui.MultipartAC1FilterDial    -> set_param_map(MULTIPART, 0x5b);
+	m_ui.MultipartAC1AmplDial      -> set_param_map(MULTIPART, 0x5c);
+	m_ui.MultipartAC1LFOPmodDial   -> set_param_map(MULTIPART, 0x5d);
+	m_ui.MultipartAC1LFOFmodDial   -> set_param_map(MULTIPART, 0x5e);
+	m_ui.MultipartAC1LFOAmodDial   -> set_param_map(MULTIPART, 0x5f);
+	m_ui.MultipartAC2ControlDial   -> set_param_map(MULTIPART, 0x60);
+	m_ui.MultipartAC2PitchDial     -> set_param_map(MULTIPART, 0x61);
+	m_ui.MultipartAC2FilterDial    -> set_param_map(MULTIPART, 0x62);
+	m_ui.MultipartAC2AmplDial      -> set_param_map(MULTIPART, 0x63);
+	m_ui.MultipartAC2LFOPmodDial   -> set_param_map(MULTIPART, 0x64);
+	m_ui.MultipartAC2LFOFmodDial   -> set_param_map(MULTIPART, 0x65);
+	m_ui.MultipartAC2LFOAmodDial   -> set_param_map(MULTIPART, 0x66);
+	m_ui.MultipartPortamentoDial   -> set_param_map(MULTIPART, 0x67);
+	m_ui.MultipartPortaTimeDial    -> set_param_map(MULTIPART, 0x68);
+	m_ui.MultipartAttackLevelDial  -> set_param_map(MULTIPART, 0x69);
+	m_ui.MultipartAttackTimeDial   -> set_param_map(MULTIPART, 0x6a);
+	m_ui.MultipartReleaseLevelDial -> set_param_map(MULTIPART, 0x6b);
+	m_ui.MultipartReleaseTimeDial  -> set_param_map(MULTIPART, 0x6c);
+	m_ui.MultipartVelLowDial       -> set_param_map(MULTIPART, 0x6d);
+	m_ui.MultipartVelHighDial      -> set_param_map(MULTIPART, 0x6e);
+
+	// DRUMSETUP widget mapping...
+	m_ui.DrumsetupCoarseDial       -> set_param_map(DRUMSETUP, 0x00);
+	m_ui.DrumsetupFineDial         -> set_param_map(DRUMSETUP, 0x01);
+	m_ui.DrumsetupLevelDial        -> set_param_map(DRUMSETUP, 0x02);
+	m_ui.DrumsetupGroupDial        -> set_param_map(DRUMSETUP, 0x03);
+	m_ui.DrumsetupPanDial          -> set_param_map(DRUMSETUP, 0x04);
+	m_ui.DrumsetupReverbDial       -> set_param_map(DRUMSETUP, 0x05);
+	m_ui.DrumsetupChorusDial       -> set_param_map(DRUMSETUP, 0x06);
+	m_ui.DrumsetupVariationDial    -> set_param_map(DRUMSETUP, 0x07);
+	m_ui.DrumsetupKeyAssignDial    -> set_param_map(DRUMSETUP, 0x08);
+	m_ui.DrumsetupNoteOffCheck     -> set_param_map(DRUMSETUP, 0x09);
+	m_ui.DrumsetupNoteOnCheck      -> set_param_map(DRUMSETUP, 0x0a);
+	m_ui.DrumsetupCutoffDial       -> set_param_map(DRUMSETUP, 0x0b);
+	m_ui.DrumsetupResonanceDial    -> set_param_map(DRUMSETUP, 0x0c);
+	m_ui.DrumsetupAttackDial       -> set_param_map(DRUMSETUP, 0x0d);
+	m_ui.DrumsetupDecay1Dial       -> set_param_map(DRUMSETUP, 0x0e);
+	m_ui.DrumsetupDecay2Dial       -> set_param_map(DRUMSETUP, 0x0f);
+
+	// USERVOICE widget mapping...
+	m_ui.UservoiceNameEdit         -> set_param_map(USERVOICE, 0x00);
+	m_ui.UservoiceElementDial      -> set_param_map(USERVOICE, 0x0b);
+	m_ui.UservoiceLevelDial        -> set_param_map(USERVOICE, 0x0c);
+
+	// USERVOICE Element 1 widget mapping...
+	m_ui.UservoiceWaveDial         -> set_param_map(USERVOICE, 0x3d);
+	m_ui.UservoiceNoteLowDial      -> set_param_map(USERVOICE, 0x3f);
+	m_ui.UservoiceNoteHighDial     -> set_param_map(USERVOICE, 0x40);
+	m_ui.UservoiceVelLowDial       -> set_param_map(USERVOICE, 0x41);
+	m_ui.UservoiceVelHighDial      -> set_param_map(USERVOICE, 0x42);
+	m_ui.UservoiceFEGVelCurveDial  -> set_param_map(USERVOICE, 0x43);
 	m_ui.UservoiceLFOWaveDial      -> set_param_map(USERVOICE, 0x44);
 	m_ui.UservoiceLFOPhaseDial     -> set_param_map(USERVOICE, 0x45);
 	m_ui.UservoiceLFOSpeedDial     -> set_param_map(USERVOICE, 0x46);
@@ -1188,24 +1303,6 @@ void qxgeditMainForm::setup ( qxgeditOptions *pOptions )
 	m_ui.UservoiceAEGLevel2Dial    -> set_param_map(USERVOICE, 0x89);
 	m_ui.UservoiceAEGOffsetDial    -> set_param_map(USERVOICE, 0x8a);
 	m_ui.UservoiceAEGResonanceDial -> set_param_map(USERVOICE, 0x8c);
-
-	// Make sure there's nothing pending...
-	m_pMasterMap->reset_part_dirty();
-	m_pMasterMap->reset_user_dirty();
-	m_iDirtyCount = 0;
-
-	// Is any session pending to be loaded?
-	if (!m_pOptions->sessionFiles.isEmpty()) {
-		// Just load the prabably startup session...
-		if (loadSessionFile(m_pOptions->sessionFiles.first()))
-			m_pOptions->sessionFiles.clear();
-	} else {
-		// Open up with a new empty session...
-		newSession();
-	}
-
-	// Make it ready :-)
-	statusBar()->showMessage(tr("Ready"), 3000);
 }
 
 
@@ -1225,7 +1322,10 @@ bool qxgeditMainForm::queryClose (void)
 			// Specific options...
 			if (m_pMasterMap)
 				m_pOptions->bUservoiceAutoSend = m_pMasterMap->auto_send();
+			// XG modules bindings...
+			saveModules();
 			// Save main windows state.
+			m_pOptions->saveWidgetGeometry(m_pMidiMonitorForm);
 			m_pOptions->saveWidgetGeometry(this, true);
 		}
 	}
@@ -1307,12 +1407,30 @@ void qxgeditMainForm::handle_sigterm (void)
 }
 
 
+// Find which module master map a received event belongs to.
+qxgeditXGMasterMap *qxgeditMainForm::senderMasterMap (void) const
+{
+	QObject *pSender = sender();
+	if (pSender) {
+		QListIterator<qxgeditXGModule *> iter(m_modules);
+		while (iter.hasNext()) {
+			qxgeditXGModule *pModule = iter.next();
+			if (pModule->midiDevice() == pSender)
+				return pModule->masterMap();
+		}
+	}
+
+	return m_pMasterMap;
+}
+
+
 // RPN Event handler.
 void qxgeditMainForm::rpnReceived (
 	unsigned char ch, unsigned short rpn, unsigned short val )
 {
-	if (m_pMasterMap)
-		m_pMasterMap->set_rpn_value(ch, rpn, val);
+	qxgeditXGMasterMap *pMasterMap = senderMasterMap();
+	if (pMasterMap)
+		pMasterMap->set_rpn_value(ch, rpn, val);
 }
 
 
@@ -1320,21 +1438,47 @@ void qxgeditMainForm::rpnReceived (
 void qxgeditMainForm::nrpnReceived (
 	unsigned char ch, unsigned short nrpn, unsigned short val )
 {
-	if (m_pMasterMap)
-		m_pMasterMap->set_nrpn_value(ch, nrpn, val);
+	qxgeditXGMasterMap *pMasterMap = senderMasterMap();
+	if (pMasterMap)
+		pMasterMap->set_nrpn_value(ch, nrpn, val);
 }
 
 
 // SYSEX Event handler.
 void qxgeditMainForm::sysexReceived ( const QByteArray& sysex )
 {
-	if (m_pMasterMap) {
+	qxgeditXGMasterMap *pMasterMap = senderMasterMap();
+	if (pMasterMap == nullptr)
+		return;
+	// Fetching in progress? give it a chance first...
+	if (m_pFetch == nullptr || m_pFetch->masterMap() != pMasterMap
+		|| !m_pFetch->process(sysex)) {
 		qxgeditXGMasterMap::SysexData sysex_data;
-		m_pMasterMap->add_sysex_data(sysex_data,
+		pMasterMap->add_sysex_data(sysex_data,
 			(unsigned char *) sysex.data(),
 			(unsigned short) sysex.length());
-		m_pMasterMap->set_sysex_data(sysex_data);
+		pMasterMap->set_sysex_data(sysex_data);
 	}
+	// Done; let direct commits through again, if due...
+	pMasterMap->release_commit(
+		(const unsigned char *) sysex.data(),
+		(unsigned int) sysex.length());
+}
+
+
+// Concurrent model commit handler (coalesced).
+void qxgeditMainForm::commitReceived (void)
+{
+	qxgeditXGMasterMap *pMasterMap = senderMasterMap();
+	if (pMasterMap)
+		pMasterMap->flush_commits();
+}
+
+
+// MIDI monitor window show/hide notification.
+void qxgeditMainForm::midiMonitorVisibilityChanged ( bool bVisible )
+{
+	m_ui.viewMidiMonitorAction->setChecked(bVisible);
 }
 
 
@@ -1371,6 +1515,9 @@ bool qxgeditMainForm::newSession (void)
 	m_sFilename.clear();
 	m_iDirtyCount = 0;
 
+	if (m_pMasterMap)
+		m_pMasterMap->reset_unsaved();
+
 	stabilizeForm();
 
 	return true;
@@ -1566,10 +1713,9 @@ bool qxgeditMainForm::loadSessionFile ( const QString& sFilename )
 			if (pBuff[i++] == 0xf7) {
 				++iSysex;
 				m_pMasterMap->add_sysex_data(sysex_data, pBuff, i);
-				if (i < iRead) {
-					::memmove(pBuff, pBuff + i, iRead -= i);
-					i = 0;
-				}
+				// Start over, even when it ends right here...
+				::memmove(pBuff, pBuff + i, iRead -= i);
+				i = 0;
 			}
 		}
 	}
@@ -1606,6 +1752,8 @@ bool qxgeditMainForm::loadSessionFile ( const QString& sFilename )
 	updateRecentFiles(sFilename);
 	m_iDirtyCount = 0;
 
+	m_pMasterMap->reset_unsaved();
+
 	// Save as default session directory.
 	if (m_pOptions)
 		m_pOptions->sSessionDir = QFileInfo(sFilename).absolutePath();
@@ -1627,11 +1775,13 @@ bool qxgeditMainForm::saveSessionFile ( const QString& sFilename )
 	// Tell the world we'll take some time...
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-	// XG Parameter changes...
-	XGParamMasterMap::const_iterator iter = m_pMasterMap->constBegin();
-	for (; iter != m_pMasterMap->constEnd(); ++iter) {
-		XGParam *pParam = iter.value();
-		if (pParam->high() == 0x11 || pParam->value() == pParam->def())
+	// XG Parameter changes (modified from default only)...
+	QList<XGParam *> params;
+	m_pMasterMap->modified_params(params);
+	QListIterator<XGParam *> iter(params);
+	while (iter.hasNext()) {
+		XGParam *pParam = iter.next();
+		if (pParam->high() == 0x11)
 			continue;
 		XGParamSysex sysex(pParam);
 		file.write((const char *) sysex.data(), sysex.size());
@@ -1655,6 +1805,8 @@ bool qxgeditMainForm::saveSessionFile ( const QString& sFilename )
 	updateRecentFiles(sFilename);
 	m_iDirtyCount = 0;
 
+	m_pMasterMap->reset_unsaved();
+
 	// Save as default session directory.
 	if (m_pOptions)
 		m_pOptions->sSessionDir = QFileInfo(sFilename).absolutePath();
@@ -1665,6 +1817,252 @@ bool qxgeditMainForm::saveSessionFile ( const QString& sFilename )
 }
 
 
+// Export current session as a SMF setup sequence.
+bool qxgeditMainForm::exportSession (void)
+{
+	if (m_pOptions == nullptr)
+		return false;
+
+	// Suggest a filename, from the current session one...
+	const QString sExt("mid");
+	QString sFilename = m_sFilename;
+	if (!sFilename.isEmpty()) {
+		const QFileInfo info(sFilename);
+		sFilename = info.absolutePath() + '/' + info.completeBaseName();
+		sFilename += '.' + sExt;
+	}
+
+	// Ask for the file to export...
+	const QString& sTitle  = tr("Export SMF");
+	const QString& sFilter = tr("MIDI files (*.%1)").arg(sExt);
+#if 0//QT_VERSION < QT_VERSION_CHECK(4, 4, 0)
+	sFilename = QFileDialog::getSaveFileName(this,
+		sTitle, sFilename, sFilter);
+#else
+	// Construct save-file dialog...
+	QFileDialog fileDialog(this,
+		sTitle, sFilename, sFilter);
+	// Set proper save-file modes...
+	fileDialog.setAcceptMode(QFileDialog::AcceptSave);
+	fileDialog.setFileMode(QFileDialog::AnyFile);
+	fileDialog.setDefaultSuffix(sExt);
+	// Stuff sidebar...
+	QList<QUrl> urls(fileDialog.sidebarUrls());
+	urls.append(QUrl::fromLocalFile(m_pOptions->sSessionDir));
+	fileDialog.setSidebarUrls(urls);
+	// Show save-file dialog...
+	if (!fileDialog.exec())
+		return false;
+	// Have the save-file name...
+	sFilename = fileDialog.selectedFiles().first();
+#endif
+	// Have we cancelled it?
+	if (sFilename.isEmpty())
+		return false;
+	// Enforce extension...
+	if (QFileInfo(sFilename).suffix() != sExt) {
+		sFilename += '.' + sExt;
+		// Check if already exists...
+		if (QFileInfo(sFilename).exists()) {
+			if (QMessageBox::warning(this,
+				tr("Warning"),
+				tr("The file already exists:\n\n"
+				"\"%1\"\n\n"
+				"Do you want to replace it?")
+				.arg(sFilename),
+				QMessageBox::Yes | QMessageBox::No) == QMessageBox::No)
+				return false;
+		}
+	}
+
+	// Export it right away.
+	if (!exportSmfFile(sFilename)) {
+		showMessageError(
+			tr("Could not export SMF file:\n\n"
+			"\"%1\"").arg(sFilename));
+		return false;
+	}
+
+	return true;
+}
+
+
+// Delay after an XG System On (msecs): devices take ~50msec
+// to reset, so give them twice as much, to be on the safe side.
+static const unsigned int c_iXGSystemOnDelay = 100;
+
+
+// Export current session to specific SMF file path.
+bool qxgeditMainForm::exportSmfFile ( const QString& sFilename )
+{
+	if (m_pMasterMap == nullptr)
+		return false;
+
+	// Tell the world we'll take some time...
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+	qxgeditSmfFile smf;
+	if (m_pOptions)
+		smf.setRate(m_pOptions->iMidiRate);
+
+	// XG System On, first and foremost...
+	XGParam *pParam = m_pMasterMap->find_param(0x00, 0x00, 0x7e);
+	if (pParam) {
+		XGParamSysex sysex(pParam);
+		// Device needs some time to reset after an XG System On...
+		smf.addSysex(sysex.data(), sysex.size(), c_iXGSystemOnDelay);
+	}
+
+	// XG Parameter changes (modified from default only)...
+	QList<XGParam *> params;
+	m_pMasterMap->modified_params(params);
+	QListIterator<XGParam *> iter(params);
+	while (iter.hasNext()) {
+		pParam = iter.next();
+		if (pParam->high() == 0x11)
+			continue;
+		// Only the ones in effect (eg. current effect type)...
+		if (pParam != m_pMasterMap->find_param(
+				pParam->high(), pParam->mid(), pParam->low()))
+			continue;
+		XGParamSysex sysex(pParam);
+		smf.addSysex(sysex.data(), sysex.size());
+	}
+
+	// (QS300) USER VOICE Bulk Dumps, whether dirty...
+	for (unsigned short iUser = 0; iUser < 32; ++iUser) {
+		if (m_pMasterMap->user_dirty(iUser)) {
+			XGUserVoiceSysex sysex(iUser);
+			smf.addSysex(sysex.data(), sysex.size());
+		}
+	}
+
+	const bool bResult = smf.save(sFilename, sessionName(m_sFilename));
+
+	// We're formerly done.
+	QApplication::restoreOverrideCursor();
+
+	if (bResult) {
+		showMessage(tr("Exported %1 messages (%2 msec): \"%3\".")
+			.arg(smf.count()).arg(smf.duration())
+			.arg(QFileInfo(sFilename).fileName()));
+	}
+
+	return bResult;
+}
+
+
+// Fetch (pull) current device state into the current module.
+bool qxgeditMainForm::fetchSession (void)
+{
+	if (m_pMasterMap == nullptr || m_pFetch)
+		return false;
+
+	qxgeditXGFetch fetch(m_pMasterMap);
+
+	QProgressDialog progress(
+		tr("Fetching parameters from device..."),
+		tr("Cancel"), 0, 0, this);
+	progress.setWindowTitle(tr("Fetch from Device"));
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(0);
+
+	QObject::connect(&fetch,
+		SIGNAL(progress(int, int)),
+		&progress, SLOT(setValue(int)));
+	QObject::connect(&fetch,
+		SIGNAL(finished(int)),
+		&progress, SLOT(reset()));
+	QObject::connect(&progress,
+		SIGNAL(canceled()),
+		&fetch, SLOT(cancel()));
+
+	m_pFetch = &fetch;
+
+	const bool bStarted = fetch.start();
+	if (bStarted) {
+		progress.setMaximum(fetch.count());
+		progress.exec();
+	}
+
+	m_pFetch = nullptr;
+
+	if (!bStarted) {
+		showMessageError(tr("Could not fetch from device."));
+		return false;
+	}
+
+	if (progress.wasCanceled()) {
+		showMessage(tr("Fetch cancelled (%1 of %2 blocks).")
+			.arg(fetch.done()).arg(fetch.count()));
+		return false;
+	}
+
+	contentsChanged();
+
+	if (fetch.failed() > 0) {
+		showMessage(tr("Fetched %1 of %2 blocks (%3 failed).")
+			.arg(fetch.done() - fetch.failed())
+			.arg(fetch.count()).arg(fetch.failed()));
+	} else {
+		showMessage(tr("Fetched %1 blocks.").arg(fetch.count()));
+	}
+
+	return true;
+}
+
+
+// Prompt for a snapshot file name.
+QString qxgeditMainForm::snapshotFileName ( bool bSave )
+{
+	QString sFilename;
+
+	if (m_pOptions == nullptr)
+		return sFilename;
+
+	const QString sExt("xgs");
+	const QString& sTitle  = (bSave ? tr("Save Snapshot") : tr("Load Snapshot"));
+	const QString& sFilter = tr("Snapshot files (*.%1)").arg(sExt);
+#if 0//QT_VERSION < QT_VERSION_CHECK(4, 4, 0)
+	if (bSave) {
+		sFilename = QFileDialog::getSaveFileName(this,
+			sTitle, m_pOptions->sSessionDir, sFilter);
+	} else {
+		sFilename = QFileDialog::getOpenFileName(this,
+			sTitle, m_pOptions->sSessionDir, sFilter);
+	}
+#else
+	// Construct snapshot file dialog...
+	QFileDialog fileDialog(this,
+		sTitle, m_pOptions->sSessionDir, sFilter);
+	// Set proper file modes...
+	if (bSave) {
+		fileDialog.setAcceptMode(QFileDialog::AcceptSave);
+		fileDialog.setFileMode(QFileDialog::AnyFile);
+	} else {
+		fileDialog.setAcceptMode(QFileDialog::AcceptOpen);
+		fileDialog.setFileMode(QFileDialog::ExistingFile);
+	}
+	fileDialog.setDefaultSuffix(sExt);
+	// Stuff sidebar...
+	QList<QUrl> urls(fileDialog.sidebarUrls());
+	urls.append(QUrl::fromLocalFile(m_pOptions->sSessionDir));
+	fileDialog.setSidebarUrls(urls);
+	// Show dialog...
+	if (!fileDialog.exec())
+		return QString();
+	// Have the file name...
+	sFilename = fileDialog.selectedFiles().first();
+#endif
+	// Enforce extension...
+	if (bSave && !sFilename.isEmpty()
+		&& QFileInfo(sFilename).suffix() != sExt)
+		sFilename += '.' + sExt;
+
+	return sFilename;
+}
+
+
 //-------------------------------------------------------------------------
 // qxgeditMainForm -- File Action slots.
 
@@ -1717,6 +2115,63 @@ void qxgeditMainForm::fileSaveAs (void)
 }
 
 
+// Export current session as a SMF setup sequence.
+void qxgeditMainForm::fileExport (void)
+{
+	exportSession();
+}
+
+
+// Fetch current device state.
+void qxgeditMainForm::fileFetch (void)
+{
+	fetchSession();
+}
+
+
+// Load and apply a parameter state snapshot.
+void qxgeditMainForm::fileLoadSnapshot (void)
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	const QString& sFilename = snapshotFileName(false);
+	if (sFilename.isEmpty())
+		return;
+
+	if (m_pMasterMap->load_snapshot(sFilename)) {
+		showMessage(tr("Snapshot loaded: \"%1\".")
+			.arg(QFileInfo(sFilename).fileName()));
+	} else {
+		showMessageError(
+			tr("Could not load snapshot file:\n\n"
+			"\"%1\"\n\n"
+			"Invalid or incompatible snapshot.").arg(sFilename));
+	}
+}
+
+
+// Save current parameter state snapshot.
+void qxgeditMainForm::fileSaveSnapshot (void)
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	const QString& sFilename = snapshotFileName(true);
+	if (sFilename.isEmpty())
+		return;
+
+	if (m_pMasterMap->save_snapshot(sFilename)) {
+		showMessage(tr("Snapshot saved: \"%1\".")
+			.arg(QFileInfo(sFilename).fileName()));
+	} else {
+		showMessageError(
+			tr("Could not save snapshot file:\n\n"
+			"\"%1\"").arg(sFilename));
+	}
+}
+
+
 // Exit application program.
 void qxgeditMainForm::fileExit (void)
 {
@@ -1749,6 +2204,19 @@ void qxgeditMainForm::viewToolbar ( bool bOn )
 }
 
 
+// Show/hide the MIDI monitor window.
+void qxgeditMainForm::viewMidiMonitor ( bool bOn )
+{
+	if (bOn) {
+		m_pMidiMonitorForm->show();
+		m_pMidiMonitorForm->raise();
+		m_pMidiMonitorForm->activateWindow();
+	} else {
+		m_pMidiMonitorForm->hide();
+	}
+}
+
+
 // Randomize current parameter page view.
 void qxgeditMainForm::viewRandomize (void)
 {
@@ -1856,10 +2324,27 @@ void qxgeditMainForm::viewOptions (void)
 	const int     iOldBaseFontSize   = m_pOptions->iBaseFontSize;
 	const QString sOldStyleTheme     = m_pOptions->sStyleTheme;
 	const QString sOldColorTheme     = m_pOptions->sColorTheme;
+	const int     iOldMidiRate       = m_pOptions->iMidiRate;
+	const bool    bOldMidiPaced      = m_pOptions->bMidiPaced;
+	const bool    bOldMidiCompact    = m_pOptions->bMidiCompact;
+	const bool    bOldMidiDirect     = m_pOptions->bMidiDirect;
+	const bool    bOldPublishState   = m_pOptions->bPublishState;
 	// Load the current setup settings.
 	qxgeditOptionsForm optionsForm(this);
 	optionsForm.setOptions(m_pOptions);
 	if (optionsForm.exec()) {
+		// Current module bindings might have changed...
+		saveModules();
+		// MIDI behavior options apply to all modules, right away...
+		if (iOldMidiRate     != m_pOptions->iMidiRate    ||
+			bOldMidiPaced    != m_pOptions->bMidiPaced   ||
+			bOldMidiCompact  != m_pOptions->bMidiCompact ||
+			bOldMidiDirect   != m_pOptions->bMidiDirect  ||
+			bOldPublishState != m_pOptions->bPublishState) {
+			QListIterator<qxgeditXGModule *> iter(m_modules);
+			while (iter.hasNext())
+				setupModule(iter.next());
+		}
 		// Check whether restart is needed or whether
 		// custom options maybe set up immediately...
 		int iNeedRestart = 0;
@@ -1902,6 +2387,72 @@ void qxgeditMainForm::viewOptions (void)
 }
 
 
+//-------------------------------------------------------------------------
+// qxgeditMainForm -- Module Action slots.
+
+// Add a new XG module (device) context.
+void qxgeditMainForm::moduleNew (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	addModule(QStringList(), QStringList());
+	saveModules();
+
+	// Make it the current one...
+	setCurrentModule(m_modules.count() - 1);
+
+	showMessage(tr("New module: %1.")
+		.arg(m_modules.last()->name()));
+}
+
+
+// Remove the current XG module (device) context.
+void qxgeditMainForm::moduleRemove (void)
+{
+	// The first module is never removed...
+	const int iModule = m_iCurrentModule;
+	if (iModule < 1 || iModule >= m_modules.count())
+		return;
+
+	qxgeditXGModule *pModule = m_modules.at(iModule);
+
+	if (m_pOptions && m_pOptions->bConfirmRemove) {
+		if (QMessageBox::warning(this,
+			tr("Warning"),
+			tr("About to remove module:\n\n"
+			"%1\n\n"
+			"Are you sure?").arg(pModule->name()),
+			QMessageBox::Ok | QMessageBox::Cancel)
+			== QMessageBox::Cancel)
+			return;
+	}
+
+	// Switch over to the first one, then get rid of it...
+	setCurrentModule(0);
+
+	m_modules.removeAt(iModule);
+	delete pModule;
+
+	saveModules();
+	updateModuleMenu();
+}
+
+
+// Switch the current XG module (device) context.
+void qxgeditMainForm::moduleActivated (void)
+{
+	QAction *pAction = qobject_cast<QAction *> (sender());
+	if (pAction) {
+		const int iModule = pAction->data().toInt();
+		if (iModule != m_iCurrentModule)
+			setCurrentModule(iModule);
+		else
+			pAction->setChecked(true);
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // qxgeditMainForm -- Help Action slots.
 
@@ -1948,6 +2499,32 @@ void qxgeditMainForm::helpAboutQt (void)
 }
 
 
+// Show live object and byte counts per subsystem.
+void qxgeditMainForm::helpAllocReport (void)
+{
+	QMessageBox::information(this,
+		tr("Allocation Report"),
+		"<pre>" + allocReport().join('\n').toHtmlEscaped() + "</pre>");
+}
+
+
+// Allocation accounting report (all modules).
+QStringList qxgeditMainForm::allocReport (void) const
+{
+	QList<XGParamMasterMap *> maps;
+	QListIterator<qxgeditXGModule *> iter(m_modules);
+	while (iter.hasNext())
+		maps.append(iter.next()->masterMap());
+
+	QStringList lines = qxgeditAlloc::report(maps);
+	lines.append(QString());
+	lines.append(tr("Pixmap cache limit: %1 KB (usage not exposed by Qt)")
+		.arg(QPixmapCache::cacheLimit()));
+
+	return lines;
+}
+
+
 //-------------------------------------------------------------------------
 // qxgeditMainForm -- Main window stabilization.
 
@@ -1957,6 +2534,8 @@ void qxgeditMainForm::stabilizeForm (void)
 	QString sSessionName = sessionName(m_sFilename);
 	if (m_iDirtyCount > 0)
 		sSessionName += ' ' + tr("[modified]");
+	if (m_modules.count() > 1 && m_iCurrentModule >= 0)
+		sSessionName += " - " + m_modules.at(m_iCurrentModule)->name();
 	setWindowTitle(sSessionName);
 
 	// Update the main menu state...
@@ -1981,6 +2560,55 @@ void qxgeditMainForm::stabilizeForm (void)
 		m_ui.UservoiceSendButton->setEnabled(m_pMasterMap->user_dirty_1(iUser));
 		m_ui.UservoiceNameEdit->stabilizePreset();
 	}
+
+	updateModifiedItems();
+}
+
+
+// Modified/unsaved sub-block indicators (part, drum note, user voice):
+// bold when modified from default, italic when changed since last save.
+void qxgeditMainForm::updateModifiedItems (void)
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	// MULTIPART...
+	const int iParts = m_ui.MultipartCombo->count();
+	for (int iPart = 0; iPart < iParts; ++iPart)
+		updateModifiedItem(m_ui.MultipartCombo, iPart, 0x08, iPart);
+
+	// DRUMSETUP...
+	const unsigned short high = 0x30 + m_ui.DrumsetupCombo->currentIndex();
+	const int iNotes = m_ui.DrumsetupNoteCombo->count();
+	for (int iNote = 0; iNote < iNotes; ++iNote) {
+		updateModifiedItem(m_ui.DrumsetupNoteCombo, iNote, high,
+			m_ui.DrumsetupNoteCombo->itemData(iNote).toUInt());
+	}
+
+	// (QS300) USERVOICE...
+	const int iUsers = m_ui.UservoiceCombo->count();
+	for (int iUser = 0; iUser < iUsers; ++iUser)
+		updateModifiedItem(m_ui.UservoiceCombo, iUser, 0x11, iUser);
+}
+
+
+void qxgeditMainForm::updateModifiedItem ( QComboBox *pComboBox,
+	int iItem, unsigned short high, unsigned short mid )
+{
+	const bool bModified = m_pMasterMap->is_modified(high, mid);
+	const bool bUnsaved  = m_pMasterMap->is_unsaved(high, mid);
+
+	// Only when it changes (state kept aside the item font)...
+	const int iState = (bModified ? 1 : 0) | (bUnsaved ? 2 : 0);
+	const QVariant& state = pComboBox->itemData(iItem, Qt::UserRole + 1);
+	if (state.isValid() && state.toInt() == iState)
+		return;
+
+	QFont font(pComboBox->font());
+	font.setBold(bModified);
+	font.setItalic(bUnsaved);
+	pComboBox->setItemData(iItem, font, Qt::FontRole);
+	pComboBox->setItemData(iItem, iState, Qt::UserRole + 1);
 }
 
 
@@ -2025,6 +2653,227 @@ void qxgeditMainForm::updateRecentFilesMenu (void)
 	}
 }
 
+
+// Update the XG modules menu.
+void qxgeditMainForm::updateModuleMenu (void)
+{
+	m_ui.moduleMenu->clear();
+	m_ui.moduleMenu->addAction(m_ui.moduleNewAction);
+	m_ui.moduleMenu->addAction(m_ui.moduleRemoveAction);
+	m_ui.moduleMenu->addSeparator();
+
+	const int iModules = m_modules.count();
+	for (int i = 0; i < iModules; ++i) {
+		QAction *pAction = m_ui.moduleMenu->addAction(
+			QString("&%1 %2").arg(i + 1).arg(m_modules.at(i)->name()),
+			this, SLOT(moduleActivated()));
+		pAction->setCheckable(true);
+		pAction->setChecked(i == m_iCurrentModule);
+		pAction->setData(i);
+	}
+
+	m_ui.moduleRemoveAction->setEnabled(m_iCurrentModule > 0);
+}
+
+
+// Create a new XG module (device) context.
+// Module MIDI behavior options (compact send, live state
+// publication, direct commit, output pacing).
+void qxgeditMainForm::setupModule ( qxgeditXGModule *pModule )
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	pModule->masterMap()->set_compact_send(m_pOptions->bMidiCompact);
+	if (!pModule->setPublishState(m_pOptions->bPublishState)) {
+		showMessageError(
+			tr("Could not publish live state of %1.")
+			.arg(pModule->name()));
+	}
+	pModule->setDirectCommit(m_pOptions->bMidiDirect);
+	pModule->midiDevice()->setOutputRate(
+		m_pOptions->bMidiPaced ? m_pOptions->iMidiRate : 0);
+}
+
+
+qxgeditXGModule *qxgeditMainForm::addModule (
+	const QStringList& inputs, const QStringList& outputs )
+{
+	const int iModule = m_modules.count();
+
+	// Each module has its own distinct ALSA client...
+	QString sClientName = QXGEDIT_TITLE;
+	if (iModule > 0)
+		sClientName += ' ' + QString::number(iModule + 1);
+
+	qxgeditXGModule *pModule
+		= new qxgeditXGModule(tr("Module %1").arg(iModule + 1), sClientName);
+
+	if (m_pOptions) {
+		pModule->masterMap()->set_auto_send(m_pOptions->bUservoiceAutoSend);
+		setupModule(pModule);
+	}
+
+	qxgeditMidiDevice *pMidiDevice = pModule->midiDevice();
+	QObject::connect(pMidiDevice,
+		SIGNAL(receiveSysex(const QByteArray&)),
+		SLOT(sysexReceived(const QByteArray&)));
+	QObject::connect(pMidiDevice,
+		SIGNAL(receiveCommit()),
+		SLOT(commitReceived()));
+	QObject::connect(pMidiDevice,
+		SIGNAL(receiveRpn(unsigned char, unsigned short, unsigned short)),
+		SLOT(rpnReceived(unsigned char, unsigned short, unsigned short)));
+	QObject::connect(pMidiDevice,
+		SIGNAL(receiveNrpn(unsigned char, unsigned short, unsigned short)),
+		SLOT(nrpnReceived(unsigned char, unsigned short, unsigned short)));
+
+	// MIDI Learn controller bindings...
+	qxgeditMidiLearn *pMidiLearn = pModule->midiLearn();
+	if (m_pOptions && iModule < m_pOptions->midiLearn.count())
+		pMidiLearn->loadBindings(m_pOptions->midiLearn.at(iModule));
+	QObject::connect(pMidiLearn,
+		SIGNAL(learned(XGParam *)),
+		SLOT(midiLearned(XGParam *)));
+
+	// And respective connections...
+	pModule->setInputs(inputs);
+	pModule->setOutputs(outputs);
+
+	qxgeditStartup::mark("midi connect");
+
+	m_modules.append(pModule);
+
+	return pModule;
+}
+
+
+// Make a module the current one (model only).
+void qxgeditMainForm::selectModule ( int iModule )
+{
+	if (iModule < 0 || iModule >= m_modules.count())
+		return;
+
+	qxgeditXGModule *pModule = m_modules.at(iModule);
+	qxgeditXGModule::setInstance(pModule);
+
+	m_pMasterMap  = pModule->masterMap();
+	m_pMidiDevice = pModule->midiDevice();
+
+	m_pMidiMonitorForm->setMidiDevice(m_pMidiDevice, m_pMasterMap);
+
+	m_iCurrentModule = iModule;
+}
+
+
+// Switch to another module, keeping the current view selection.
+void qxgeditMainForm::setCurrentModule ( int iModule )
+{
+	if (iModule < 0 || iModule >= m_modules.count())
+		return;
+
+	selectModule(iModule);
+
+	// Carry on the current part, drum note and user voice...
+	multipartComboActivated(m_ui.MultipartCombo->currentIndex());
+	drumsetupComboActivated(m_ui.DrumsetupCombo->currentIndex());
+	m_pMasterMap->USERVOICE.set_current_key(
+		m_ui.UservoiceCombo->currentIndex());
+
+	// Rebind all parameter widgets...
+	setupParamMaps();
+
+	++m_iUservoiceElementUpdate;
+	m_ui.UservoiceElementCombo->setCurrentIndex(
+		m_pMasterMap->USERVOICE.current_element());
+	--m_iUservoiceElementUpdate;
+
+	m_ui.UservoiceAutoSendCheck->setChecked(m_pMasterMap->auto_send());
+
+	updateModuleMenu();
+	stabilizeForm();
+}
+
+
+// Store all modules bindings into options.
+void qxgeditMainForm::saveModules (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	m_pOptions->moduleInputs.clear();
+	m_pOptions->moduleOutputs.clear();
+	m_pOptions->midiLearn.clear();
+
+	const int iModules = m_modules.count();
+	for (int i = 0; i < iModules; ++i) {
+		qxgeditXGModule *pModule = m_modules.at(i);
+		if (i == 0) {
+			m_pOptions->midiInputs  = pModule->inputs();
+			m_pOptions->midiOutputs = pModule->outputs();
+		} else {
+			m_pOptions->moduleInputs.append(pModule->inputs());
+			m_pOptions->moduleOutputs.append(pModule->outputs());
+		}
+		m_pOptions->midiLearn.append(pModule->midiLearn()->saveBindings());
+	}
+}
+
+
+// Parameter widget context menu (MIDI Learn).
+bool qxgeditMainForm::context_menu ( QWidget *pWidget,
+	XGParam *pParam, QContextMenuEvent *pContextMenuEvent )
+{
+	if (m_iCurrentModule < 0 || m_iCurrentModule >= m_modules.count())
+		return false;
+
+	qxgeditMidiLearn *pMidiLearn = m_modules.at(m_iCurrentModule)->midiLearn();
+	if (pMidiLearn == nullptr)
+		return false;
+
+	const bool bLearning = (pMidiLearn->learnParam() == pParam);
+	const QString& sText = pMidiLearn->text(pParam);
+
+	QMenu menu(pWidget);
+	QAction *pLearnAction = menu.addAction(bLearning
+		? tr("Cancel MIDI &Learn") : tr("MIDI &Learn..."));
+	QAction *pUnlearnAction = menu.addAction(sText.isEmpty()
+		? tr("MIDI &Unlearn") : tr("MIDI &Unlearn (%1)").arg(sText));
+	pUnlearnAction->setEnabled(!sText.isEmpty());
+
+	QAction *pAction = menu.exec(pContextMenuEvent->globalPos());
+	if (pAction == pLearnAction) {
+		if (bLearning) {
+			pMidiLearn->cancel();
+			showMessage(tr("MIDI Learn cancelled."));
+		} else {
+			pMidiLearn->learn(pParam);
+			showMessage(tr("MIDI Learn: %1 (move a controller...)")
+				.arg(pParam->label()));
+		}
+	}
+	else
+	if (pAction == pUnlearnAction) {
+		pMidiLearn->unbind(pParam);
+		showMessage(tr("MIDI Unlearn: %1.").arg(pParam->label()));
+	}
+
+	return true;
+}
+
+
+// MIDI Learn completion notification.
+void qxgeditMainForm::midiLearned ( XGParam *pParam )
+{
+	qxgeditMidiLearn *pMidiLearn
+		= qobject_cast<qxgeditMidiLearn *> (sender());
+	if (pMidiLearn && pParam) {
+		showMessage(tr("MIDI Learn: %1 = %2.")
+			.arg(pParam->label()).arg(pMidiLearn->text(pParam)));
+	}
+}
+
+
 // XG System Reset...
 void qxgeditMainForm::masterReset (void)
 {
@@ -2318,6 +3167,46 @@ void qxgeditMainForm::multipartResetButtonClicked (void)
 }
 
 
+// MULTIPART block copy/swap context menu.
+void qxgeditMainForm::multipartContextMenu ( const QPoint& pos )
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	const int iPart = m_ui.MultipartCombo->currentIndex();
+
+	QMenu menu(this);
+	QMenu *pCopyMenu = menu.addMenu(tr("&Copy To"));
+	QMenu *pSwapMenu = menu.addMenu(tr("&Swap With"));
+	const int iParts = m_ui.MultipartCombo->count();
+	for (int i = 0; i < iParts; ++i) {
+		if (i == iPart)
+			continue;
+		const QString& sText = m_ui.MultipartCombo->itemText(i);
+		pCopyMenu->addAction(sText)->setData(i);
+		pSwapMenu->addAction(sText)->setData(i);
+	}
+
+	QAction *pAction = menu.exec(m_ui.MultipartCombo->mapToGlobal(pos));
+	if (pAction == nullptr)
+		return;
+
+	const int iToPart = pAction->data().toInt();
+	if (pSwapMenu->actions().contains(pAction)) {
+		m_pMasterMap->swap_parts(iPart, iToPart);
+		showMessage(tr("MULTI PART / %1: swapped with %2.")
+			.arg(m_ui.MultipartCombo->currentText()).arg(pAction->text()));
+	} else {
+		m_pMasterMap->copy_part(iPart, iToPart);
+		showMessage(tr("MULTI PART / %1: copied to %2.")
+			.arg(m_ui.MultipartCombo->currentText()).arg(pAction->text()));
+	}
+
+	multipartVoiceChanged();
+	stabilizeForm();
+}
+
+
 // Switch the current DRUMSETUP section...
 void qxgeditMainForm::drumsetupComboActivated ( int iDrumset )
 {
@@ -2327,6 +3216,8 @@ void qxgeditMainForm::drumsetupComboActivated ( int iDrumset )
 			+ m_ui.DrumsetupNoteCombo->itemData(iNote).toUInt();
 		m_pMasterMap->DRUMSETUP.set_current_key(key);
 	}
+
+	updateModifiedItems();
 }
 
 // Switch the current DRUMSETUP Drum Kit Voice...
@@ -2355,6 +3246,7 @@ void qxgeditMainForm::drumsetupVoiceComboActivated ( int iDrumKit )
 			m_pMasterMap->DRUMSETUP.current_key());
 		if (iNote >= 0)
 			m_ui.DrumsetupNoteCombo->setCurrentIndex(iNote);
+		updateModifiedItems();
 	}
 }
 
@@ -2412,6 +3304,66 @@ void qxgeditMainForm::drumsetupResetButtonClicked (void)
 }
 
 
+// DRUMSETUP block copy context menu (across notes and drum sets).
+void qxgeditMainForm::drumsetupContextMenu ( const QPoint& pos )
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	const int iDrumset = m_ui.DrumsetupCombo->currentIndex();
+	const int iNote = m_ui.DrumsetupNoteCombo->currentIndex();
+	const unsigned short drum_key
+		= m_ui.DrumsetupNoteCombo->itemData(iNote).toUInt();
+
+	QMenu menu(this);
+	QMenu *pCopyMenu = menu.addMenu(tr("&Copy To"));
+	const int iNotes = m_ui.DrumsetupNoteCombo->count();
+	for (int i = 0; i < iNotes; ++i) {
+		if (i == iNote)
+			continue;
+		pCopyMenu->addAction(m_ui.DrumsetupNoteCombo->itemText(i))
+			->setData(m_ui.DrumsetupNoteCombo->itemData(i));
+	}
+	QAction *pCloneAction = menu.addAction(tr("Copy To &All Notes"));
+	menu.addSeparator();
+	const int iDrumsets = m_ui.DrumsetupCombo->count();
+	for (int i = 0; i < iDrumsets; ++i) {
+		if (i == iDrumset)
+			continue;
+		menu.addAction(tr("Copy To %1")
+			.arg(m_ui.DrumsetupCombo->itemText(i)))->setData(-(i + 1));
+	}
+
+	QAction *pAction = menu.exec(m_ui.DrumsetupNoteCombo->mapToGlobal(pos));
+	if (pAction == nullptr)
+		return;
+
+	if (pAction == pCloneAction) {
+		// Clone across the whole kit, all in one go...
+		m_pMasterMap->begin_block();
+		for (int i = 0; i < iNotes; ++i) {
+			if (i == iNote)
+				continue;
+			m_pMasterMap->copy_drums(iDrumset, drum_key, iDrumset,
+				m_ui.DrumsetupNoteCombo->itemData(i).toUInt());
+		}
+		m_pMasterMap->end_block();
+	} else {
+		const int iData = pAction->data().toInt();
+		if (iData < 0)
+			m_pMasterMap->copy_drums(iDrumset, drum_key, -(iData + 1), drum_key);
+		else
+			m_pMasterMap->copy_drums(iDrumset, drum_key, iDrumset, iData);
+	}
+
+	showMessage(tr("DRUM SETUP / %1: copied to %2.")
+		.arg(m_ui.DrumsetupNoteCombo->currentText())
+		.arg(pAction->text().remove('&')));
+
+	stabilizeForm();
+}
+
+
 // Switch the current USERVOICE section...
 void qxgeditMainForm::uservoiceComboActivated ( int iUser )
 {
@@ -2470,6 +3422,59 @@ void qxgeditMainForm::uservoiceResetButtonClicked (void)
 }
 
 
+// USERVOICE block copy/swap context menu (voices and elements).
+void qxgeditMainForm::uservoiceContextMenu ( const QPoint& pos )
+{
+	if (m_pMasterMap == nullptr)
+		return;
+
+	const int iUser = m_ui.UservoiceCombo->currentIndex();
+	const int iElem = m_ui.UservoiceElementCombo->currentIndex();
+
+	QMenu menu(this);
+	QMenu *pCopyMenu = menu.addMenu(tr("&Copy To"));
+	QMenu *pSwapMenu = menu.addMenu(tr("&Swap With"));
+	const int iUsers = m_ui.UservoiceCombo->count();
+	for (int i = 0; i < iUsers; ++i) {
+		if (i == iUser)
+			continue;
+		const QString& sText = m_ui.UservoiceCombo->itemText(i);
+		pCopyMenu->addAction(sText)->setData(i);
+		pSwapMenu->addAction(sText)->setData(i);
+	}
+	menu.addSeparator();
+	const int iToElem = (iElem > 0 ? 0 : 1);
+	QAction *pCopyElemAction = menu.addAction(tr("Copy %1 To %2")
+		.arg(m_ui.UservoiceElementCombo->itemText(iElem))
+		.arg(m_ui.UservoiceElementCombo->itemText(iToElem)));
+	QAction *pSwapElemAction = menu.addAction(tr("Swap &Elements"));
+
+	QAction *pAction = menu.exec(m_ui.UservoiceCombo->mapToGlobal(pos));
+	if (pAction == nullptr)
+		return;
+
+	QString sText = pAction->text().remove('&');
+	if (pAction == pCopyElemAction)
+		m_pMasterMap->copy_user_element(iUser, iElem, iUser, iToElem);
+	else
+	if (pAction == pSwapElemAction)
+		m_pMasterMap->swap_user_elements(iUser);
+	else
+	if (pSwapMenu->actions().contains(pAction)) {
+		m_pMasterMap->swap_users(iUser, pAction->data().toInt());
+		sText = tr("swapped with %1").arg(sText);
+	} else {
+		m_pMasterMap->copy_user(iUser, pAction->data().toInt());
+		sText = tr("copied to %1").arg(sText);
+	}
+
+	showMessage(tr("USER VOICE / %1: %2.")
+		.arg(m_ui.UservoiceCombo->currentText()).arg(sText));
+
+	stabilizeForm();
+}
+
+
 void qxgeditMainForm::uservoiceSendButtonClicked (void)
 {
 	if (m_pMasterMap) {
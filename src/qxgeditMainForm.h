@@ -24,21 +24,27 @@
 
 #include "ui_qxgeditMainForm.h"
 
+#include "XGParamWidget.h"
+
 
 // Forward declarations...
 class qxgeditOptions;
 class qxgeditMidiDevice;
 class qxgeditXGMasterMap;
+class qxgeditXGModule;
+class qxgeditXGFetch;
+class qxgeditMidiMonitorForm;
 
 class QSocketNotifier;
 class QTreeWidget;
+class QComboBox;
 class QLabel;
 
 
 //----------------------------------------------------------------------------
 // qxgeditMainForm -- UI wrapper form.
 
-class qxgeditMainForm : public QMainWindow
+class qxgeditMainForm : public QMainWindow, public XGParamWidgetMenu
 {
 	Q_OBJECT
 
@@ -58,6 +64,14 @@ public:
 	void showMessage(const QString& s);
 	void showMessageError(const QString& s);
 
+	// Session file load/save (also for remote control).
+	bool loadSessionFile(const QString& sFilename);
+	bool saveSessionFile(const QString& sFilename);
+
+	// Parameter widget context menu (MIDI Learn).
+	bool context_menu(QWidget *pWidget,
+		XGParam *pParam, QContextMenuEvent *pContextMenuEvent);
+
 public slots:
 
 	void contentsChanged();
@@ -69,20 +83,36 @@ protected slots:
 	void fileOpenRecent();
 	void fileSave();
 	void fileSaveAs();
+	void fileExport();
+	void fileFetch();
+	void fileLoadSnapshot();
+	void fileSaveSnapshot();
 	void fileExit();
 
+	// Allocation accounting report (all modules).
+	QStringList allocReport() const;
+
 	void viewMenubar(bool bOn);
 	void viewStatusbar(bool bOn);
 	void viewToolbar(bool bOn);
 	void viewRandomize();
+	void viewMidiMonitor(bool bOn);
 	void viewOptions();
 
+	void moduleNew();
+	void moduleRemove();
+	void moduleActivated();
+
+	void midiLearned(XGParam *pParam);
+
 	void helpAbout();
 	void helpAboutQt();
+	void helpAllocReport();
 
 	void stabilizeForm();
 
 	void updateRecentFilesMenu();
+	void updateModuleMenu();
 
 	void masterResetButtonClicked();
 
@@ -95,11 +125,13 @@ protected slots:
 	void multipartVoiceComboActivated(int);
 	void multipartVoiceChanged();
 	void multipartPartModeChanged(unsigned short);
+	void multipartContextMenu(const QPoint&);
 
 	void drumsetupResetButtonClicked();
 	void drumsetupComboActivated(int);
 	void drumsetupVoiceComboActivated(int);
 	void drumsetupNoteComboActivated(int);
+	void drumsetupContextMenu(const QPoint&);
 
 	void uservoiceResetButtonClicked();
 	void uservoiceComboActivated(int);
@@ -107,6 +139,7 @@ protected slots:
 	void uservoiceSendButtonClicked();
 	void uservoiceAutoSendCheckToggled(bool);
 	void uservoiceElementChanged(unsigned short);
+	void uservoiceContextMenu(const QPoint&);
 
 	void uservoiceLoadPresetFile(const QString&);
 	void uservoiceSavePresetFile(const QString&);
@@ -114,6 +147,9 @@ protected slots:
 	void rpnReceived(unsigned char, unsigned short, unsigned short);
 	void nrpnReceived(unsigned char, unsigned short, unsigned short);
 	void sysexReceived(const QByteArray&);
+	void commitReceived();
+
+	void midiMonitorVisibilityChanged(bool bVisible);
 
 	void handle_sigusr1();
 	void handle_sigterm();
@@ -131,15 +167,36 @@ protected:
 	bool saveSession(bool bPrompt);
 	bool closeSession();
 
-	bool loadSessionFile(const QString& sFilename);
-	bool saveSessionFile(const QString& sFilename);
+	bool exportSession();
+	bool exportSmfFile(const QString& sFilename);
+
+	bool fetchSession();
+
+	QString snapshotFileName(bool bSave);
 
 	void updateRecentFiles(const QString& sFilename);
 
+	void setupParamMaps();
+
+	void setupModule(qxgeditXGModule *pModule);
+
+	qxgeditXGModule *addModule(
+		const QStringList& inputs, const QStringList& outputs);
+	void selectModule(int iModule);
+	void setCurrentModule(int iModule);
+	void saveModules();
+
+	qxgeditXGMasterMap *senderMasterMap() const;
+
 	void masterReset();
 
 	bool isRandomizable() const;
 
+	// Modified/unsaved sub-block indicators (part, drum note, user voice).
+	void updateModifiedItems();
+	void updateModifiedItem(QComboBox *pComboBox, int iItem,
+		unsigned short high, unsigned short mid);
+
 private:
 
 	// The Qt-designer UI struct...
@@ -147,9 +204,21 @@ private:
 
 	// Instance variables...
 	qxgeditOptions     *m_pOptions;
+
+	// XG modules (device contexts).
+	QList<qxgeditXGModule *> m_modules;
+	int m_iCurrentModule;
+
+	// Current module shortcuts.
 	qxgeditMidiDevice  *m_pMidiDevice;
 	qxgeditXGMasterMap *m_pMasterMap;
 
+	// Device state fetch (pull) engine.
+	qxgeditXGFetch *m_pFetch;
+
+	// MIDI traffic monitor (tool window).
+	qxgeditMidiMonitorForm *m_pMidiMonitorForm;
+
 	QSocketNotifier *m_pSigusr1Notifier;
 	QSocketNotifier *m_pSigtermNotifier;
 
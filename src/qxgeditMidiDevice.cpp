@@ -23,8 +23,14 @@
 #include "qxgeditMidiDevice.h"
 
 #include "qxgeditMidiRpn.h"
+#include "qxgeditMidiLearn.h"
+#include "qxgeditMidiPorts.h"
+#include "qxgeditTrace.h"
+#include "qxgeditAlloc.h"
 
 #include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 #include <QApplication>
 
 #ifdef CONFIG_ALSA_MIDI
@@ -35,7 +41,38 @@
 #include <RtMidi.h>
 #endif
 
+#include <atomic>
+
 #include <cstdio>
+#include <cstring>
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiTapUser -- MIDI traffic tap scoped use (I/O threads).
+
+class qxgeditMidiTapUser
+{
+public:
+
+	// Constructor.
+	qxgeditMidiTapUser(qxgeditMidiDevice *pMidiDevice)
+		: m_pMidiDevice(pMidiDevice),
+			m_pTap(pMidiDevice ? pMidiDevice->acquireTap() : nullptr) {}
+
+	// Destructor.
+	~qxgeditMidiTapUser()
+		{ if (m_pTap) m_pMidiDevice->releaseTap(); }
+
+	// Tap accessor (null if none attached).
+	qxgeditMidiDevice::Tap *tap() const
+		{ return m_pTap; }
+
+private:
+
+	// Instance variables.
+	qxgeditMidiDevice *m_pMidiDevice;
+	qxgeditMidiDevice::Tap *m_pTap;
+};
 
 
 //----------------------------------------------------------------------------
@@ -55,6 +92,9 @@ public:
 	// ALSA client descriptor accessor.
 	snd_seq_t *alsaSeq() const;
 
+	// ALSA sequencer event output (buffered, until outputFlush).
+	void outputEvent(snd_seq_event_t *pEv, unsigned int iBytes) const;
+
 	// MIDI event capture method.
 	void capture(snd_seq_event_t *pEv);
 
@@ -66,15 +106,36 @@ public:
 	RtMidiIn  *midiIn() const;
 	RtMidiOut *midiOut() const;
 
-	// MIDI event capture method.
+#endif
+
+	// MIDI event capture method (complete messages).
 	void capture(const QByteArray& midi);
 
-#endif
+	// Concurrent model commit (SysEx only).
+	bool commit(const unsigned char *pSysex, unsigned int iSysex);
 
 	// MIDI SysEx sender.
 	void sendSysex(const QByteArray& sysex) const;
 	void sendSysex(unsigned char *pSysex, unsigned short iSysex) const;
 
+	// MIDI (complete short messages or SysEx) sender.
+	void sendMidi(const QByteArray& midi) const;
+
+	// MIDI SysEx output (actual, from the output thread).
+	void outputSysex(unsigned char *pSysex, unsigned short iSysex) const;
+
+	// MIDI output (actual, from the output thread).
+	void outputMidi(unsigned char *pMidi, unsigned short iMidi) const;
+
+	// MIDI output flush (once per batch, from the output thread).
+	void outputFlush() const;
+
+	// MIDI output pacing rate (bytes per second, 0=direct).
+	void setOutputRate(unsigned int iRate)
+		{ m_iOutputRate.store(iRate); }
+	unsigned int outputRate() const
+		{ return m_iOutputRate.load(); }
+
 	// MIDI Input(readable) / Output(writable) device list
 	QStringList inputs() const
 		{ return deviceList(true); }
@@ -82,24 +143,40 @@ public:
 		{ return deviceList(false); }
 
 	// MIDI Input(readable) / Output(writable) connects.
-	bool connectInputs(const QStringList& inputs) const
+	bool connectInputs(const QStringList& inputs)
 		{ return connectDeviceList(true, inputs); }
-	bool connectOutputs(const QStringList& outputs) const
+	bool connectOutputs(const QStringList& outputs)
 		{ return connectDeviceList(false, outputs); }
 
+	// MIDI Input(readable) / Output(writable) reconnects
+	// (eg. on port registry changes, when devices reappear).
+	void reconnect();
+
 protected:
 
 	// MIDI device listing.
 	QStringList deviceList(bool bReadable) const;
 
 	// MIDI device connects.
-	bool connectDeviceList(bool bReadable, const QStringList& list) const;
+	bool connectDeviceList(bool bReadable, const QStringList& list);
+
+#ifdef CONFIG_ALSA_MIDI
+
+	// MIDI device subscriptions (by registry lookup).
+	int subscribeDeviceList(bool bReadable, const QStringList& list) const;
+
+#endif
 
 private:
 
 	// Instance variables.
 	qxgeditMidiDevice *m_pMidiDevice;
 
+	// Output scheduler (one per device).
+	class OutputThread;
+
+	OutputThread *m_pOutputThread;
+
 #ifdef CONFIG_ALSA_MIDI
 
 	snd_seq_t *m_pAlsaSeq;
@@ -107,12 +184,30 @@ private:
 	int        m_iAlsaInPort;
 	int        m_iAlsaOutPort;
 
+	// Short messages encoder.
+	snd_midi_event_t *m_pAlsaEncoder;
+
+	// Output pacing queue (output thread only).
+	int m_iAlsaQueue;
+
+	mutable bool m_bAlsaQueue;
+	mutable bool m_bAlsaQueueSync;
+	mutable snd_seq_real_time_t m_alsaQueueTime;
+
 	// Name says it all.
 	class InputRpn;
+	class InputSysex;
 	class InputThread;
 
 	InputThread *m_pInputThread;
 
+	// Shared port registry.
+	qxgeditMidiPorts *m_pMidiPorts;
+
+	// Configured connections (kept for reconnecting).
+	QStringList m_alsaInputs;
+	QStringList m_alsaOutputs;
+
 #endif
 
 #ifdef CONFIG_RTMIDI
@@ -120,14 +215,22 @@ private:
 	RtMidiIn  *m_pMidiIn;
 	RtMidiOut *m_pMidiOut;
 
+#endif
+
+	// Complete messages RPN/NRPN parser.
 	qxgeditMidiRpn m_xrpn;
 
-#endif
+	// Output pacing rate (bytes per second, 0=direct).
+	std::atomic<unsigned int> m_iOutputRate;
 };
 
 
 #ifdef CONFIG_ALSA_MIDI
 
+// ALSA sequencer output buffer size (bytes).
+static const size_t c_iAlsaOutputBufferSize = 65536;
+
+
 //----------------------------------------------------------------------
 // class qxgeditMidiDevice::InputRpn -- MIDI RPN/NRPN input parser
 //
@@ -196,6 +299,177 @@ public:
 	}
 };
 
+//----------------------------------------------------------------------
+// class qxgeditMidiDevice::Impl::InputSysex -- MIDI SysEx reassembler
+//
+// ALSA delivers long SysEx messages as several SND_SEQ_EVENT_SYSEX
+// chunks; these are collected here, per source port, into fixed size
+// buffers allocated once, yielding complete messages only.
+//
+
+class qxgeditMidiDevice::Impl::InputSysex
+{
+public:
+
+	// Limits.
+	enum { MaxSources = 8, MaxSize = 8192 };
+
+	// Constructor.
+	InputSysex() : m_iEvict(0)
+	{
+		for (int i = 0; i < MaxSources; ++i) {
+			Slot& slot = m_slots[i];
+			slot.client = -1;
+			slot.port   = -1;
+			slot.busy   = false;
+			slot.skip   = false;
+			slot.size   = 0;
+			slot.data   = new unsigned char [MaxSize];
+		}
+
+		::memset(&m_ev, 0, sizeof(m_ev));
+	}
+
+	// Destructor.
+	~InputSysex()
+	{
+		for (int i = 0; i < MaxSources; ++i)
+			delete [] m_slots[i].data;
+	}
+
+	// Reassembler (true if a complete message is ready).
+	bool process ( const snd_seq_event_t *ev )
+	{
+		const unsigned char *data
+			= (const unsigned char *) ev->data.ext.ptr;
+		const unsigned int len = ev->data.ext.len;
+		if (data == nullptr || len < 1)
+			return false;
+
+		const bool bStart = (data[0] == 0xf0);
+		const bool bEnd = (data[len - 1] == 0xf7);
+
+		Slot *slot = find(ev->source.client, ev->source.port);
+		if (slot && bStart) {
+			// Restarted before the end: drop what we've got...
+		#ifdef CONFIG_DEBUG
+			qDebug("qxgeditMidiDevice::InputSysex: %d:%d: "
+				"incomplete SysEx dropped (%u bytes).",
+				slot->client, slot->port, slot->size);
+		#endif
+			release(slot);
+			slot = nullptr;
+		}
+
+		if (slot == nullptr) {
+			// Stray continuation?
+			if (!bStart)
+				return false;
+			// Complete in one chunk (most usual)...
+			if (bEnd) {
+				m_ev = *ev;
+				return true;
+			}
+			// Start collecting...
+			slot = acquire(ev->source.client, ev->source.port);
+		}
+
+		if (!slot->skip) {
+			if (slot->size + len > (unsigned int) MaxSize) {
+			#ifdef CONFIG_DEBUG
+				qDebug("qxgeditMidiDevice::InputSysex: %d:%d: "
+					"SysEx overflow (more than %d bytes).",
+					slot->client, slot->port, int(MaxSize));
+			#endif
+				slot->skip = true;
+			} else {
+				::memcpy(slot->data + slot->size, data, len);
+				slot->size += len;
+			}
+		}
+
+		if (!bEnd)
+			return false;
+
+		const bool bReady = !slot->skip;
+		if (bReady) {
+			// The buffer stays valid until the next call...
+			m_ev = *ev;
+			m_ev.data.ext.ptr = slot->data;
+			m_ev.data.ext.len = slot->size;
+		}
+
+		release(slot);
+
+		return bReady;
+	}
+
+	// Complete message event (valid after process() returns true).
+	snd_seq_event_t *event()
+		{ return &m_ev; }
+
+protected:
+
+	// Per source port state.
+	struct Slot
+	{
+		int client;
+		int port;
+		bool busy;
+		bool skip;
+		unsigned int size;
+		unsigned char *data;
+	};
+
+	// Slot finder (in progress only).
+	Slot *find ( int client, int port )
+	{
+		for (int i = 0; i < MaxSources; ++i) {
+			Slot *slot = &m_slots[i];
+			if (slot->busy && slot->client == client && slot->port == port)
+				return slot;
+		}
+		return nullptr;
+	}
+
+	// Slot allocator (evicts round-robin when all busy).
+	Slot *acquire ( int client, int port )
+	{
+		Slot *slot = nullptr;
+		for (int i = 0; i < MaxSources && slot == nullptr; ++i) {
+			if (!m_slots[i].busy)
+				slot = &m_slots[i];
+		}
+		if (slot == nullptr) {
+			slot = &m_slots[m_iEvict];
+			m_iEvict = (m_iEvict + 1) % MaxSources;
+		}
+		slot->client = client;
+		slot->port   = port;
+		slot->busy   = true;
+		slot->skip   = false;
+		slot->size   = 0;
+		return slot;
+	}
+
+	// Slot release.
+	void release ( Slot *slot )
+	{
+		slot->busy = false;
+		slot->skip = false;
+		slot->size = 0;
+	}
+
+private:
+
+	// Instance variables.
+	Slot m_slots[MaxSources];
+	int  m_iEvict;
+
+	snd_seq_event_t m_ev;
+};
+
+
 //----------------------------------------------------------------------
 // class qxgeditMidiDevice::Impl::InputThread -- MIDI input thread (singleton).
 //
@@ -231,6 +505,7 @@ protected:
 		snd_seq_poll_descriptors(pAlsaSeq, pfds, nfds, POLLIN);
 
 		InputRpn xrpn;
+		InputSysex xsysex;
 
 		m_bRunState = true;
 
@@ -246,8 +521,14 @@ protected:
 				snd_seq_event_input(pAlsaSeq, &pEv);
 				// Process input event - ...
 				// - enqueue to input track mapping;
-				if (!xrpn.process(pEv))
-					m_pImpl->capture(pEv);
+				if (!xrpn.process(pEv)) {
+					// - reassemble fragmented SysEx, if any;
+					if (pEv->type != SND_SEQ_EVENT_SYSEX)
+						m_pImpl->capture(pEv);
+					else
+					if (xsysex.process(pEv))
+						m_pImpl->capture(xsysex.event());
+				}
 			//	snd_seq_free_event(pEv);
 				iPoll = snd_seq_event_input_pending(pAlsaSeq, 0);
 			}
@@ -272,6 +553,87 @@ private:
 #endif	// CONFIG_ALSA_MIDI
 
 
+//----------------------------------------------------------------------
+// class qxgeditMidiDevice::Impl::OutputThread -- MIDI output thread.
+//
+// Each device owns its own output queue and thread, so that
+// several modules may be fed in parallel, without blocking
+// the caller (GUI) thread on a slow or busy port.
+
+class qxgeditMidiDevice::Impl::OutputThread : public QThread
+{
+public:
+
+	// Constructor.
+	OutputThread(Impl *pImpl)
+		: QThread(), m_pImpl(pImpl), m_bRunState(true) {}
+
+	// Run-state accessors.
+	void setRunState(bool bRunState)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_bRunState = bRunState;
+		m_cond.wakeAll();
+	}
+
+	bool runState() const
+		{ return m_bRunState; }
+
+	// Enqueue a SysEx (or short) message.
+	void enqueue(const QByteArray& midi)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_queue.append(midi);
+		m_cond.wakeAll();
+		qxgeditAlloc::acquire(qxgeditAlloc::MidiBuffer, midi.size());
+	}
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		m_mutex.lock();
+		// Drain all that's left, even when stopping...
+		while (m_bRunState || !m_queue.isEmpty()) {
+			if (m_queue.isEmpty()) {
+				m_cond.wait(&m_mutex);
+				continue;
+			}
+			const QList<QByteArray> queue = m_queue;
+			m_queue.clear();
+			m_mutex.unlock();
+			QListIterator<QByteArray> iter(queue);
+			while (iter.hasNext()) {
+				const QByteArray& midi = iter.next();
+				m_pImpl->outputMidi(
+					(unsigned char *) midi.data(),
+					(unsigned short) midi.length());
+				qxgeditAlloc::release(qxgeditAlloc::MidiBuffer, midi.size());
+			}
+			// One drain for the whole batch...
+			m_pImpl->outputFlush();
+			m_mutex.lock();
+		}
+		m_mutex.unlock();
+	}
+
+private:
+
+	// The thread launcher engine.
+	qxgeditMidiDevice::Impl *m_pImpl;
+
+	// Whether the thread is logically running.
+	bool m_bRunState;
+
+	// Pending output queue.
+	QList<QByteArray> m_queue;
+
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
 //----------------------------------------------------------------------------
 // qxgeditMidiDevice::Impl -- MIDI Device interface object.
 
@@ -324,6 +686,10 @@ qxgeditMidiDevice::Impl::Impl (
 {
 	m_pMidiDevice = pMidiDevice;
 
+	m_pOutputThread = nullptr;
+
+	m_iOutputRate.store(0);
+
 #ifdef CONFIG_ALSA_MIDI
 
 	m_pAlsaSeq     = nullptr;
@@ -331,8 +697,18 @@ qxgeditMidiDevice::Impl::Impl (
 	m_iAlsaInPort  = -1;
 	m_iAlsaOutPort = -1;
 
+	m_pAlsaEncoder = nullptr;
+
+	m_iAlsaQueue = -1;
+	m_bAlsaQueue = false;
+	m_bAlsaQueueSync = true;
+	m_alsaQueueTime.tv_sec  = 0;
+	m_alsaQueueTime.tv_nsec = 0;
+
 	m_pInputThread = nullptr;
 
+	m_pMidiPorts = nullptr;
+
 	// Open new ALSA sequencer client...
 	if (snd_seq_open(&m_pAlsaSeq, "hw", SND_SEQ_OPEN_DUPLEX, 0) >= 0) {
 		// Set client identification...
@@ -345,9 +721,17 @@ qxgeditMidiDevice::Impl::Impl (
 		m_iAlsaOutPort = snd_seq_create_simple_port(m_pAlsaSeq, "out",
 			SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ,
 			SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+		// Short messages encoder...
+		snd_midi_event_new(4, &m_pAlsaEncoder);
+		// Output pacing queue (started on demand)...
+		m_iAlsaQueue = snd_seq_alloc_queue(m_pAlsaSeq);
+		// Room for a few bulk transfers worth of events...
+		snd_seq_set_output_buffer_size(m_pAlsaSeq, c_iAlsaOutputBufferSize);
 		// Create and start our own MIDI input queue thread...
 		m_pInputThread = new InputThread(this);
 		m_pInputThread->start(QThread::TimeCriticalPriority);
+		// Shared port registry (started in the background, once)...
+		m_pMidiPorts = qxgeditMidiPorts::attach(sClientName + " Ports");
 	}
 
 #endif	// CONFIG_ALSA_MIDI
@@ -379,6 +763,10 @@ qxgeditMidiDevice::Impl::Impl (
 	}
 
 #endif	// CONFIG_RTMIDI
+
+	// Create and start our own MIDI output queue thread...
+	m_pOutputThread = new OutputThread(this);
+	m_pOutputThread->start(QThread::HighPriority);
 }
 
 
@@ -387,8 +775,24 @@ qxgeditMidiDevice::Impl::~Impl (void)
 	// Reset pseudo-singleton reference.
 	m_pMidiDevice = nullptr;
 
+	// Flush and delete output thread first...
+	if (m_pOutputThread) {
+		if (m_pOutputThread->isRunning()) {
+			m_pOutputThread->setRunState(false);
+			m_pOutputThread->wait();
+		}
+		delete m_pOutputThread;
+		m_pOutputThread = nullptr;
+	}
+
 #ifdef CONFIG_ALSA_MIDI
 
+	// Release shared port registry...
+	if (m_pMidiPorts) {
+		qxgeditMidiPorts::detach();
+		m_pMidiPorts = nullptr;
+	}
+
 	// Last but not least, delete input thread...
 	if (m_pInputThread) {
 		// Try to terminate executive thread,
@@ -402,7 +806,16 @@ qxgeditMidiDevice::Impl::~Impl (void)
 		m_pInputThread = nullptr;
 	}
 
+	if (m_pAlsaEncoder) {
+		snd_midi_event_free(m_pAlsaEncoder);
+		m_pAlsaEncoder = nullptr;
+	}
+
 	if (m_pAlsaSeq) {
+		if (m_iAlsaQueue >= 0) {
+			snd_seq_free_queue(m_pAlsaSeq, m_iAlsaQueue);
+			m_iAlsaQueue = -1;
+		}
 		snd_seq_delete_simple_port(m_pAlsaSeq, m_iAlsaInPort);
 		m_iAlsaInPort = -1;
 		snd_seq_delete_simple_port(m_pAlsaSeq, m_iAlsaOutPort);
@@ -432,6 +845,144 @@ snd_seq_t *qxgeditMidiDevice::Impl::alsaSeq (void) const
 }
 
 
+// ALSA sequencer event output (buffered, until outputFlush).
+void qxgeditMidiDevice::Impl::outputEvent (
+	snd_seq_event_t *pEv, unsigned int iBytes ) const
+{
+	// Addressing...
+	snd_seq_ev_set_source(pEv, m_iAlsaOutPort);
+	snd_seq_ev_set_subs(pEv);
+
+	const unsigned int iRate = m_iOutputRate.load();
+	if (iRate > 0 && m_iAlsaQueue >= 0) {
+		// Paced: timestamped on our own queue, back to back...
+		if (!m_bAlsaQueue) {
+			snd_seq_start_queue(m_pAlsaSeq, m_iAlsaQueue, nullptr);
+			snd_seq_drain_output(m_pAlsaSeq);
+			m_bAlsaQueue = true;
+		}
+		if (m_bAlsaQueueSync) {
+			// Never schedule behind the queue current time...
+			snd_seq_queue_status_t *pQueueStatus;
+			snd_seq_queue_status_alloca(&pQueueStatus);
+			if (snd_seq_get_queue_status(
+					m_pAlsaSeq, m_iAlsaQueue, pQueueStatus) >= 0) {
+				const snd_seq_real_time_t *pNow
+					= snd_seq_queue_status_get_real_time(pQueueStatus);
+				if (pNow->tv_sec > m_alsaQueueTime.tv_sec
+					|| (pNow->tv_sec == m_alsaQueueTime.tv_sec
+						&& pNow->tv_nsec > m_alsaQueueTime.tv_nsec))
+					m_alsaQueueTime = *pNow;
+			}
+			m_bAlsaQueueSync = false;
+		}
+		snd_seq_ev_schedule_real(pEv, m_iAlsaQueue, 0, &m_alsaQueueTime);
+		// Next one goes after this one's worth of wire time...
+		const unsigned long long nsecs
+			= m_alsaQueueTime.tv_nsec + (1000000000ULL * iBytes) / iRate;
+		m_alsaQueueTime.tv_sec  += (unsigned int) (nsecs / 1000000000ULL);
+		m_alsaQueueTime.tv_nsec  = (unsigned int) (nsecs % 1000000000ULL);
+	} else {
+		// The event will be direct...
+		snd_seq_ev_set_direct(pEv);
+	}
+
+	// Buffered; drains by itself only when the buffer fills up...
+	if (snd_seq_event_output(m_pAlsaSeq, pEv) < 0) {
+		snd_seq_drain_output(m_pAlsaSeq);
+		snd_seq_event_output(m_pAlsaSeq, pEv);
+	}
+}
+
+
+// MIDI traffic tap helper (channel events, back into MIDI bytes).
+static void capture_tap (
+	qxgeditMidiDevice::Tap *pTap, const snd_seq_event_t *pEv )
+{
+	unsigned char data[12];
+	unsigned int n = 0;
+
+	const unsigned char ch = (pEv->data.control.channel & 0x0f);
+	const int value = pEv->data.control.value;
+	unsigned char status = 0x00;
+	unsigned char msb = 0x63;	// NRPN MSB
+	unsigned char lsb = 0x62;	// NRPN LSB
+
+	switch (pEv->type) {
+	case SND_SEQ_EVENT_NOTEOFF:
+		status = 0x80;
+		break;
+	case SND_SEQ_EVENT_NOTEON:
+		status = 0x90;
+		break;
+	case SND_SEQ_EVENT_KEYPRESS:
+		status = 0xa0;
+		break;
+	case SND_SEQ_EVENT_CONTROLLER:
+		data[n++] = 0xb0 | ch;
+		data[n++] = pEv->data.control.param & 0x7f;
+		data[n++] = value & 0x7f;
+		break;
+	case SND_SEQ_EVENT_PGMCHANGE:
+		data[n++] = 0xc0 | ch;
+		data[n++] = value & 0x7f;
+		break;
+	case SND_SEQ_EVENT_CHANPRESS:
+		data[n++] = 0xd0 | ch;
+		data[n++] = value & 0x7f;
+		break;
+	case SND_SEQ_EVENT_PITCHBEND:
+		data[n++] = 0xe0 | ch;
+		data[n++] = (value + 0x2000) & 0x7f;
+		data[n++] = ((value + 0x2000) >> 7) & 0x7f;
+		break;
+	case SND_SEQ_EVENT_CONTROL14:
+		data[n++] = 0xb0 | ch;
+		data[n++] = pEv->data.control.param & 0x1f;
+		data[n++] = (value >> 7) & 0x7f;
+		data[n++] = 0xb0 | ch;
+		data[n++] = (pEv->data.control.param & 0x1f) + 0x20;
+		data[n++] = value & 0x7f;
+		break;
+	case SND_SEQ_EVENT_REGPARAM:
+		msb = 0x65;	// RPN MSB
+		lsb = 0x64;	// RPN LSB
+		// Fall thru...
+	case SND_SEQ_EVENT_NONREGPARAM:
+		data[n++] = 0xb0 | ch;
+		data[n++] = msb;
+		data[n++] = (pEv->data.control.param >> 7) & 0x7f;
+		data[n++] = 0xb0 | ch;
+		data[n++] = lsb;
+		data[n++] = pEv->data.control.param & 0x7f;
+		// Data entry: MSB only, unless it really takes 14bit...
+		data[n++] = 0xb0 | ch;
+		data[n++] = 0x06;
+		if (value < 0x80) {
+			data[n++] = value & 0x7f;
+		} else {
+			data[n++] = (value >> 7) & 0x7f;
+			data[n++] = 0xb0 | ch;
+			data[n++] = 0x26;
+			data[n++] = value & 0x7f;
+		}
+		break;
+	default:
+		break;
+	}
+
+	// Note events...
+	if (status) {
+		data[n++] = status | (pEv->data.note.channel & 0x0f);
+		data[n++] = pEv->data.note.note & 0x7f;
+		data[n++] = pEv->data.note.velocity & 0x7f;
+	}
+
+	if (n > 0)
+		pTap->midiIn(data, n);
+}
+
+
 // MIDI event capture method.
 void qxgeditMidiDevice::Impl::capture ( snd_seq_event_t *pEv )
 {
@@ -439,6 +990,8 @@ void qxgeditMidiDevice::Impl::capture ( snd_seq_event_t *pEv )
 	if (pEv->dest.port != m_iAlsaInPort)
 		return;
 
+	QXGEDIT_TRACE("qxgeditMidiDevice::capture");
+
 #ifdef CONFIG_DEBUG
 	// - show event for debug purposes...
 	::fprintf(stderr, "MIDI In  0x%02x", pEv->type);
@@ -455,6 +1008,39 @@ void qxgeditMidiDevice::Impl::capture ( snd_seq_event_t *pEv )
 	}
 #endif
 
+	// MIDI traffic tap...
+	{
+		const qxgeditMidiTapUser user(m_pMidiDevice);
+		qxgeditMidiDevice::Tap *pTap = user.tap();
+		if (pTap) {
+			if (pEv->type == SND_SEQ_EVENT_SYSEX)
+				pTap->midiIn((unsigned char *) pEv->data.ext.ptr, pEv->data.ext.len);
+			else
+				capture_tap(pTap, pEv);
+		}
+	}
+
+	// MIDI Learn controller mapping, first...
+	qxgeditMidiLearn *pMidiLearn = m_pMidiDevice->midiLearn();
+	if (pMidiLearn) {
+		if (pEv->type == SND_SEQ_EVENT_CONTROLLER
+			&& pMidiLearn->process(
+				pEv->data.control.channel, qxgeditMidiLearn::CC,
+				pEv->data.control.param, pEv->data.control.value, false))
+			return;
+		if (pEv->type == SND_SEQ_EVENT_CONTROL14
+			&& pMidiLearn->process(
+				pEv->data.control.channel, qxgeditMidiLearn::CC,
+				pEv->data.control.param, pEv->data.control.value, true))
+			return;
+		// ALSA sequencer (N)RPN values are always 14bit (MSB+LSB)...
+		if (pEv->type == SND_SEQ_EVENT_NONREGPARAM
+			&& pMidiLearn->process(
+				pEv->data.control.channel, qxgeditMidiLearn::NRPN,
+				pEv->data.control.param, pEv->data.control.value, true))
+			return;
+	}
+
 	switch (pEv->type) {
 	case SND_SEQ_EVENT_REGPARAM:
 		// Post RPN event...
@@ -471,6 +1057,10 @@ void qxgeditMidiDevice::Impl::capture ( snd_seq_event_t *pEv )
 			pEv->data.control.value);
 		break;
 	case SND_SEQ_EVENT_SYSEX:
+		// Commit in place, if we may...
+		if (commit((const unsigned char *) pEv->data.ext.ptr,
+				pEv->data.ext.len))
+			break;
 		// Post SysEx event...
 		m_pMidiDevice->emitReceiveSysex(
 			QByteArray(
@@ -498,13 +1088,37 @@ RtMidiOut *qxgeditMidiDevice::Impl::midiOut (void) const
 	return m_pMidiOut;
 }
 
+#endif	// CONFIG_RTMIDI
 
-// MIDI event capture method.
+
+// Concurrent model commit (SysEx only).
+bool qxgeditMidiDevice::Impl::commit (
+	const unsigned char *pSysex, unsigned int iSysex )
+{
+	qxgeditMidiDevice::Committer *pCommitter
+		= (m_pMidiDevice ? m_pMidiDevice->committer() : nullptr);
+	if (pCommitter == nullptr)
+		return false;
+
+	bool bNotify = false;
+	if (!pCommitter->commitSysex(pSysex, iSysex, bNotify))
+		return false;
+
+	if (bNotify)
+		m_pMidiDevice->emitReceiveCommit();
+
+	return true;
+}
+
+
+// MIDI event capture method (complete messages).
 void qxgeditMidiDevice::Impl::capture ( const QByteArray& midi )
 {
 	if (midi.size() < 3)
 		return;
 
+	QXGEDIT_TRACE("qxgeditMidiDevice::capture");
+
 	const int status = (midi.at(0) & 0xf0);
 
 #ifdef CONFIG_DEBUG
@@ -523,11 +1137,21 @@ void qxgeditMidiDevice::Impl::capture ( const QByteArray& midi )
 	}
 #endif
 
-	// Post SysEx event...
+	// MIDI traffic tap...
+	{
+		const qxgeditMidiTapUser user(m_pMidiDevice);
+		qxgeditMidiDevice::Tap *pTap = user.tap();
+		if (pTap)
+			pTap->midiIn((const unsigned char *) midi.data(), midi.size());
+	}
+
+	// Commit in place or post SysEx event...
 	if (status == 0xf0) {
-		m_pMidiDevice->emitReceiveSysex(midi);
+		if (!commit((const unsigned char *) midi.data(), midi.size()))
+			m_pMidiDevice->emitReceiveSysex(midi);
 		m_xrpn.flush();
 	} else {
+		qxgeditMidiLearn *pMidiLearn = m_pMidiDevice->midiLearn();
 		qxgeditMidiRpn::Event event;
 		if (status == 0xb0) {
 			event.time   = 0;
@@ -535,20 +1159,36 @@ void qxgeditMidiDevice::Impl::capture ( const QByteArray& midi )
 			event.status = qxgeditMidiRpn::CC | (midi.at(0) & 0x0f);
 			event.param  = midi.at(1) & 0x7f;
 			event.value  = midi.at(2) & 0x7f;
-			m_xrpn.process(event);
+			if (!m_xrpn.process(event) && pMidiLearn)
+				pMidiLearn->process(event.status & 0x0f,
+					qxgeditMidiLearn::CC, event.param, event.value, false);
 		}
 		else
 		while (m_xrpn.dequeue(event)) {
-			const unsigned char channel = (event.status & 0xf0);
+			const unsigned char channel = (event.status & 0x0f);
 			switch (qxgeditMidiRpn::Type(event.status & 0x70)) {
 			case qxgeditMidiRpn::RPN:
 				m_pMidiDevice->emitReceiveRpn(channel, event.param, event.value);
 				break;
 			case qxgeditMidiRpn::NRPN:
+				// Only ever dequeued once both data entry MSB and
+				// LSB arrived (14bit); 7bit ones go out as plain CC...
+				if (pMidiLearn && pMidiLearn->process(channel,
+						qxgeditMidiLearn::NRPN, event.param, event.value, true))
+					break;
 				m_pMidiDevice->emitReceiveNrpn(channel, event.param, event.value);
 				break;
 			case qxgeditMidiRpn::CC:
+				if (pMidiLearn)
+					pMidiLearn->process(channel,
+						qxgeditMidiLearn::CC, event.param, event.value, false);
+				break;
 			case qxgeditMidiRpn::CC14:
+				// 14bit controller (MSB+LSB pair)...
+				if (pMidiLearn)
+					pMidiLearn->process(channel,
+						qxgeditMidiLearn::CC, event.param, event.value, true);
+				break;
 			default:
 				break;
 			}
@@ -556,8 +1196,6 @@ void qxgeditMidiDevice::Impl::capture ( const QByteArray& midi )
 	}
 }
 
-#endif	// CONFIG_RTMIDI
-
 
 void qxgeditMidiDevice::Impl::sendSysex ( const QByteArray& sysex ) const
 {
@@ -576,6 +1214,46 @@ void qxgeditMidiDevice::Impl::sendSysex (
 	fprintf(stderr, " }\n");
 #endif
 
+	// Defer to the output thread, if any...
+	if (m_pOutputThread && m_pOutputThread->isRunning()) {
+		m_pOutputThread->enqueue(QByteArray((const char *) pSysex, iSysex));
+		return;
+	}
+
+	outputSysex(pSysex, iSysex);
+	outputFlush();
+}
+
+
+// MIDI (complete short messages or SysEx) sender.
+void qxgeditMidiDevice::Impl::sendMidi ( const QByteArray& midi ) const
+{
+	if (midi.isEmpty())
+		return;
+
+	// Defer to the output thread, if any...
+	if (m_pOutputThread && m_pOutputThread->isRunning()) {
+		m_pOutputThread->enqueue(midi);
+		return;
+	}
+
+	outputMidi((unsigned char *) midi.data(), (unsigned short) midi.length());
+	outputFlush();
+}
+
+
+// MIDI SysEx output (actual, from the output thread).
+void qxgeditMidiDevice::Impl::outputSysex (
+	unsigned char *pSysex, unsigned short iSysex ) const
+{
+	// MIDI traffic tap...
+	{
+		const qxgeditMidiTapUser user(m_pMidiDevice);
+		qxgeditMidiDevice::Tap *pTap = user.tap();
+		if (pTap)
+			pTap->midiOut(pSysex, iSysex);
+	}
+
 #ifdef CONFIG_ALSA_MIDI
 
 	// Don't do anything else if engine
@@ -587,17 +1265,10 @@ void qxgeditMidiDevice::Impl::sendSysex (
 	snd_seq_event_t ev;
 	snd_seq_ev_clear(&ev);
 
-	// Addressing...
-	snd_seq_ev_set_source(&ev, m_iAlsaOutPort);
-	snd_seq_ev_set_subs(&ev);
-
-	// The event will be direct...
-	snd_seq_ev_set_direct(&ev);
-
 	// Just set SYSEX stuff and send it out..
 	ev.type = SND_SEQ_EVENT_SYSEX;
 	snd_seq_ev_set_sysex(&ev, iSysex, pSysex);
-	snd_seq_event_output_direct(m_pAlsaSeq, &ev);
+	outputEvent(&ev, iSysex);
 
 #endif	// CONFIG_ALSA_MIDI
 
@@ -610,53 +1281,104 @@ void qxgeditMidiDevice::Impl::sendSysex (
 }
 
 
-// MIDI Input(readable) / Output(writable) device list.
-static const char *c_pszItemSep = " / ";
-
-QStringList qxgeditMidiDevice::Impl::deviceList ( bool bReadable ) const
+// MIDI output (actual, from the output thread).
+void qxgeditMidiDevice::Impl::outputMidi (
+	unsigned char *pMidi, unsigned short iMidi ) const
 {
-	QStringList list;
+	// SysEx goes as it's always been...
+	if (iMidi < 1 || pMidi[0] == 0xf0) {
+		outputSysex(pMidi, iMidi);
+		return;
+	}
+
+#ifdef CONFIG_DEBUG
+	fprintf(stderr, "qxgeditMidiDevice::outputMidi(%p, %u)", pMidi, iMidi);
+	fprintf(stderr, " midi {");
+	for (unsigned short i = 0; i < iMidi; ++i)
+		fprintf(stderr, " %02x", pMidi[i]);
+	fprintf(stderr, " }\n");
+#endif
+
+	// MIDI traffic tap...
+	{
+		const qxgeditMidiTapUser user(m_pMidiDevice);
+		qxgeditMidiDevice::Tap *pTap = user.tap();
+		if (pTap)
+			pTap->midiOut(pMidi, iMidi);
+	}
 
 #ifdef CONFIG_ALSA_MIDI
 
-	if (m_pAlsaSeq == nullptr)
-		return list;
+	// Don't do anything else if engine
+	// has not been activated...
+	if (m_pAlsaSeq == nullptr || m_pAlsaEncoder == nullptr)
+		return;
 
-	unsigned int uiPortFlags;
-	if (bReadable)
-		uiPortFlags = SND_SEQ_PORT_CAP_READ  | SND_SEQ_PORT_CAP_SUBS_READ;
-	else
-		uiPortFlags = SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE;
-
-	snd_seq_client_info_t *pClientInfo;
-	snd_seq_port_info_t   *pPortInfo;
-
-	snd_seq_client_info_alloca(&pClientInfo);
-	snd_seq_port_info_alloca(&pPortInfo);
-	snd_seq_client_info_set_client(pClientInfo, -1);
-
-	while (snd_seq_query_next_client(m_pAlsaSeq, pClientInfo) >= 0) {
-		int iAlsaClient = snd_seq_client_info_get_client(pClientInfo);
-		if (iAlsaClient > 0 && iAlsaClient != m_iAlsaClient) {
-			snd_seq_port_info_set_client(pPortInfo, iAlsaClient);
-			snd_seq_port_info_set_port(pPortInfo, -1);
-			while (snd_seq_query_next_port(m_pAlsaSeq, pPortInfo) >= 0) {
-				unsigned int uiPortCapability
-					= snd_seq_port_info_get_capability(pPortInfo);
-				if (((uiPortCapability & uiPortFlags) == uiPortFlags) &&
-					((uiPortCapability & SND_SEQ_PORT_CAP_NO_EXPORT) == 0)) {
-					int iAlsaPort = snd_seq_port_info_get_port(pPortInfo);
-					QString sItem = QString::number(iAlsaClient) + ':';
-					sItem += snd_seq_client_info_get_name(pClientInfo);
-					sItem += c_pszItemSep;
-					sItem += QString::number(iAlsaPort) + ':';
-					sItem += snd_seq_port_info_get_name(pPortInfo);
-					list.append(sItem);
-				}
-			}
+	snd_midi_event_reset_encode(m_pAlsaEncoder);
+
+	unsigned short i = 0;
+	while (i < iMidi) {
+		// Initialize sequencer event...
+		snd_seq_event_t ev;
+		snd_seq_ev_clear(&ev);
+		const long n = snd_midi_event_encode(
+			m_pAlsaEncoder, pMidi + i, iMidi - i, &ev);
+		if (n < 1)
+			break;
+		i += n;
+		if (ev.type == SND_SEQ_EVENT_NONE)
+			continue;
+		outputEvent(&ev, n);
+	}
+
+#endif	// CONFIG_ALSA_MIDI
+
+#ifdef CONFIG_RTMIDI
+
+	if (m_pMidiOut && m_pMidiOut->isPortOpen()) {
+		// One complete message at a time...
+		unsigned short i = 0;
+		while (i < iMidi) {
+			unsigned short j = i + 1;
+			while (j < iMidi && (pMidi[j] & 0x80) == 0)
+				++j;
+			m_pMidiOut->sendMessage(pMidi + i, j - i);
+			i = j;
 		}
 	}
 
+#endif	// CONFIG_RTMIDI
+}
+
+
+// MIDI output flush (once per batch, from the output thread).
+void qxgeditMidiDevice::Impl::outputFlush (void) const
+{
+#ifdef CONFIG_ALSA_MIDI
+
+	if (m_pAlsaSeq == nullptr)
+		return;
+
+	snd_seq_drain_output(m_pAlsaSeq);
+
+	// Re-sync pacing with the queue on next batch...
+	m_bAlsaQueueSync = true;
+
+#endif	// CONFIG_ALSA_MIDI
+}
+
+
+// MIDI Input(readable) / Output(writable) device list.
+QStringList qxgeditMidiDevice::Impl::deviceList ( bool bReadable ) const
+{
+	QStringList list;
+
+#ifdef CONFIG_ALSA_MIDI
+
+	// From the port registry cache, but ourselves...
+	if (m_pAlsaSeq && m_pMidiPorts)
+		list = m_pMidiPorts->list(bReadable, m_iAlsaClient);
+
 #endif	// CONFIG_ALSA_MIDI
 
 #ifdef CONFIG_RTMIDI
@@ -683,81 +1405,26 @@ QStringList qxgeditMidiDevice::Impl::deviceList ( bool bReadable ) const
 
 // MIDI Input(readable) / Output(writable) device connects.
 bool qxgeditMidiDevice::Impl::connectDeviceList (
-	bool bReadable, const QStringList& list ) const
+	bool bReadable, const QStringList& list )
 {
-	if (list.isEmpty())
-		return false;
-
-	int iConnects = 0;
-
 #ifdef CONFIG_ALSA_MIDI
 
-	if (m_pAlsaSeq == nullptr)
-		return false;
+	// Keep these for reconnecting later...
+	if (bReadable)
+		m_alsaInputs = list;
+	else
+		m_alsaOutputs = list;
 
-	snd_seq_addr_t seq_addr;
-	snd_seq_port_subscribe_t *pPortSubs;
+#endif
 
-	snd_seq_port_subscribe_alloca(&pPortSubs);
+	if (list.isEmpty())
+		return false;
 
-	snd_seq_client_info_t *pClientInfo;
-	snd_seq_port_info_t   *pPortInfo;
+	int iConnects = 0;
 
-	snd_seq_client_info_alloca(&pClientInfo);
-	snd_seq_port_info_alloca(&pPortInfo);
+#ifdef CONFIG_ALSA_MIDI
 
-	unsigned int uiPortFlags;
-	if (bReadable)
-		uiPortFlags = SND_SEQ_PORT_CAP_READ  | SND_SEQ_PORT_CAP_SUBS_READ;
-	else
-		uiPortFlags = SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE;
-
-	while (snd_seq_query_next_client(m_pAlsaSeq, pClientInfo) >= 0) {
-		int iAlsaClient = snd_seq_client_info_get_client(pClientInfo);
-		if (iAlsaClient > 0 && iAlsaClient != m_iAlsaClient) {
-			QString sClientName = snd_seq_client_info_get_name(pClientInfo);
-			snd_seq_port_info_set_client(pPortInfo, iAlsaClient);
-			snd_seq_port_info_set_port(pPortInfo, -1);
-			while (snd_seq_query_next_port(m_pAlsaSeq, pPortInfo) >= 0) {
-				unsigned int uiPortCapability
-					= snd_seq_port_info_get_capability(pPortInfo);
-				if (((uiPortCapability & uiPortFlags) == uiPortFlags) &&
-					((uiPortCapability & SND_SEQ_PORT_CAP_NO_EXPORT) == 0)) {
-					int iAlsaPort = snd_seq_port_info_get_port(pPortInfo);
-					QString sPortName = snd_seq_port_info_get_name(pPortInfo);
-					QStringListIterator iter(list);
-					while (iter.hasNext()) {
-						const QString& sItem = iter.next();
-						const QString& sClientItem
-							= sItem.section(c_pszItemSep, 0, 0);
-						const QString& sPortItem
-							= sItem.section(c_pszItemSep, 1, 1);
-						if (sClientName != sClientItem.section(':', 1, 1))
-							continue;
-						if (sPortName != sPortItem.section(':', 1, 1))
-							continue;
-						if (bReadable) {
-							seq_addr.client = iAlsaClient;
-							seq_addr.port   = iAlsaPort;
-							snd_seq_port_subscribe_set_sender(pPortSubs, &seq_addr);
-							seq_addr.client = m_iAlsaClient;
-							seq_addr.port   = m_iAlsaInPort;
-							snd_seq_port_subscribe_set_dest(pPortSubs, &seq_addr);
-						} else {
-							seq_addr.client = m_iAlsaClient;
-							seq_addr.port   = m_iAlsaOutPort;
-							snd_seq_port_subscribe_set_sender(pPortSubs, &seq_addr);
-							seq_addr.client = iAlsaClient;
-							seq_addr.port   = iAlsaPort;
-							snd_seq_port_subscribe_set_dest(pPortSubs, &seq_addr);
-						}
-						if (snd_seq_subscribe_port(m_pAlsaSeq, pPortSubs) == 0)
-							iConnects++;
-					}
-				}
-			}
-		}
-	}
+	iConnects += subscribeDeviceList(bReadable, list);
 
 #endif	// CONFIG_ALSA_MIDI
 
@@ -798,6 +1465,68 @@ bool qxgeditMidiDevice::Impl::connectDeviceList (
 }
 
 
+#ifdef CONFIG_ALSA_MIDI
+
+// MIDI device subscriptions (by registry lookup).
+int qxgeditMidiDevice::Impl::subscribeDeviceList (
+	bool bReadable, const QStringList& list ) const
+{
+	if (m_pAlsaSeq == nullptr || m_pMidiPorts == nullptr)
+		return 0;
+
+	int iConnects = 0;
+
+	snd_seq_addr_t seq_addr;
+	snd_seq_port_subscribe_t *pPortSubs;
+
+	snd_seq_port_subscribe_alloca(&pPortSubs);
+
+	QStringListIterator iter(list);
+	while (iter.hasNext()) {
+		const QList<qxgeditMidiPorts::Addr>& addrs
+			= m_pMidiPorts->find(iter.next(), bReadable, m_iAlsaClient);
+		QListIterator<qxgeditMidiPorts::Addr> addr_iter(addrs);
+		while (addr_iter.hasNext()) {
+			const qxgeditMidiPorts::Addr& addr = addr_iter.next();
+			if (bReadable) {
+				seq_addr.client = addr.client;
+				seq_addr.port   = addr.port;
+				snd_seq_port_subscribe_set_sender(pPortSubs, &seq_addr);
+				seq_addr.client = m_iAlsaClient;
+				seq_addr.port   = m_iAlsaInPort;
+				snd_seq_port_subscribe_set_dest(pPortSubs, &seq_addr);
+			} else {
+				seq_addr.client = m_iAlsaClient;
+				seq_addr.port   = m_iAlsaOutPort;
+				snd_seq_port_subscribe_set_sender(pPortSubs, &seq_addr);
+				seq_addr.client = addr.client;
+				seq_addr.port   = addr.port;
+				snd_seq_port_subscribe_set_dest(pPortSubs, &seq_addr);
+			}
+			if (snd_seq_subscribe_port(m_pAlsaSeq, pPortSubs) == 0)
+				iConnects++;
+		}
+	}
+
+	return iConnects;
+}
+
+#endif	// CONFIG_ALSA_MIDI
+
+
+// MIDI Input(readable) / Output(writable) reconnects.
+void qxgeditMidiDevice::Impl::reconnect (void)
+{
+#ifdef CONFIG_ALSA_MIDI
+
+	// Already existing subscriptions just fail (busy)...
+	subscribeDeviceList(true,  m_alsaInputs);
+	subscribeDeviceList(false, m_alsaOutputs);
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // qxgeditMidiDevice -- MIDI Device interface object.
 
@@ -806,17 +1535,30 @@ qxgeditMidiDevice *qxgeditMidiDevice::g_pMidiDevice = nullptr;
 
 // Constructor.
 qxgeditMidiDevice::qxgeditMidiDevice ( const QString& sClientName )
-	: QObject(nullptr), m_pImpl(new Impl(this, sClientName))
+	: QObject(nullptr), m_pImpl(nullptr), m_pMidiLearn(nullptr),
+		m_pTap(nullptr), m_iTapUsers(0), m_pCommitter(nullptr)
 {
-	// Set pseudo-singleton reference.
-	g_pMidiDevice = this;
+	m_pImpl = new Impl(this, sClientName);
+
+	// Reconnect on port registry changes (eg. hotplug)...
+	qxgeditMidiPorts *pMidiPorts = qxgeditMidiPorts::getInstance();
+	if (pMidiPorts) {
+		QObject::connect(pMidiPorts,
+			SIGNAL(changed()),
+			SLOT(portsChanged()));
+	}
+
+	// Set pseudo-singleton reference (first one only).
+	if (g_pMidiDevice == nullptr)
+		g_pMidiDevice = this;
 }
 
 
 qxgeditMidiDevice::~qxgeditMidiDevice (void)
 {
 	// Reset pseudo-singleton reference.
-	g_pMidiDevice = nullptr;
+	if (g_pMidiDevice == this)
+		g_pMidiDevice = nullptr;
 
 	delete m_pImpl;
 }
@@ -828,6 +1570,11 @@ qxgeditMidiDevice *qxgeditMidiDevice::getInstance (void)
 	return g_pMidiDevice;
 }
 
+void qxgeditMidiDevice::setInstance ( qxgeditMidiDevice *pMidiDevice )
+{
+	g_pMidiDevice = pMidiDevice;
+}
+
 
 void qxgeditMidiDevice::sendSysex ( const QByteArray& sysex ) const
 {
@@ -842,6 +1589,89 @@ void qxgeditMidiDevice::sendSysex (
 }
 
 
+void qxgeditMidiDevice::sendMidi ( const QByteArray& midi ) const
+{
+	m_pImpl->sendMidi(midi);
+}
+
+
+// MIDI output pacing (bytes per second; 0=direct, unpaced).
+void qxgeditMidiDevice::setOutputRate ( unsigned int iRate )
+{
+	m_pImpl->setOutputRate(iRate);
+}
+
+unsigned int qxgeditMidiDevice::outputRate (void) const
+{
+	return m_pImpl->outputRate();
+}
+
+
+// MIDI Learn controller mapping (input hook).
+void qxgeditMidiDevice::setMidiLearn ( qxgeditMidiLearn *pMidiLearn )
+{
+	m_pMidiLearn = pMidiLearn;
+}
+
+qxgeditMidiLearn *qxgeditMidiDevice::midiLearn (void) const
+{
+	return m_pMidiLearn;
+}
+
+
+// MIDI traffic tap.
+void qxgeditMidiDevice::setTap ( Tap *pTap )
+{
+	m_pTap.fetchAndStoreOrdered(pTap);
+
+	// Wait for any I/O thread still inside the previous one...
+	while (m_iTapUsers.loadAcquire() > 0)
+		QThread::yieldCurrentThread();
+}
+
+qxgeditMidiDevice::Tap *qxgeditMidiDevice::tap (void) const
+{
+	return m_pTap.loadAcquire();
+}
+
+
+// MIDI traffic tap scoped use (I/O threads only).
+qxgeditMidiDevice::Tap *qxgeditMidiDevice::acquireTap (void)
+{
+	m_iTapUsers.ref();
+
+	Tap *pTap = m_pTap.loadAcquire();
+	if (pTap == nullptr)
+		m_iTapUsers.deref();
+
+	return pTap;
+}
+
+void qxgeditMidiDevice::releaseTap (void)
+{
+	m_iTapUsers.deref();
+}
+
+
+// Concurrent model commit.
+void qxgeditMidiDevice::setCommitter ( Committer *pCommitter )
+{
+	m_pCommitter.storeRelease(pCommitter);
+}
+
+qxgeditMidiDevice::Committer *qxgeditMidiDevice::committer (void) const
+{
+	return m_pCommitter.loadAcquire();
+}
+
+
+// MIDI input stand-in.
+void qxgeditMidiDevice::injectMidi ( const QByteArray& midi )
+{
+	m_pImpl->capture(midi);
+}
+
+
 // MIDI Input(readable) / Output(writable) device list
 QStringList qxgeditMidiDevice::inputs (void) const
 {
@@ -866,4 +1696,11 @@ bool qxgeditMidiDevice::connectOutputs ( const QStringList& outputs ) const
 }
 
 
+// Port registry change notification.
+void qxgeditMidiDevice::portsChanged (void)
+{
+	m_pImpl->reconnect();
+}
+
+
 // end of qxgeditMidiDevice.cpp
@@ -26,8 +26,13 @@
 #include <QEvent>
 #include <QByteArray>
 #include <QStringList>
+#include <QAtomicPointer>
+#include <QAtomicInt>
 
 
+// Forward decls.
+class qxgeditMidiLearn;
+
 
 //----------------------------------------------------------------------------
 // qxgeditMidiDevice -- MIDI Device interface object.
@@ -43,13 +48,64 @@ public:
 	// Destructor.
 	~qxgeditMidiDevice();
 
-	// Pseudo-singleton reference.
+	// Pseudo-singleton reference (current device).
 	static qxgeditMidiDevice *getInstance();
+	static void setInstance(qxgeditMidiDevice *pMidiDevice);
 
 	// MIDI SysEx sender.
 	void sendSysex(const QByteArray& sysex) const;
 	void sendSysex(unsigned char *pSysex, unsigned short iSysex) const;
 
+	// MIDI (complete short messages or SysEx) sender.
+	void sendMidi(const QByteArray& midi) const;
+
+	// MIDI output pacing (bytes per second; 0=direct, unpaced).
+	void setOutputRate(unsigned int iRate);
+	unsigned int outputRate() const;
+
+	// MIDI Learn controller mapping (input hook).
+	void setMidiLearn(qxgeditMidiLearn *pMidiLearn);
+	qxgeditMidiLearn *midiLearn() const;
+
+	// MIDI traffic tap interface (called from the I/O threads,
+	// so implementations must never block nor take long).
+	class Tap
+	{
+	public:
+		virtual ~Tap() {}
+		virtual void midiIn(const unsigned char *pMidi, unsigned int iMidi) = 0;
+		virtual void midiOut(const unsigned char *pMidi, unsigned int iMidi) = 0;
+	};
+
+	// MIDI traffic tap (eg. latency harness); the previous one is
+	// guaranteed not in use by any I/O thread once this returns.
+	void setTap(Tap *pTap);
+	Tap *tap() const;
+
+	// MIDI traffic tap scoped use (I/O threads only).
+	Tap *acquireTap();
+	void releaseTap();
+
+	// Concurrent model commit interface (called from the input
+	// thread with complete SysEx messages; returns true when the
+	// message got committed, setting bNotify when a coalesced
+	// receiveCommit() notification is due).
+	class Committer
+	{
+	public:
+		virtual ~Committer() {}
+		virtual bool commitSysex(
+			const unsigned char *pSysex, unsigned int iSysex, bool& bNotify) = 0;
+	};
+
+	// Concurrent model commit (null = post receiveSysex() only).
+	void setCommitter(Committer *pCommitter);
+	Committer *committer() const;
+
+	// MIDI input stand-in: process complete messages as if
+	// received from the input port (any thread, one at a time).
+	void injectMidi(const QByteArray& midi);
+
 	// MIDI Input(readable) / Output(writable) device list
 	QStringList inputs() const;
 	QStringList outputs() const;
@@ -65,6 +121,8 @@ public:
 		{ emit receiveNrpn(ch, nrpn, val); }
 	void emitReceiveSysex(const QByteArray& sysex)
 		{ emit receiveSysex(sysex); }
+	void emitReceiveCommit()
+		{ emit receiveCommit(); }
 
 	// Forward decl.
 	class Impl;
@@ -75,12 +133,28 @@ signals:
 	void receiveRpn(unsigned char ch, unsigned short rpn, unsigned short val);
 	void receiveNrpn(unsigned char ch, unsigned short nrpn, unsigned short val);
 	void receiveSysex(const QByteArray& sysex);
+	void receiveCommit();
+
+protected slots:
+
+	// Port registry change notification (reconnects).
+	void portsChanged();
 
 private:
 
 	// Name says it all.
 	Impl *m_pImpl;
 
+	// MIDI Learn controller mapping.
+	qxgeditMidiLearn *m_pMidiLearn;
+
+	// MIDI traffic tap (and its current I/O thread users).
+	QAtomicPointer<Tap> m_pTap;
+	QAtomicInt m_iTapUsers;
+
+	// Concurrent model commit.
+	QAtomicPointer<Committer> m_pCommitter;
+
 	// Pseudo-singleton reference.
 	static qxgeditMidiDevice *g_pMidiDevice;
 };
@@ -0,0 +1,329 @@
+// qxgeditMidiLearn.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditMidiLearn.h"
+
+#include "qxgeditXGMasterMap.h"
+
+#include <QMetaObject>
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiLearn -- MIDI Learn controller mapping.
+
+// Constructor.
+qxgeditMidiLearn::qxgeditMidiLearn (
+	qxgeditXGMasterMap *pMasterMap, QObject *pParent )
+	: QObject(pParent), m_pMasterMap(pMasterMap),
+		m_pLearnParam(nullptr), m_iLearned(0), m_iPosted(0)
+{
+}
+
+
+// Destructor.
+qxgeditMidiLearn::~qxgeditMidiLearn (void)
+{
+	for (int i = 0; i < 16 * 128; ++i)
+		delete m_nrpn[i].loadAcquire();
+
+	qDeleteAll(m_slots);
+	m_slots.clear();
+}
+
+
+// Learn mode (next incoming controller binds to this).
+void qxgeditMidiLearn::learn ( XGParam *pParam )
+{
+	m_iLearned.storeRelease(0);
+	m_pLearnParam.storeRelease(pParam);
+}
+
+
+void qxgeditMidiLearn::cancel (void)
+{
+	m_pLearnParam.storeRelease(nullptr);
+	m_iLearned.storeRelease(0);
+}
+
+
+XGParam *qxgeditMidiLearn::learnParam (void) const
+{
+	return m_pLearnParam.loadAcquire();
+}
+
+
+// Bindings management (main thread only).
+bool qxgeditMidiLearn::bind ( unsigned char ch, Type type,
+	unsigned short param, XGParam *pParam )
+{
+	if (pParam == nullptr || ch > 15)
+		return false;
+	if (param > (type == NRPN ? 0x3fff : 0x7f))
+		return false;
+
+	// One controller per parameter...
+	unbind(pParam);
+
+	Slot *pSlot = addSlot(ch, type, param);
+
+	// ...and one parameter per controller.
+	XGParam *pOldParam = pSlot->target.loadAcquire();
+	if (pOldParam)
+		m_params.remove(pOldParam);
+
+	pSlot->value.storeRelease(-1);
+	pSlot->target.storeRelease(pParam);
+
+	m_params.insert(pParam, pSlot);
+
+	return true;
+}
+
+
+void qxgeditMidiLearn::unbind ( XGParam *pParam )
+{
+	Slot *pSlot = m_params.take(pParam);
+	if (pSlot)
+		pSlot->target.storeRelease(nullptr);
+}
+
+
+void qxgeditMidiLearn::clear (void)
+{
+	QListIterator<Slot *> iter(m_slots);
+	while (iter.hasNext())
+		iter.next()->target.storeRelease(nullptr);
+
+	m_params.clear();
+}
+
+
+bool qxgeditMidiLearn::isBound ( XGParam *pParam ) const
+{
+	return m_params.contains(pParam);
+}
+
+
+// Binding textual description (eg. "Ch 1 CC 74").
+QString qxgeditMidiLearn::text ( XGParam *pParam ) const
+{
+	Slot *pSlot = m_params.value(pParam, nullptr);
+	if (pSlot == nullptr)
+		return QString();
+
+	return tr("Ch %1 %2 %3")
+		.arg(pSlot->channel + 1)
+		.arg(pSlot->type == NRPN ? "NRPN" : "CC")
+		.arg(pSlot->param);
+}
+
+
+// Bindings persistence.
+QStringList qxgeditMidiLearn::saveBindings (void) const
+{
+	QStringList list;
+
+	QListIterator<Slot *> iter(m_slots);
+	while (iter.hasNext()) {
+		Slot *pSlot = iter.next();
+		XGParam *pParam = pSlot->target.loadAcquire();
+		if (pParam == nullptr)
+			continue;
+		unsigned short etype = 0;
+		if (pParam->high() == 0x02 && pParam->mid() == 0x01
+			&& pParam->low() != 0x00
+			&& pParam->low() != 0x20
+			&& pParam->low() != 0x40)
+			etype = static_cast<XGEffectParam *> (pParam)->etype();
+		// "ch type param high mid low etype"
+		list.append(QString("%1 %2 %3 %4 %5 %6 %7")
+			.arg(pSlot->channel)
+			.arg(int(pSlot->type))
+			.arg(pSlot->param)
+			.arg(pParam->high())
+			.arg(pParam->mid())
+			.arg(pParam->low())
+			.arg(etype));
+	}
+
+	return list;
+}
+
+
+void qxgeditMidiLearn::loadBindings ( const QStringList& list )
+{
+	clear();
+
+	if (m_pMasterMap == nullptr)
+		return;
+
+	QStringListIterator iter(list);
+	while (iter.hasNext()) {
+		const QStringList& fields = iter.next().split(' ');
+		if (fields.count() < 7)
+			continue;
+		XGParam *pParam = m_pMasterMap->find_param(
+			XGParamKey(
+				fields.at(3).toUShort(),
+				fields.at(4).toUShort(),
+				fields.at(5).toUShort()),
+			fields.at(6).toUShort());
+		if (pParam) {
+			bind(fields.at(0).toUShort(),
+				(fields.at(1).toInt() == NRPN ? NRPN : CC),
+				fields.at(2).toUShort(), pParam);
+		}
+	}
+}
+
+
+// Controller input (called from the input thread).
+bool qxgeditMidiLearn::process ( unsigned char ch, Type type,
+	unsigned short param, unsigned short value, bool b14bit )
+{
+	ch &= 0x0f;
+
+	// Learning? grab it...
+	if (m_pLearnParam.loadAcquire()) {
+		m_iLearned.storeRelease(0x1000000
+			| (int(type) << 20) | (int(ch) << 16) | (param & 0x3fff));
+		post();
+		return true;
+	}
+
+	Slot *pSlot = findSlot(ch, type, param);
+	if (pSlot == nullptr || pSlot->target.loadAcquire() == nullptr)
+		return false;
+
+	// Always keep it at full 14bit resolution
+	// (7bit values spread over the whole range)...
+	if (b14bit)
+		value &= 0x3fff;
+	else
+		value = ((value & 0x7f) << 7) | (value & 0x7f);
+
+	// Last one wins...
+	pSlot->value.storeRelease(value);
+	post();
+
+	return true;
+}
+
+
+// Apply pending controller values (main thread).
+void qxgeditMidiLearn::flush (void)
+{
+	m_iPosted.storeRelease(0);
+
+	// Learning completed?
+	const int iLearned = m_iLearned.fetchAndStoreOrdered(0);
+	if (iLearned) {
+		XGParam *pParam = m_pLearnParam.fetchAndStoreOrdered(nullptr);
+		if (pParam && bind(
+				(iLearned >> 16) & 0x0f,
+				((iLearned >> 20) & 1) ? NRPN : CC,
+				iLearned & 0x3fff, pParam))
+			emit learned(pParam);
+	}
+
+	if (m_pMasterMap == nullptr)
+		return;
+
+	// Scale through each parameter range, in one batched update...
+	bool bUpdate = false;
+
+	QListIterator<Slot *> iter(m_slots);
+	while (iter.hasNext()) {
+		Slot *pSlot = iter.next();
+		const int iValue = pSlot->value.fetchAndStoreOrdered(-1);
+		if (iValue < 0)
+			continue;
+		XGParam *pParam = pSlot->target.loadAcquire();
+		if (pParam == nullptr)
+			continue;
+		if (!bUpdate) {
+			m_pMasterMap->begin_update();
+			bUpdate = true;
+		}
+		const int iMin = pParam->min();
+		const int iMax = pParam->max();
+		pParam->set_value(iMin + ((iMax - iMin) * iValue + 8191) / 16383);
+	}
+
+	if (bUpdate)
+		m_pMasterMap->end_update();
+}
+
+
+// Dispatch table lookup (O(1)).
+qxgeditMidiLearn::Slot *qxgeditMidiLearn::findSlot (
+	unsigned char ch, Type type, unsigned short param ) const
+{
+	if (type == NRPN) {
+		Page *pPage = m_nrpn[(ch << 7) | ((param >> 7) & 0x7f)].loadAcquire();
+		return (pPage ? pPage->items[param & 0x7f].loadAcquire() : nullptr);
+	}
+
+	return m_cc[(ch << 7) | (param & 0x7f)].loadAcquire();
+}
+
+
+qxgeditMidiLearn::Slot *qxgeditMidiLearn::addSlot (
+	unsigned char ch, Type type, unsigned short param )
+{
+	Slot *pSlot = findSlot(ch, type, param);
+	if (pSlot)
+		return pSlot;
+
+	pSlot = new Slot();
+	pSlot->channel = ch;
+	pSlot->type    = type;
+	pSlot->param   = param;
+
+	m_slots.append(pSlot);
+
+	// Publish it (the input thread may be looking already)...
+	if (type == NRPN) {
+		QAtomicPointer<Page>& page = m_nrpn[(ch << 7) | ((param >> 7) & 0x7f)];
+		Page *pPage = page.loadAcquire();
+		if (pPage == nullptr) {
+			pPage = new Page();
+			page.storeRelease(pPage);
+		}
+		pPage->items[param & 0x7f].storeRelease(pSlot);
+	} else {
+		m_cc[(ch << 7) | (param & 0x7f)].storeRelease(pSlot);
+	}
+
+	return pSlot;
+}
+
+
+// Schedule a main thread flush, once.
+void qxgeditMidiLearn::post (void)
+{
+	if (m_iPosted.testAndSetOrdered(0, 1))
+		QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+}
+
+
+// end of qxgeditMidiLearn.cpp
@@ -0,0 +1,151 @@
+// qxgeditMidiLearn.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditMidiLearn_h
+#define __qxgeditMidiLearn_h
+
+#include <QObject>
+#include <QAtomicPointer>
+#include <QAtomicInt>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+
+
+// Forward decls.
+class qxgeditXGMasterMap;
+class XGParam;
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiLearn -- MIDI Learn controller mapping.
+//
+// Incoming controllers (CC, NRPN) are looked up in a flat dispatch
+// table, straight from the MIDI input thread; matched values are
+// coalesced (last one wins) and applied in one batched update, from
+// the main (GUI) thread, as soon as its event loop gets to it.
+
+class qxgeditMidiLearn : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditMidiLearn(qxgeditXGMasterMap *pMasterMap, QObject *pParent = nullptr);
+
+	// Destructor.
+	~qxgeditMidiLearn();
+
+	// Controller types.
+	enum Type { CC = 0, NRPN = 1 };
+
+	// Learn mode (next incoming controller binds to this).
+	void learn(XGParam *pParam);
+	void cancel();
+
+	XGParam *learnParam() const;
+
+	// Bindings management (main thread only).
+	bool bind(unsigned char ch, Type type, unsigned short param, XGParam *pParam);
+	void unbind(XGParam *pParam);
+	void clear();
+
+	bool isBound(XGParam *pParam) const;
+
+	// Binding textual description (eg. "Ch 1 CC 74").
+	QString text(XGParam *pParam) const;
+
+	// Bindings persistence.
+	QStringList saveBindings() const;
+	void loadBindings(const QStringList& list);
+
+	// Controller input (called from the input thread);
+	// value resolution is either 7bit or 14bit (MSB+LSB).
+	bool process(unsigned char ch, Type type,
+		unsigned short param, unsigned short value, bool b14bit);
+
+signals:
+
+	// Learn completion notification.
+	void learned(XGParam *pParam);
+
+protected slots:
+
+	// Apply pending controller values (main thread).
+	void flush();
+
+protected:
+
+	// Dispatch slot (one per controller, never freed till the end).
+	struct Slot
+	{
+		Slot() : value(-1), channel(0), type(CC), param(0) {}
+
+		QAtomicPointer<XGParam> target;
+		QAtomicInt value;	// Pending 14bit value (-1=none).
+
+		unsigned char  channel;
+		Type           type;
+		unsigned short param;
+	};
+
+	// NRPN dispatch page (one per channel and NRPN MSB).
+	struct Page
+	{
+		QAtomicPointer<Slot> items[128];
+	};
+
+	// Dispatch table lookup (O(1)).
+	Slot *findSlot(unsigned char ch, Type type, unsigned short param) const;
+	Slot *addSlot(unsigned char ch, Type type, unsigned short param);
+
+	// Schedule a main thread flush, once.
+	void post();
+
+private:
+
+	// Instance variables.
+	qxgeditXGMasterMap *m_pMasterMap;
+
+	// Flat CC dispatch table (16 channels x 128 controllers).
+	QAtomicPointer<Slot> m_cc[16 * 128];
+
+	// NRPN dispatch pages (16 channels x 128 MSB).
+	QAtomicPointer<Page> m_nrpn[16 * 128];
+
+	// All slots and bound parameters (main thread only).
+	QList<Slot *> m_slots;
+	QHash<XGParam *, Slot *> m_params;
+
+	// Learn mode state.
+	QAtomicPointer<XGParam> m_pLearnParam;
+	QAtomicInt m_iLearned;
+
+	// Whether a flush is already pending.
+	QAtomicInt m_iPosted;
+};
+
+
+#endif	// __qxgeditMidiLearn_h
+
+
+// end of qxgeditMidiLearn.h
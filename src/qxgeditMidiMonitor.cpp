@@ -0,0 +1,615 @@
+// qxgeditMidiMonitor.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditMidiMonitor.h"
+
+#include "qxgeditXGMasterMap.h"
+
+#include "XGParamSysex.h"
+
+#include <QIODevice>
+#include <QFontDatabase>
+
+#include <algorithm>
+#include <cstring>
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitor -- MIDI traffic capture (device tap).
+
+// Constructor.
+qxgeditMidiMonitor::qxgeditMidiMonitor (void)
+	: m_slots(new Slot [MaxSlots]), m_tail(0), m_head(0),
+		m_dropped(0), m_pMidiDevice(nullptr)
+{
+	for (unsigned int i = 0; i < MaxSlots; ++i)
+		m_slots[i].seq.store(i, std::memory_order_relaxed);
+
+	m_clock.start();
+}
+
+
+// Destructor.
+qxgeditMidiMonitor::~qxgeditMidiMonitor (void)
+{
+	// Detach first: no I/O thread is left inside us after this...
+	setMidiDevice(nullptr);
+
+	delete [] m_slots;
+}
+
+
+// Device attachment (tap).
+void qxgeditMidiMonitor::setMidiDevice ( qxgeditMidiDevice *pMidiDevice )
+{
+	if (m_pMidiDevice && m_pMidiDevice->tap() == this)
+		m_pMidiDevice->setTap(nullptr);
+
+	m_pMidiDevice = pMidiDevice;
+
+	if (m_pMidiDevice)
+		m_pMidiDevice->setTap(this);
+}
+
+
+qxgeditMidiDevice *qxgeditMidiMonitor::midiDevice (void) const
+{
+	return m_pMidiDevice;
+}
+
+
+// Tap callbacks (I/O threads).
+void qxgeditMidiMonitor::midiIn ( const unsigned char *pMidi, unsigned int iMidi )
+{
+	enqueue(false, pMidi, iMidi);
+}
+
+
+void qxgeditMidiMonitor::midiOut ( const unsigned char *pMidi, unsigned int iMidi )
+{
+	enqueue(true, pMidi, iMidi);
+}
+
+
+// Claim and fill one slot.
+void qxgeditMidiMonitor::enqueue (
+	bool bOut, const unsigned char *pMidi, unsigned int iMidi )
+{
+	if (pMidi == nullptr || iMidi < 1)
+		return;
+
+	Slot *slot = nullptr;
+	unsigned int pos = m_tail.load(std::memory_order_relaxed);
+	for (;;) {
+		slot = &m_slots[pos & (MaxSlots - 1)];
+		const unsigned int seq = slot->seq.load(std::memory_order_acquire);
+		const int diff = int(seq - pos);
+		if (diff == 0) {
+			if (m_tail.compare_exchange_weak(pos, pos + 1,
+					std::memory_order_relaxed))
+				break;
+		}
+		else
+		if (diff < 0) {
+			// Full, drop it...
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else pos = m_tail.load(std::memory_order_relaxed);
+	}
+
+	slot->time = m_clock.nsecsElapsed();
+	slot->out  = bOut;
+	slot->size = iMidi;
+	::memcpy(slot->data, pMidi, (iMidi < MaxData ? iMidi : MaxData));
+
+	slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+
+// Capture pick-up (main thread only).
+bool qxgeditMidiMonitor::dequeue ( qxgeditMidiMonitorEvent& event )
+{
+	Slot *slot = &m_slots[m_head & (MaxSlots - 1)];
+	const unsigned int seq = slot->seq.load(std::memory_order_acquire);
+	if (int(seq - (m_head + 1)) < 0)
+		return false;
+
+	event.time = slot->time;
+	event.out  = slot->out;
+	event.size = slot->size;
+	event.data = QByteArray((const char *) slot->data,
+		int(slot->size < MaxData ? slot->size : MaxData));
+	event.nrpn = -1;
+	event.channel = 0;
+	event.value = 0;
+
+	slot->seq.store(m_head + MaxSlots, std::memory_order_release);
+	++m_head;
+
+	return true;
+}
+
+
+// Dropped messages so far (ring full).
+unsigned int qxgeditMidiMonitor::dropped (void) const
+{
+	return m_dropped.load(std::memory_order_relaxed);
+}
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitorModel -- Captured MIDI traffic (list view model).
+
+// Constructor.
+qxgeditMidiMonitorModel::qxgeditMidiMonitorModel ( QObject *pParent )
+	: QAbstractTableModel(pParent), m_pMasterMap(nullptr),
+		m_direction(AnyDirection), m_kind(AnyKind)
+{
+	for (int i = 0; i < 16; ++i)
+		m_nrpn[0][i] = m_nrpn[1][i] = -1;
+}
+
+
+// Concretizers (virtual).
+int qxgeditMidiMonitorModel::rowCount ( const QModelIndex& parent ) const
+{
+	return (parent.isValid() ? 0 : m_rows.count());
+}
+
+
+int qxgeditMidiMonitorModel::columnCount ( const QModelIndex& parent ) const
+{
+	return (parent.isValid() ? 0 : int(ColumnCount));
+}
+
+
+QVariant qxgeditMidiMonitorModel::headerData (
+	int section, Qt::Orientation orient, int role ) const
+{
+	if (orient == Qt::Horizontal && role == Qt::DisplayRole) {
+		switch (Column(section)) {
+		case Time: return tr("Time");
+		case Port: return tr("Port");
+		case Size: return tr("Size");
+		case Data: return tr("Data");
+		case Text: return tr("Description");
+		default: break;
+		}
+	}
+
+	return QVariant();
+}
+
+
+QVariant qxgeditMidiMonitorModel::data (
+	const QModelIndex& index, int role ) const
+{
+	const int iRow = index.row();
+	if (!index.isValid() || iRow < 0 || iRow >= m_rows.count())
+		return QVariant();
+
+	const qxgeditMidiMonitorEvent& event = m_events.at(m_rows.at(iRow));
+
+	if (role == Qt::DisplayRole) {
+		switch (Column(index.column())) {
+		case Time:
+			return QString::number(double(event.time) / 1e9, 'f', 6);
+		case Port:
+			return (event.out ? tr("Out") : tr("In"));
+		case Size:
+			return event.size;
+		case Data:
+			return dataText(event);
+		case Text:
+			return descriptionText(event);
+		default:
+			break;
+		}
+	}
+	else
+	if (role == Qt::TextAlignmentRole) {
+		if (index.column() == Time || index.column() == Size)
+			return int(Qt::AlignRight | Qt::AlignVCenter);
+	}
+	else
+	if (role == Qt::FontRole) {
+		if (index.column() == Data)
+			return QFontDatabase::systemFont(QFontDatabase::FixedFont);
+	}
+
+	return QVariant();
+}
+
+
+// Parameter name decoding source.
+void qxgeditMidiMonitorModel::setMasterMap ( qxgeditXGMasterMap *pMasterMap )
+{
+	m_pMasterMap = pMasterMap;
+
+	if (!m_rows.isEmpty()) {
+		emit dataChanged(index(0, Text),
+			index(m_rows.count() - 1, Text));
+	}
+}
+
+
+qxgeditXGMasterMap *qxgeditMidiMonitorModel::masterMap (void) const
+{
+	return m_pMasterMap;
+}
+
+
+// Capture pick-up (all pending, in one row insertion).
+int qxgeditMidiMonitorModel::append ( qxgeditMidiMonitor *pMonitor )
+{
+	const int iFirst = m_events.count();
+
+	qxgeditMidiMonitorEvent event;
+	while (pMonitor->dequeue(event)) {
+		resolve(event);
+		m_events.append(event);
+	}
+
+	const int iLast = m_events.count();
+	if (iLast <= iFirst)
+		return 0;
+
+	QVector<int> rows;
+	for (int i = iFirst; i < iLast; ++i) {
+		if (accept(m_events.at(i)))
+			rows.append(i);
+	}
+
+	if (!rows.isEmpty()) {
+		const int iRow = m_rows.count();
+		beginInsertRows(QModelIndex(), iRow, iRow + rows.count() - 1);
+		m_rows += rows;
+		endInsertRows();
+	}
+
+	trim();
+
+	return iLast - iFirst;
+}
+
+
+// Filter settings.
+void qxgeditMidiMonitorModel::setFilter (
+	Direction direction, Kind kind, const QString& sText )
+{
+	beginResetModel();
+
+	m_direction = direction;
+	m_kind = kind;
+	m_sText = sText.simplified();
+
+	m_rows.clear();
+	const int iCount = m_events.count();
+	for (int i = 0; i < iCount; ++i) {
+		if (accept(m_events.at(i)))
+			m_rows.append(i);
+	}
+
+	endResetModel();
+}
+
+
+// History reset.
+void qxgeditMidiMonitorModel::clear (void)
+{
+	beginResetModel();
+
+	m_events.clear();
+	m_rows.clear();
+
+	for (int i = 0; i < 16; ++i)
+		m_nrpn[0][i] = m_nrpn[1][i] = -1;
+
+	endResetModel();
+}
+
+
+// History counters.
+int qxgeditMidiMonitorModel::count (void) const
+{
+	return m_events.count();
+}
+
+
+// Export all complete SysEx messages on display.
+int qxgeditMidiMonitorModel::exportSysex (
+	QIODevice *pFile, int *piTruncated ) const
+{
+	int iSysex = 0;
+	int iTruncated = 0;
+
+	QVectorIterator<int> iter(m_rows);
+	while (iter.hasNext()) {
+		const qxgeditMidiMonitorEvent& event = m_events.at(iter.next());
+		const QByteArray& data = event.data;
+		if (data.size() < 2 || (unsigned char) data.at(0) != 0xf0)
+			continue;
+		if ((unsigned int) data.size() < event.size) {
+			++iTruncated;
+			continue;
+		}
+		if ((unsigned char) data.at(data.size() - 1) != 0xf7)
+			continue;
+		if (pFile->write(data) != data.size())
+			break;
+		++iSysex;
+	}
+
+	if (piTruncated)
+		*piTruncated = iTruncated;
+
+	return iSysex;
+}
+
+
+// Event decoders.
+QString qxgeditMidiMonitorModel::dataText (
+	const qxgeditMidiMonitorEvent& event )
+{
+	static const int MaxBytes = 32;
+
+	const QByteArray& data = event.data;
+	const int iBytes = (data.size() < MaxBytes ? data.size() : MaxBytes);
+
+	QString sText = QString::fromLatin1(data.left(iBytes).toHex(' '));
+	if ((unsigned int) iBytes < event.size)
+		sText += QString(" ...");
+	if ((unsigned int) data.size() < event.size)
+		sText += tr(" (truncated)");
+
+	return sText;
+}
+
+
+QString qxgeditMidiMonitorModel::descriptionText (
+	const qxgeditMidiMonitorEvent& event ) const
+{
+	const QByteArray& data = event.data;
+	if (data.isEmpty())
+		return QString();
+
+	const unsigned char *pData = (const unsigned char *) data.constData();
+	const unsigned int iData = data.size();
+
+	// SysEx...
+	if (pData[0] == 0xf0) {
+		if (iData < event.size)
+			return tr("SysEx (truncated)");
+		const XGSysexDecoder decoder(pData, iData);
+		if (!decoder.is_valid()) {
+			if (iData == 6 && pData[1] == 0x7e && pData[3] == 0x09)
+				return (pData[4] == 0x01 ? tr("GM System On") : tr("GM System Off"));
+			if (iData >= 8 && pData[1] == 0x43 && pData[3] == 0x4c) {
+				if ((pData[2] & 0xf0) == 0x20)
+					return tr("Dump Request %1 %2 %3")
+						.arg(pData[4], 2, 16, QChar('0'))
+						.arg(pData[5], 2, 16, QChar('0'))
+						.arg(pData[6], 2, 16, QChar('0'));
+				if ((pData[2] & 0xf0) == 0x30)
+					return tr("Parameter Request %1 %2 %3")
+						.arg(pData[4], 2, 16, QChar('0'))
+						.arg(pData[5], 2, 16, QChar('0'))
+						.arg(pData[6], 2, 16, QChar('0'));
+			}
+			return tr("SysEx");
+		}
+		const unsigned short high = decoder.high();
+		const unsigned short mid  = decoder.mid();
+		const unsigned short low  = decoder.low();
+		const QString sAddr = QString("%1 %2 %3")
+			.arg(high, 2, 16, QChar('0'))
+			.arg(mid,  2, 16, QChar('0'))
+			.arg(low,  2, 16, QChar('0'));
+		XGParam *pParam = (m_pMasterMap
+			? m_pMasterMap->find_param(high, mid, low) : nullptr);
+		if (decoder.is_bulk_dump()) {
+			QString sText = tr("Bulk Dump %1 (%2 bytes)")
+				.arg(sAddr).arg(decoder.size());
+			if (pParam)
+				sText += ' ' + pParam->label();
+			return sText;
+		}
+		QString sText = tr("Param Change %1").arg(sAddr);
+		if (pParam && pParam->size() <= decoder.size()) {
+			unsigned char *data = const_cast<unsigned char *> (decoder.data());
+			sText += ' ' + pParam->label() + " = ";
+			if (pParam->size() > 4) {
+				sText += '"' + QString::fromLatin1(
+					(const char *) data, pParam->size()) + '"';
+			} else {
+				const unsigned short u = (high == 0x08 && low == 0x09
+					? pParam->data_value2(data) : pParam->data_value(data));
+				const char *s = pParam->gets(u);
+				sText += (s ? QString(s) : QString::number(pParam->getv(u)));
+			}
+		}
+		return sText;
+	}
+
+	// Resolved NRPN data entry...
+	if (event.nrpn >= 0) {
+		QString sText = tr("NRPN %1 %2 %3 = %4")
+			.arg(event.channel + 1)
+			.arg(event.nrpn >> 7, 2, 16, QChar('0'))
+			.arg(event.nrpn & 0x7f, 2, 16, QChar('0'))
+			.arg(event.value);
+		if (m_pMasterMap) {
+			unsigned char ch = event.channel;
+			XGParam *pParam = nullptr;
+			if (event.nrpn >= 2560) {
+				// Drum setup, whichever drum part mode...
+				XGParamSet *pParamSet = m_pMasterMap->MULTIPART.value(0x07, nullptr);
+				XGParam *pModeParam = (pParamSet ? pParamSet->value(ch, nullptr) : nullptr);
+				const unsigned short mode = (pModeParam ? pModeParam->value() : 0);
+				if (mode > 0 || ch == 9)
+					pParam = m_pMasterMap->NRPN.value(
+						XGRpnParamKey(mode == 3 ? 1 : 0, event.nrpn), nullptr);
+			} else {
+				pParam = m_pMasterMap->NRPN.value(
+					XGRpnParamKey(ch, event.nrpn), nullptr);
+			}
+			if (pParam)
+				sText += ' ' + pParam->label();
+		}
+		return sText;
+	}
+
+	// Channel (short) messages, as many as there are...
+	QStringList list;
+	unsigned int i = 0;
+	while (i < iData) {
+		const unsigned char status = (pData[i] & 0xf0);
+		const unsigned char ch = (pData[i] & 0x0f) + 1;
+		const unsigned int n = (status == 0xc0 || status == 0xd0 ? 2 : 3);
+		if (status < 0x80 || status >= 0xf0 || i + n > iData) {
+			list.append(tr("Data"));
+			break;
+		}
+		const unsigned char d1 = pData[i + 1];
+		const unsigned char d2 = (n > 2 ? pData[i + 2] : 0);
+		switch (status) {
+		case 0x80:
+			list.append(tr("Note Off %1 %2 %3").arg(ch).arg(d1).arg(d2));
+			break;
+		case 0x90:
+			list.append(tr("Note On %1 %2 %3").arg(ch).arg(d1).arg(d2));
+			break;
+		case 0xa0:
+			list.append(tr("Key Pressure %1 %2 %3").arg(ch).arg(d1).arg(d2));
+			break;
+		case 0xb0:
+			list.append(tr("Control %1 %2 = %3").arg(ch).arg(d1).arg(d2));
+			break;
+		case 0xc0:
+			list.append(tr("Program %1 %2").arg(ch).arg(d1));
+			break;
+		case 0xd0:
+			list.append(tr("Channel Pressure %1 %2").arg(ch).arg(d1));
+			break;
+		case 0xe0:
+			list.append(tr("Pitch Bend %1 %2").arg(ch)
+				.arg(int((d2 << 7) | d1) - 0x2000));
+			break;
+		}
+		i += n;
+	}
+
+	return list.join(", ");
+}
+
+
+// Filter predicate.
+bool qxgeditMidiMonitorModel::accept (
+	const qxgeditMidiMonitorEvent& event ) const
+{
+	if (m_direction == InOnly && event.out)
+		return false;
+	if (m_direction == OutOnly && !event.out)
+		return false;
+
+	const bool bSysex = (!event.data.isEmpty()
+		&& (unsigned char) event.data.at(0) == 0xf0);
+	if (m_kind == SysexOnly && !bSysex)
+		return false;
+	if (m_kind == ChannelOnly && bSysex)
+		return false;
+
+	if (!m_sText.isEmpty()
+		&& !descriptionText(event).contains(m_sText, Qt::CaseInsensitive)
+		&& !dataText(event).contains(m_sText, Qt::CaseInsensitive))
+		return false;
+
+	return true;
+}
+
+
+// NRPN selection tracker (per direction and channel).
+void qxgeditMidiMonitorModel::resolve ( qxgeditMidiMonitorEvent& event )
+{
+	const QByteArray& data = event.data;
+	const unsigned char *pData = (const unsigned char *) data.constData();
+	const unsigned int iData = data.size();
+
+	int *nrpn = m_nrpn[event.out ? 1 : 0];
+
+	unsigned int i = 0;
+	while (i + 2 < iData && (pData[i] & 0xf0) == 0xb0) {
+		const unsigned char ch = (pData[i] & 0x0f);
+		const unsigned char param = pData[i + 1];
+		const unsigned char value = pData[i + 2];
+		switch (param) {
+		case 0x63: // NRPN MSB.
+			nrpn[ch] = (value << 7) | (nrpn[ch] < 0 ? 0 : (nrpn[ch] & 0x7f));
+			break;
+		case 0x62: // NRPN LSB.
+			nrpn[ch] = (nrpn[ch] < 0 ? 0 : (nrpn[ch] & 0x3f80)) | value;
+			break;
+		case 0x65: // RPN MSB.
+		case 0x64: // RPN LSB.
+			nrpn[ch] = -1;
+			break;
+		case 0x06: // Data Entry MSB.
+			if (nrpn[ch] >= 0) {
+				event.nrpn = nrpn[ch];
+				event.channel = ch;
+				event.value = value;
+			}
+			break;
+		}
+		i += 3;
+	}
+}
+
+
+// Drop the oldest events (and rows) beyond cap.
+void qxgeditMidiMonitorModel::trim (void)
+{
+	const int iCount = m_events.count();
+	if (iCount <= MaxEvents)
+		return;
+
+	// In chunks, not to shift it all on every single pick-up...
+	const int k = iCount - MaxEvents + (MaxEvents >> 3);
+
+	const int r = int(std::lower_bound(
+		m_rows.constBegin(), m_rows.constEnd(), k) - m_rows.constBegin());
+	if (r > 0) {
+		beginRemoveRows(QModelIndex(), 0, r - 1);
+		m_rows.remove(0, r);
+		endRemoveRows();
+	}
+
+	const int iRows = m_rows.count();
+	for (int i = 0; i < iRows; ++i)
+		m_rows[i] -= k;
+
+	m_events.remove(0, k);
+}
+
+
+// end of qxgeditMidiMonitor.cpp
@@ -0,0 +1,215 @@
+// qxgeditMidiMonitor.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditMidiMonitor_h
+#define __qxgeditMidiMonitor_h
+
+#include "qxgeditMidiDevice.h"
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QVector>
+
+#include <atomic>
+
+
+// Forward decls.
+class qxgeditXGMasterMap;
+
+class QIODevice;
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitorEvent -- One captured MIDI message (or burst).
+
+struct qxgeditMidiMonitorEvent
+{
+	qint64 time;                    // Capture time (ns, since start).
+	bool   out;                     // Direction: false=in, true=out.
+	unsigned int size;              // Original size (bytes).
+	QByteArray data;                // Captured data (maybe truncated).
+	int    nrpn;                    // Resolved NRPN data entry (-1=none).
+	unsigned char  channel;         // NRPN data entry channel.
+	unsigned short value;           // NRPN data entry value.
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitor -- MIDI traffic capture (device tap).
+//
+// A bounded lock-free ring of fixed size slots: the I/O threads (any
+// number of them) claim a slot with one CAS on the tail and publish it
+// through the slot sequence number; the main thread is the one and only
+// consumer. Nothing is ever allocated nor locked on the I/O side: when
+// the ring is full the message is dropped and counted as such; messages
+// longer than one slot are kept truncated, with their original size.
+
+class qxgeditMidiMonitor : public qxgeditMidiDevice::Tap
+{
+public:
+
+	// Constructor.
+	qxgeditMidiMonitor();
+
+	// Destructor.
+	~qxgeditMidiMonitor();
+
+	// Device attachment (tap).
+	void setMidiDevice(qxgeditMidiDevice *pMidiDevice);
+	qxgeditMidiDevice *midiDevice() const;
+
+	// Tap callbacks (I/O threads).
+	void midiIn(const unsigned char *pMidi, unsigned int iMidi);
+	void midiOut(const unsigned char *pMidi, unsigned int iMidi);
+
+	// Capture pick-up (main thread only).
+	bool dequeue(qxgeditMidiMonitorEvent& event);
+
+	// Dropped messages so far (ring full).
+	unsigned int dropped() const;
+
+	// Ring dimensions.
+	static const unsigned int MaxSlots = 2048;
+	static const unsigned int MaxData  = 512;
+
+protected:
+
+	// Claim and fill one slot.
+	void enqueue(bool bOut, const unsigned char *pMidi, unsigned int iMidi);
+
+private:
+
+	// Ring slot.
+	struct Slot
+	{
+		std::atomic<unsigned int> seq;
+		qint64 time;
+		bool   out;
+		unsigned int size;
+		unsigned char data[MaxData];
+	};
+
+	// Instance variables.
+	Slot *m_slots;
+
+	std::atomic<unsigned int> m_tail;
+	unsigned int m_head;
+
+	std::atomic<unsigned int> m_dropped;
+
+	QElapsedTimer m_clock;
+
+	qxgeditMidiDevice *m_pMidiDevice;
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitorModel -- Captured MIDI traffic (list view model).
+//
+// Keeps a capped history of events and the (filtered) subset of rows
+// on display. Text columns are only ever decoded on demand, so that a
+// virtualized view gets to pay for the visible rows only.
+
+class qxgeditMidiMonitorModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditMidiMonitorModel(QObject *pParent = nullptr);
+
+	// Columns.
+	enum Column { Time = 0, Port, Size, Data, Text, ColumnCount };
+
+	// Filters.
+	enum Direction { AnyDirection = 0, InOnly, OutOnly };
+	enum Kind { AnyKind = 0, SysexOnly, ChannelOnly };
+
+	// Concretizers (virtual).
+	int rowCount(const QModelIndex& parent = QModelIndex()) const;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const;
+
+	QVariant headerData(int section,
+		Qt::Orientation orient, int role = Qt::DisplayRole) const;
+	QVariant data(const QModelIndex& index,
+		int role = Qt::DisplayRole) const;
+
+	// Parameter name decoding source.
+	void setMasterMap(qxgeditXGMasterMap *pMasterMap);
+	qxgeditXGMasterMap *masterMap() const;
+
+	// Capture pick-up (all pending, in one row insertion).
+	int append(qxgeditMidiMonitor *pMonitor);
+
+	// Filter settings.
+	void setFilter(Direction direction, Kind kind, const QString& sText);
+
+	// History reset.
+	void clear();
+
+	// History counters.
+	int count() const;
+
+	// Export all complete SysEx messages on display
+	// (truncated ones are skipped, and counted as such).
+	int exportSysex(QIODevice *pFile, int *piTruncated = nullptr) const;
+
+	// Event decoders.
+	static QString dataText(const qxgeditMidiMonitorEvent& event);
+	QString descriptionText(const qxgeditMidiMonitorEvent& event) const;
+
+	// History cap (events).
+	static const int MaxEvents = 100000;
+
+protected:
+
+	// Filter predicate.
+	bool accept(const qxgeditMidiMonitorEvent& event) const;
+
+	// NRPN selection tracker (per direction and channel).
+	void resolve(qxgeditMidiMonitorEvent& event);
+
+	// Drop the oldest events (and rows) beyond cap.
+	void trim();
+
+private:
+
+	// Instance variables.
+	qxgeditXGMasterMap *m_pMasterMap;
+
+	QVector<qxgeditMidiMonitorEvent> m_events;
+	QVector<int> m_rows;
+
+	Direction m_direction;
+	Kind      m_kind;
+	QString   m_sText;
+
+	// NRPN selection state ([out][channel]; -1=none).
+	int m_nrpn[2][16];
+};
+
+
+#endif	// __qxgeditMidiMonitor_h
+
+
+// end of qxgeditMidiMonitor.h
@@ -0,0 +1,285 @@
+// qxgeditMidiMonitorForm.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditMidiMonitorForm.h"
+
+#include "qxgeditOptions.h"
+
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QUrl>
+#include <QMessageBox>
+#include <QTimer>
+
+#include <QShowEvent>
+#include <QHideEvent>
+
+
+// Capture pick-up period (msecs).
+static const int c_iRefreshTimeout = 50;
+
+// Text filter settle-down period (msecs).
+static const int c_iFilterTimeout = 300;
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitorForm -- UI wrapper form.
+
+// Constructor.
+qxgeditMidiMonitorForm::qxgeditMidiMonitorForm (
+	QWidget *pParent, Qt::WindowFlags wflags )
+	: QWidget(pParent, wflags)
+{
+	// Setup UI struct...
+	m_ui.setupUi(this);
+#if QT_VERSION < QT_VERSION_CHECK(6, 1, 0)
+	QWidget::setWindowIcon(QIcon(":/images/qxgedit.png"));
+#endif
+
+	m_pModel = new qxgeditMidiMonitorModel(this);
+	m_pMidiDevice = nullptr;
+	m_iSkipped = 0;
+
+	// Virtualized list view (uniform rows, fixed columns)...
+	m_ui.EventsTreeView->setModel(m_pModel);
+	m_ui.EventsTreeView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+	QHeaderView *pHeader = m_ui.EventsTreeView->header();
+	pHeader->setStretchLastSection(true);
+	pHeader->setSectionResizeMode(QHeaderView::Interactive);
+	pHeader->resizeSection(qxgeditMidiMonitorModel::Time, 96);
+	pHeader->resizeSection(qxgeditMidiMonitorModel::Port, 40);
+	pHeader->resizeSection(qxgeditMidiMonitorModel::Size, 48);
+	pHeader->resizeSection(qxgeditMidiMonitorModel::Data, 280);
+
+	m_pRefreshTimer = new QTimer(this);
+	m_pFilterTimer = new QTimer(this);
+	m_pFilterTimer->setSingleShot(true);
+
+	// UI signal/slot connections...
+	QObject::connect(m_pRefreshTimer,
+		SIGNAL(timeout()),
+		SLOT(refresh()));
+	QObject::connect(m_pFilterTimer,
+		SIGNAL(timeout()),
+		SLOT(filterChanged()));
+	QObject::connect(m_ui.PauseToolButton,
+		SIGNAL(toggled(bool)),
+		SLOT(stabilizeForm()));
+	QObject::connect(m_ui.ClearToolButton,
+		SIGNAL(clicked()),
+		SLOT(clear()));
+	QObject::connect(m_ui.ExportToolButton,
+		SIGNAL(clicked()),
+		SLOT(exportSysex()));
+	QObject::connect(m_ui.DirectionComboBox,
+		SIGNAL(activated(int)),
+		SLOT(filterChanged()));
+	QObject::connect(m_ui.KindComboBox,
+		SIGNAL(activated(int)),
+		SLOT(filterChanged()));
+	QObject::connect(m_ui.FilterLineEdit,
+		SIGNAL(textChanged(const QString&)),
+		m_pFilterTimer, SLOT(start()));
+
+	m_pFilterTimer->setInterval(c_iFilterTimeout);
+
+	stabilizeForm();
+}
+
+
+// Destructor.
+qxgeditMidiMonitorForm::~qxgeditMidiMonitorForm (void)
+{
+	m_monitor.setMidiDevice(nullptr);
+}
+
+
+// Monitored device (current module).
+void qxgeditMidiMonitorForm::setMidiDevice (
+	qxgeditMidiDevice *pMidiDevice, qxgeditXGMasterMap *pMasterMap )
+{
+	m_pMidiDevice = pMidiDevice;
+	m_pModel->setMasterMap(pMasterMap);
+
+	m_monitor.setMidiDevice(isVisible() ? m_pMidiDevice : nullptr);
+}
+
+
+qxgeditMidiDevice *qxgeditMidiMonitorForm::midiDevice (void) const
+{
+	return m_pMidiDevice;
+}
+
+
+// Capture pick-up (timer).
+void qxgeditMidiMonitorForm::refresh (void)
+{
+	if (m_ui.PauseToolButton->isChecked()) {
+		// Keep the ring drained, but leave the view alone:
+		// whatever arrives while paused is discarded for good...
+		qxgeditMidiMonitorEvent event;
+		while (m_monitor.dequeue(event))
+			++m_iSkipped;
+	} else {
+		// Follow the tail, unless scrolled away from it...
+		QScrollBar *pScrollBar = m_ui.EventsTreeView->verticalScrollBar();
+		const bool bTail = (pScrollBar->value() >= pScrollBar->maximum());
+		if (m_pModel->append(&m_monitor) > 0 && bTail)
+			m_ui.EventsTreeView->scrollToBottom();
+	}
+
+	stabilizeForm();
+}
+
+
+// Tool buttons.
+void qxgeditMidiMonitorForm::clear (void)
+{
+	m_pModel->clear();
+	m_iSkipped = 0;
+
+	stabilizeForm();
+}
+
+
+void qxgeditMidiMonitorForm::exportSysex (void)
+{
+	qxgeditOptions *pOptions = qxgeditOptions::getInstance();
+	if (pOptions == nullptr)
+		return;
+
+	const QString sExt("syx");
+	const QString& sTitle  = tr("Export SysEx");
+	const QString& sFilter = tr("SysEx files (*.%1)").arg(sExt);
+
+	// Construct save-file dialog...
+	QFileDialog fileDialog(this,
+		sTitle, pOptions->sSessionDir, sFilter);
+	// Set proper save-file modes...
+	fileDialog.setAcceptMode(QFileDialog::AcceptSave);
+	fileDialog.setFileMode(QFileDialog::AnyFile);
+	fileDialog.setDefaultSuffix(sExt);
+	// Stuff sidebar...
+	QList<QUrl> urls(fileDialog.sidebarUrls());
+	urls.append(QUrl::fromLocalFile(pOptions->sSessionDir));
+	fileDialog.setSidebarUrls(urls);
+	// Show save-file dialog...
+	if (!fileDialog.exec())
+		return;
+
+	// Have the save-file name...
+	QString sFilename = fileDialog.selectedFiles().first();
+	if (sFilename.isEmpty())
+		return;
+	if (QFileInfo(sFilename).suffix() != sExt)
+		sFilename += '.' + sExt;
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		QMessageBox::critical(this,
+			tr("Error"),
+			tr("Could not open file for writing:\n\n\"%1\".")
+			.arg(sFilename),
+			QMessageBox::Cancel);
+		return;
+	}
+
+	int iTruncated = 0;
+	const int iSysex = m_pModel->exportSysex(&file, &iTruncated);
+	file.close();
+
+	// Tell whether some were left out...
+	if (iTruncated > 0) {
+		QMessageBox::warning(this,
+			tr("Warning"),
+			tr("%1 SysEx message(s) exported to:\n\n\"%2\".\n\n"
+			"%3 truncated SysEx message(s) were left out\n"
+			"(longer than %4 bytes each).")
+			.arg(iSysex).arg(sFilename).arg(iTruncated)
+			.arg(qxgeditMidiMonitor::MaxData),
+			QMessageBox::Ok);
+	}
+}
+
+
+// Filters.
+void qxgeditMidiMonitorForm::filterChanged (void)
+{
+	m_pFilterTimer->stop();
+
+	m_pModel->setFilter(
+		qxgeditMidiMonitorModel::Direction(
+			m_ui.DirectionComboBox->currentIndex()),
+		qxgeditMidiMonitorModel::Kind(
+			m_ui.KindComboBox->currentIndex()),
+		m_ui.FilterLineEdit->text());
+
+	m_ui.EventsTreeView->scrollToBottom();
+
+	stabilizeForm();
+}
+
+
+void qxgeditMidiMonitorForm::stabilizeForm (void)
+{
+	QString sText = tr("%1 of %2 events")
+		.arg(m_pModel->rowCount()).arg(m_pModel->count());
+
+	const unsigned int iDropped = m_monitor.dropped();
+	if (iDropped > 0)
+		sText += tr(", %1 dropped").arg(iDropped);
+	if (m_iSkipped > 0)
+		sText += tr(", %1 skipped").arg(m_iSkipped);
+
+	m_ui.StatusLabel->setText(sText);
+
+	m_ui.ExportToolButton->setEnabled(m_pModel->rowCount() > 0);
+}
+
+
+// Capture only while visible.
+void qxgeditMidiMonitorForm::showEvent ( QShowEvent *pShowEvent )
+{
+	QWidget::showEvent(pShowEvent);
+
+	m_monitor.setMidiDevice(m_pMidiDevice);
+	m_pRefreshTimer->start(c_iRefreshTimeout);
+
+	emit visibilityChanged(true);
+}
+
+
+void qxgeditMidiMonitorForm::hideEvent ( QHideEvent *pHideEvent )
+{
+	m_pRefreshTimer->stop();
+	m_monitor.setMidiDevice(nullptr);
+
+	QWidget::hideEvent(pHideEvent);
+
+	emit visibilityChanged(false);
+}
+
+
+// end of qxgeditMidiMonitorForm.cpp
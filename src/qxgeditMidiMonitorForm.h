@@ -0,0 +1,104 @@
+// qxgeditMidiMonitorForm.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditMidiMonitorForm_h
+#define __qxgeditMidiMonitorForm_h
+
+#include "ui_qxgeditMidiMonitorForm.h"
+
+#include "qxgeditMidiMonitor.h"
+
+
+// Forward declarations...
+class qxgeditMidiDevice;
+class qxgeditXGMasterMap;
+
+class QTimer;
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiMonitorForm -- UI wrapper form.
+
+class qxgeditMidiMonitorForm : public QWidget
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditMidiMonitorForm(QWidget *pParent = nullptr,
+		Qt::WindowFlags wflags = Qt::WindowFlags());
+	// Destructor.
+	~qxgeditMidiMonitorForm();
+
+	// Monitored device (current module).
+	void setMidiDevice(qxgeditMidiDevice *pMidiDevice,
+		qxgeditXGMasterMap *pMasterMap);
+	qxgeditMidiDevice *midiDevice() const;
+
+signals:
+
+	// Show/hide notification.
+	void visibilityChanged(bool bVisible);
+
+protected slots:
+
+	// Capture pick-up (timer).
+	void refresh();
+
+	// Tool buttons.
+	void clear();
+	void exportSysex();
+
+	// Filters.
+	void filterChanged();
+
+	void stabilizeForm();
+
+protected:
+
+	// Capture only while visible.
+	void showEvent(QShowEvent *pShowEvent);
+	void hideEvent(QHideEvent *pHideEvent);
+
+private:
+
+	// The Qt-designer UI struct...
+	Ui::qxgeditMidiMonitorForm m_ui;
+
+	// Instance variables...
+	qxgeditMidiMonitor m_monitor;
+	qxgeditMidiMonitorModel *m_pModel;
+
+	qxgeditMidiDevice *m_pMidiDevice;
+
+	QTimer *m_pRefreshTimer;
+	QTimer *m_pFilterTimer;
+
+	// Discarded while paused (never shown, nor exported).
+	unsigned int m_iSkipped;
+};
+
+
+#endif	// __qxgeditMidiMonitorForm_h
+
+
+// end of qxgeditMidiMonitorForm.h
@@ -0,0 +1,462 @@
+// qxgeditMidiPorts.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "qxgeditAbout.h"
+#include "qxgeditMidiPorts.h"
+
+#include <QThread>
+
+#ifdef CONFIG_ALSA_MIDI
+#include <alsa/asoundlib.h>
+#endif
+
+
+// Listing item separator.
+static const char *c_pszItemSep = " / ";
+
+// Initial enumeration wait limit (msecs).
+static const unsigned long c_iReadyTimeout = 1000;
+
+
+//----------------------------------------------------------------------
+// class qxgeditMidiPorts::Thread -- Port registry thread.
+//
+
+class qxgeditMidiPorts::Thread : public QThread
+{
+public:
+
+	// Constructor.
+	Thread(qxgeditMidiPorts *pMidiPorts, const QString& sClientName)
+		: QThread(), m_pMidiPorts(pMidiPorts),
+			m_sClientName(sClientName), m_bRunState(true) {}
+
+	// Run-state accessors.
+	void setRunState(bool bRunState)
+		{ m_bRunState = bRunState; }
+	bool runState() const
+		{ return m_bRunState; }
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+	#ifdef CONFIG_ALSA_MIDI
+
+		snd_seq_t *pAlsaSeq = nullptr;
+		if (snd_seq_open(&pAlsaSeq, "hw", SND_SEQ_OPEN_INPUT, 0) < 0) {
+			m_pMidiPorts->setReady();
+			return;
+		}
+
+		snd_seq_set_client_name(pAlsaSeq,
+			m_sClientName.toLatin1().constData());
+
+		// Listen to System:Announce first, so that nothing
+		// gets missed while enumerating (hidden port)...
+		const int iAlsaPort = snd_seq_create_simple_port(pAlsaSeq, "announce",
+			SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_NO_EXPORT,
+			SND_SEQ_PORT_TYPE_APPLICATION);
+		if (iAlsaPort >= 0) {
+			snd_seq_connect_from(pAlsaSeq, iAlsaPort,
+				SND_SEQ_CLIENT_SYSTEM, SND_SEQ_PORT_SYSTEM_ANNOUNCE);
+		}
+
+		// Initial enumeration (all clients, all ports)...
+		snd_seq_client_info_t *pClientInfo;
+		snd_seq_client_info_alloca(&pClientInfo);
+		snd_seq_client_info_set_client(pClientInfo, -1);
+		while (snd_seq_query_next_client(pAlsaSeq, pClientInfo) >= 0)
+			updateClient(pAlsaSeq, pClientInfo);
+
+		m_pMidiPorts->setReady();
+		m_pMidiPorts->notifyChanged();
+
+		if (iAlsaPort < 0) {
+			snd_seq_close(pAlsaSeq);
+			return;
+		}
+
+		int nfds;
+		struct pollfd *pfds;
+
+		nfds = snd_seq_poll_descriptors_count(pAlsaSeq, POLLIN);
+		pfds = (struct pollfd *) alloca(nfds * sizeof(struct pollfd));
+		snd_seq_poll_descriptors(pAlsaSeq, pfds, nfds, POLLIN);
+
+		int iPoll = 0;
+		while (m_bRunState && iPoll >= 0) {
+			// Wait for events...
+			iPoll = poll(pfds, nfds, 200);
+			int iChanges = 0;
+			while (iPoll > 0) {
+				snd_seq_event_t *pEv = nullptr;
+				snd_seq_event_input(pAlsaSeq, &pEv);
+				if (pEv && process(pAlsaSeq, pEv))
+					++iChanges;
+				iPoll = snd_seq_event_input_pending(pAlsaSeq, 0);
+			}
+			// Coalesced notification...
+			if (iChanges > 0)
+				m_pMidiPorts->notifyChanged();
+		}
+
+		snd_seq_delete_simple_port(pAlsaSeq, iAlsaPort);
+		snd_seq_close(pAlsaSeq);
+
+	#else
+
+		m_pMidiPorts->setReady();
+
+	#endif	// CONFIG_ALSA_MIDI
+	}
+
+#ifdef CONFIG_ALSA_MIDI
+
+	// Register all ports of a client.
+	void updateClient (
+		snd_seq_t *pAlsaSeq, snd_seq_client_info_t *pClientInfo )
+	{
+		const int iClient = snd_seq_client_info_get_client(pClientInfo);
+		const QString sClientName = snd_seq_client_info_get_name(pClientInfo);
+
+		snd_seq_port_info_t *pPortInfo;
+		snd_seq_port_info_alloca(&pPortInfo);
+		snd_seq_port_info_set_client(pPortInfo, iClient);
+		snd_seq_port_info_set_port(pPortInfo, -1);
+		while (snd_seq_query_next_port(pAlsaSeq, pPortInfo) >= 0) {
+			m_pMidiPorts->setPort(iClient,
+				snd_seq_port_info_get_port(pPortInfo),
+				snd_seq_port_info_get_capability(pPortInfo),
+				sClientName, snd_seq_port_info_get_name(pPortInfo));
+		}
+	}
+
+	// Register one single port.
+	bool updatePort ( snd_seq_t *pAlsaSeq, int iClient, int iPort )
+	{
+		snd_seq_client_info_t *pClientInfo;
+		snd_seq_port_info_t   *pPortInfo;
+
+		snd_seq_client_info_alloca(&pClientInfo);
+		snd_seq_port_info_alloca(&pPortInfo);
+
+		if (snd_seq_get_any_client_info(pAlsaSeq, iClient, pClientInfo) < 0)
+			return false;
+		if (snd_seq_get_any_port_info(pAlsaSeq, iClient, iPort, pPortInfo) < 0)
+			return false;
+
+		m_pMidiPorts->setPort(iClient, iPort,
+			snd_seq_port_info_get_capability(pPortInfo),
+			snd_seq_client_info_get_name(pClientInfo),
+			snd_seq_port_info_get_name(pPortInfo));
+
+		return true;
+	}
+
+	// Process an announce event (true if the registry changed).
+	bool process ( snd_seq_t *pAlsaSeq, const snd_seq_event_t *pEv )
+	{
+		const int iClient = pEv->data.addr.client;
+		const int iPort   = pEv->data.addr.port;
+
+	#ifdef CONFIG_DEBUG
+		qDebug("qxgeditMidiPorts::Thread::process(0x%02x, %d:%d)",
+			pEv->type, iClient, iPort);
+	#endif
+
+		switch (pEv->type) {
+		case SND_SEQ_EVENT_PORT_START:
+		case SND_SEQ_EVENT_PORT_CHANGE:
+			return updatePort(pAlsaSeq, iClient, iPort);
+		case SND_SEQ_EVENT_PORT_EXIT:
+			m_pMidiPorts->removePort(iClient, iPort);
+			return true;
+		case SND_SEQ_EVENT_CLIENT_CHANGE: {
+			snd_seq_client_info_t *pClientInfo;
+			snd_seq_client_info_alloca(&pClientInfo);
+			if (snd_seq_get_any_client_info(pAlsaSeq, iClient, pClientInfo) < 0)
+				return false;
+			m_pMidiPorts->renameClient(iClient,
+				snd_seq_client_info_get_name(pClientInfo));
+			return true;
+		}
+		case SND_SEQ_EVENT_CLIENT_EXIT:
+			m_pMidiPorts->removeClient(iClient);
+			return true;
+		default:
+			// Client start (ports will follow),
+			// (un)subscriptions, etc.
+			return false;
+		}
+	}
+
+#endif	// CONFIG_ALSA_MIDI
+
+private:
+
+	// The thread launcher engine.
+	qxgeditMidiPorts *m_pMidiPorts;
+
+	// Registry client name.
+	QString m_sClientName;
+
+	// Whether the thread is logically running.
+	bool m_bRunState;
+};
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiPorts -- ALSA sequencer port registry (shared).
+
+// Shared instance.
+qxgeditMidiPorts *qxgeditMidiPorts::g_pMidiPorts = nullptr;
+int qxgeditMidiPorts::g_iRefCount = 0;
+
+
+// Constructor.
+qxgeditMidiPorts::qxgeditMidiPorts ( const QString& sClientName )
+	: QObject(nullptr), m_bReady(false), m_pThread(nullptr)
+{
+	m_pThread = new Thread(this, sClientName);
+	m_pThread->start(QThread::LowPriority);
+}
+
+
+// Destructor.
+qxgeditMidiPorts::~qxgeditMidiPorts (void)
+{
+	if (m_pThread) {
+		if (m_pThread->isRunning()) {
+			m_pThread->setRunState(false);
+			m_pThread->wait();
+		}
+		delete m_pThread;
+		m_pThread = nullptr;
+	}
+}
+
+
+// Shared instance reference counting (first one starts it).
+qxgeditMidiPorts *qxgeditMidiPorts::attach ( const QString& sClientName )
+{
+	if (++g_iRefCount == 1)
+		g_pMidiPorts = new qxgeditMidiPorts(sClientName);
+
+	return g_pMidiPorts;
+}
+
+void qxgeditMidiPorts::detach (void)
+{
+	if (g_iRefCount > 0 && --g_iRefCount == 0) {
+		delete g_pMidiPorts;
+		g_pMidiPorts = nullptr;
+	}
+}
+
+
+// Shared instance reference.
+qxgeditMidiPorts *qxgeditMidiPorts::getInstance (void)
+{
+	return g_pMidiPorts;
+}
+
+
+// Index key (names only).
+QString qxgeditMidiPorts::nameKey (
+	const QString& sClientName, const QString& sPortName )
+{
+	return sClientName + c_pszItemSep + sPortName;
+}
+
+
+// Port capability filter.
+bool qxgeditMidiPorts::isPortCaps ( unsigned int uiCaps, bool bReadable )
+{
+#ifdef CONFIG_ALSA_MIDI
+	unsigned int uiPortFlags;
+	if (bReadable)
+		uiPortFlags = SND_SEQ_PORT_CAP_READ  | SND_SEQ_PORT_CAP_SUBS_READ;
+	else
+		uiPortFlags = SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE;
+	return ((uiCaps & uiPortFlags) == uiPortFlags)
+		&& ((uiCaps & SND_SEQ_PORT_CAP_NO_EXPORT) == 0);
+#else
+	return false;
+#endif
+}
+
+
+// Waits for the initial enumeration (bounded).
+void qxgeditMidiPorts::waitReady (void)
+{
+	if (!m_bReady)
+		m_ready.wait(&m_mutex, c_iReadyTimeout);
+}
+
+
+// Readable/writable port listing, but for the given (own) client.
+QStringList qxgeditMidiPorts::list ( bool bReadable, int iExcludeClient )
+{
+	QStringList list;
+
+	QMutexLocker locker(&m_mutex);
+	waitReady();
+
+	QMap<unsigned int, Port>::ConstIterator iter = m_ports.constBegin();
+	const QMap<unsigned int, Port>::ConstIterator& iter_end = m_ports.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const Port& port = iter.value();
+		if (port.client < 1 || port.client == iExcludeClient)
+			continue;
+		if (!isPortCaps(port.caps, bReadable))
+			continue;
+		QString sItem = QString::number(port.client) + ':';
+		sItem += port.client_name;
+		sItem += c_pszItemSep;
+		sItem += QString::number(port.port) + ':';
+		sItem += port.port_name;
+		list.append(sItem);
+	}
+
+	return list;
+}
+
+
+// Readable/writable port addresses matching a listing item.
+QList<qxgeditMidiPorts::Addr> qxgeditMidiPorts::find (
+	const QString& sItem, bool bReadable, int iExcludeClient )
+{
+	QList<Addr> addrs;
+
+	const QString& sClientItem = sItem.section(c_pszItemSep, 0, 0);
+	const QString& sPortItem   = sItem.section(c_pszItemSep, 1, 1);
+	const QString& sKey = nameKey(
+		sClientItem.section(':', 1), sPortItem.section(':', 1));
+
+	// Never waits: a change notification follows the initial enumeration.
+	QMutexLocker locker(&m_mutex);
+
+	foreach (unsigned int key, m_index.values(sKey)) {
+		QMap<unsigned int, Port>::ConstIterator iter = m_ports.constFind(key);
+		if (iter == m_ports.constEnd())
+			continue;
+		const Port& port = iter.value();
+		if (port.client < 1 || port.client == iExcludeClient)
+			continue;
+		if (!isPortCaps(port.caps, bReadable))
+			continue;
+		Addr addr;
+		addr.client = port.client;
+		addr.port   = port.port;
+		addrs.append(addr);
+	}
+
+	return addrs;
+}
+
+
+// Registry updates (registry thread only).
+void qxgeditMidiPorts::setPort ( int iClient, int iPort, unsigned int uiCaps,
+	const QString& sClientName, const QString& sPortName )
+{
+	QMutexLocker locker(&m_mutex);
+
+	const unsigned int key = portKey(iClient, iPort);
+
+	QMap<unsigned int, Port>::Iterator iter = m_ports.find(key);
+	if (iter != m_ports.end()) {
+		Port& port = iter.value();
+		m_index.remove(nameKey(port.client_name, port.port_name), key);
+		port.caps = uiCaps;
+		port.client_name = sClientName;
+		port.port_name = sPortName;
+	} else {
+		Port port;
+		port.client = iClient;
+		port.port = iPort;
+		port.caps = uiCaps;
+		port.client_name = sClientName;
+		port.port_name = sPortName;
+		m_ports.insert(key, port);
+	}
+
+	m_index.insert(nameKey(sClientName, sPortName), key);
+}
+
+
+void qxgeditMidiPorts::removePort ( int iClient, int iPort )
+{
+	QMutexLocker locker(&m_mutex);
+
+	const unsigned int key = portKey(iClient, iPort);
+
+	QMap<unsigned int, Port>::Iterator iter = m_ports.find(key);
+	if (iter != m_ports.end()) {
+		const Port& port = iter.value();
+		m_index.remove(nameKey(port.client_name, port.port_name), key);
+		m_ports.erase(iter);
+	}
+}
+
+
+void qxgeditMidiPorts::removeClient ( int iClient )
+{
+	QMutexLocker locker(&m_mutex);
+
+	QMap<unsigned int, Port>::Iterator iter
+		= m_ports.lowerBound(portKey(iClient, 0));
+	while (iter != m_ports.end() && iter.value().client == iClient) {
+		const Port& port = iter.value();
+		m_index.remove(nameKey(port.client_name, port.port_name), iter.key());
+		iter = m_ports.erase(iter);
+	}
+}
+
+
+void qxgeditMidiPorts::renameClient ( int iClient, const QString& sClientName )
+{
+	QMutexLocker locker(&m_mutex);
+
+	QMap<unsigned int, Port>::Iterator iter
+		= m_ports.lowerBound(portKey(iClient, 0));
+	for ( ; iter != m_ports.end() && iter.value().client == iClient; ++iter) {
+		Port& port = iter.value();
+		m_index.remove(nameKey(port.client_name, port.port_name), iter.key());
+		port.client_name = sClientName;
+		m_index.insert(nameKey(port.client_name, port.port_name), iter.key());
+	}
+}
+
+
+// Initial enumeration done (or given up).
+void qxgeditMidiPorts::setReady (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_bReady = true;
+	m_ready.wakeAll();
+}
+
+
+// end of qxgeditMidiPorts.cpp
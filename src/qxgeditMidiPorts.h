@@ -0,0 +1,148 @@
+// qxgeditMidiPorts.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#ifndef __qxgeditMidiPorts_h
+#define __qxgeditMidiPorts_h
+
+#include <QObject>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QMultiHash>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+//----------------------------------------------------------------------------
+// qxgeditMidiPorts -- ALSA sequencer port registry (shared).
+//
+// All sequencer clients and ports get enumerated once, in the background,
+// and kept current from then on by listening to System:Announce; listings
+// and name lookups are then served from the cache, never walking the
+// sequencer again. The changed() signal is posted (coalesced) on each
+// port appearing, vanishing or being renamed, so that the configured
+// connections may be settled again, eg. when a device reappears.
+
+class qxgeditMidiPorts : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Port address.
+	struct Addr
+	{
+		int client;
+		int port;
+	};
+
+	// Shared instance reference counting (first one starts it).
+	static qxgeditMidiPorts *attach(const QString& sClientName);
+	static void detach();
+
+	// Shared instance reference.
+	static qxgeditMidiPorts *getInstance();
+
+	// Readable/writable port listing ("client:Client / port:Port"),
+	// but for the given (own) client (waits for the initial enumeration).
+	QStringList list(bool bReadable, int iExcludeClient = -1);
+
+	// Readable/writable port addresses matching a listing item,
+	// by client and port names (client and port numbers ignored);
+	// none before the initial enumeration is done.
+	QList<Addr> find(const QString& sItem, bool bReadable, int iExcludeClient = -1);
+
+	// Forward decl.
+	class Thread;
+
+signals:
+
+	// Port registry change notification (posted, coalesced).
+	void changed();
+
+protected:
+
+	// Constructor.
+	qxgeditMidiPorts(const QString& sClientName);
+	// Destructor.
+	~qxgeditMidiPorts();
+
+	// Registry updates (registry thread only).
+	void setPort(int iClient, int iPort, unsigned int uiCaps,
+		const QString& sClientName, const QString& sPortName);
+	void removePort(int iClient, int iPort);
+	void removeClient(int iClient);
+	void renameClient(int iClient, const QString& sClientName);
+
+	// Initial enumeration done (or given up).
+	void setReady();
+
+	// Post a change notification.
+	void notifyChanged()
+		{ emit changed(); }
+
+	// Waits for the initial enumeration (bounded).
+	void waitReady();
+
+	// Index key (names only).
+	static QString nameKey(const QString& sClientName, const QString& sPortName);
+
+private:
+
+	// Registered port entry.
+	struct Port
+	{
+		int          client;
+		int          port;
+		unsigned int caps;
+		QString      client_name;
+		QString      port_name;
+	};
+
+	// Port table key (sorted by client and port numbers).
+	static unsigned int portKey(int iClient, int iPort)
+		{ return (iClient << 16) | (iPort & 0xffff); }
+
+	// Port capability filter.
+	static bool isPortCaps(unsigned int uiCaps, bool bReadable);
+
+	// Instance variables.
+	QMutex m_mutex;
+	QWaitCondition m_ready;
+	bool m_bReady;
+
+	QMap<unsigned int, Port> m_ports;
+	QMultiHash<QString, unsigned int> m_index;
+
+	// Registry thread.
+	Thread *m_pThread;
+
+	// Shared instance.
+	static qxgeditMidiPorts *g_pMidiPorts;
+	static int g_iRefCount;
+};
+
+
+#endif	// __qxgeditMidiPorts_h
+
+
+// end of qxgeditMidiPorts.h
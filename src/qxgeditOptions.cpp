@@ -22,6 +22,9 @@
 #include "qxgeditAbout.h"
 #include "qxgeditOptions.h"
 
+#include "qxgeditStartup.h"
+#include "qxgeditSmfFile.h"
+
 #include <QWidget>
 #include <QFileInfo>
 #include <QTextStream>
@@ -62,6 +65,11 @@ qxgeditOptions::qxgeditOptions (void)
 	// Pseudo-singleton reference setup.
 	g_pOptions = this;
 
+	// Command line only options.
+	bProfileStartup = false;
+	iStartupBudget  = qxgeditStartup::DefaultBudget;
+	bAllocReport    = false;
+
 	loadOptions();
 }
 
@@ -86,6 +94,34 @@ void qxgeditOptions::loadOptions (void)
 	m_settings.beginGroup("/Midi");
 	midiInputs  = m_settings.value("/Inputs").toStringList();
 	midiOutputs = m_settings.value("/Outputs").toStringList();
+	iMidiRate   = m_settings.value("/Rate", qxgeditSmfFile::DefaultRate).toInt();
+	bMidiCompact = m_settings.value("/Compact", false).toBool();
+	bPublishState = m_settings.value("/PublishState", false).toBool();
+	bMidiDirect = m_settings.value("/DirectCommit", false).toBool();
+	bMidiPaced = m_settings.value("/Paced", false).toBool();
+	m_settings.endGroup();
+
+	// Additional XG modules...
+	moduleInputs.clear();
+	moduleOutputs.clear();
+	m_settings.beginGroup("/Modules");
+	const int iModules = m_settings.value("/Count", 0).toInt();
+	for (int i = 0; i < iModules; ++i) {
+		m_settings.beginGroup(QString("/Module%1").arg(i + 2));
+		moduleInputs.append(m_settings.value("/Inputs").toStringList());
+		moduleOutputs.append(m_settings.value("/Outputs").toStringList());
+		m_settings.endGroup();
+	}
+	m_settings.endGroup();
+
+	// MIDI Learn controller bindings...
+	midiLearn.clear();
+	m_settings.beginGroup("/MidiLearn");
+	const int iMidiLearn = m_settings.value("/Count", 0).toInt();
+	for (int i = 0; i < iMidiLearn; ++i) {
+		midiLearn.append(m_settings.value(
+			QString("/Module%1").arg(i + 1)).toStringList());
+	}
 	m_settings.endGroup();
 
 	// Load display options...
@@ -138,6 +174,35 @@ void qxgeditOptions::saveOptions (void)
 	m_settings.beginGroup("/Midi");
 	m_settings.setValue("/Inputs", midiInputs);
 	m_settings.setValue("/Outputs", midiOutputs);
+	m_settings.setValue("/Rate", iMidiRate);
+	m_settings.setValue("/Compact", bMidiCompact);
+	m_settings.setValue("/PublishState", bPublishState);
+	m_settings.setValue("/DirectCommit", bMidiDirect);
+	m_settings.setValue("/Paced", bMidiPaced);
+	m_settings.endGroup();
+
+	// Additional XG modules...
+	m_settings.remove("/Modules");
+	m_settings.beginGroup("/Modules");
+	const int iModules = moduleInputs.count();
+	m_settings.setValue("/Count", iModules);
+	for (int i = 0; i < iModules; ++i) {
+		m_settings.beginGroup(QString("/Module%1").arg(i + 2));
+		m_settings.setValue("/Inputs", moduleInputs.at(i));
+		m_settings.setValue("/Outputs", moduleOutputs.value(i));
+		m_settings.endGroup();
+	}
+	m_settings.endGroup();
+
+	// MIDI Learn controller bindings...
+	m_settings.remove("/MidiLearn");
+	m_settings.beginGroup("/MidiLearn");
+	const int iMidiLearn = midiLearn.count();
+	m_settings.setValue("/Count", iMidiLearn);
+	for (int i = 0; i < iMidiLearn; ++i) {
+		m_settings.setValue(
+			QString("/Module%1").arg(i + 1), midiLearn.at(i));
+	}
 	m_settings.endGroup();
 
 	// Save display options.
@@ -220,6 +285,17 @@ void qxgeditOptions::print_usage ( const QString& arg0 )
 		QObject::tr("Show help about command line options.") + sEol;
 	out << "  -v, --version" + sEot +
 		QObject::tr("Show version information") + sEol;
+	out << "  --profile-startup" + sEot +
+		QObject::tr("Report startup phase timings on first paint, then exit") + sEol;
+	out << "  --startup-budget=<msecs>" + sEot +
+		QObject::tr("Cold-start budget (default %1 msecs)")
+			.arg(qxgeditStartup::DefaultBudget) + sEol;
+	out << "  --alloc-report" + sEot +
+		QObject::tr("Report live object and byte counts per subsystem on exit") + sEol;
+#ifdef CONFIG_TRACE
+	out << "  --trace=<file>" + sEot +
+		QObject::tr("Save hot-path trace points on exit (Chrome trace JSON)") + sEol;
+#endif
 }
 
 #endif
@@ -239,8 +315,35 @@ bool qxgeditOptions::parse_args ( const QStringList& args )
 	parser.addPositionalArgument("session-file",
 		QObject::tr("Session file (.syx)"),
 		QObject::tr("[session-file]"));
+	const QCommandLineOption profileStartupOption("profile-startup",
+		QObject::tr("Report startup phase timings on first paint, then exit."));
+	parser.addOption(profileStartupOption);
+	const QCommandLineOption startupBudgetOption("startup-budget",
+		QObject::tr("Cold-start budget (default %1 msecs).")
+			.arg(qxgeditStartup::DefaultBudget),
+		QObject::tr("msecs"));
+	parser.addOption(startupBudgetOption);
+	const QCommandLineOption allocReportOption("alloc-report",
+		QObject::tr("Report live object and byte counts per subsystem on exit."));
+	parser.addOption(allocReportOption);
+#ifdef CONFIG_TRACE
+	const QCommandLineOption traceOption("trace",
+		QObject::tr("Save hot-path trace points on exit (Chrome trace JSON)."),
+		QObject::tr("file"));
+	parser.addOption(traceOption);
+#endif
 	parser.process(args);
 
+	bProfileStartup = parser.isSet(profileStartupOption);
+	if (parser.isSet(startupBudgetOption))
+		iStartupBudget = parser.value(startupBudgetOption).toInt();
+	bAllocReport = parser.isSet(allocReportOption);
+
+#ifdef CONFIG_TRACE
+	if (parser.isSet(traceOption))
+		sTraceFile = QFileInfo(parser.value(traceOption)).absoluteFilePath();
+#endif
+
 	foreach (const QString& sArg, parser.positionalArguments()) {
 		sessionFiles.append(QFileInfo(sArg).absoluteFilePath());
 	}
@@ -277,7 +380,22 @@ bool qxgeditOptions::parse_args ( const QStringList& args )
 				.arg(QXGEDIT_TITLE)
 				.arg(PROJECT_VERSION);
 			return false;
-		} else {
+		}
+		else if (sArg == "--profile-startup") {
+			bProfileStartup = true;
+		}
+		else if (sArg.startsWith("--startup-budget=")) {
+			iStartupBudget = sArg.section('=', 1).toInt();
+		}
+		else if (sArg == "--alloc-report") {
+			bAllocReport = true;
+		}
+	#ifdef CONFIG_TRACE
+		else if (sArg.startsWith("--trace=")) {
+			sTraceFile = QFileInfo(sArg.section('=', 1)).absoluteFilePath();
+		}
+	#endif
+		else {
 			// If we don't have one by now,
 			// this will be the startup session file...
 			sessionFiles.append(QFileInfo(sArg).absoluteFilePath());
@@ -60,6 +60,16 @@ public:
 	// Startup supplied session file(s).
 	QStringList sessionFiles;
 
+	// Trace points export file (on exit; CONFIG_TRACE only).
+	QString sTraceFile;
+
+	// Startup phase profiling (report on first paint, then exit).
+	bool bProfileStartup;
+	int  iStartupBudget;
+
+	// Allocation accounting report (stderr, on exit).
+	bool bAllocReport;
+
 	// Display options...
 	bool    bConfirmReset;
 	bool    bConfirmRemove;
@@ -86,6 +96,28 @@ public:
 	QStringList midiInputs;
 	QStringList midiOutputs;
 
+	// Target device receive rate (bytes per second).
+	int iMidiRate;
+
+	// Compact send (cheapest of SysEx, NRPN or CC).
+	bool bMidiCompact;
+
+	// Live state publication (shared memory).
+	bool bPublishState;
+
+	// Concurrent model commit (MIDI input thread).
+	bool bMidiDirect;
+
+	// Output pacing (ALSA queue, at the receive rate).
+	bool bMidiPaced;
+
+	// Additional XG modules MIDI bindings.
+	QList<QStringList> moduleInputs;
+	QList<QStringList> moduleOutputs;
+
+	// MIDI Learn controller bindings (per module).
+	QList<QStringList> midiLearn;
+
 	// (QS300) USER VOICE Specific options.
 	bool bUservoiceAutoSend;
 
@@ -25,6 +25,7 @@
 #include "qxgeditOptions.h"
 
 #include "qxgeditMidiDevice.h"
+#include "qxgeditXGModule.h"
 
 #include "qxgeditPaletteForm.h"
 
@@ -91,6 +92,21 @@ qxgeditOptionsForm::qxgeditOptionsForm ( QWidget *pParent )
 	QObject::connect(m_ui.MaxRecentFilesSpinBox,
 		SIGNAL(valueChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.MidiRateSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.MidiPacedCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.MidiCompactCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.MidiDirectCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.PublishStateCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.RandomizePercentSpinBox,
 		SIGNAL(valueChanged(double)),
 		SLOT(changed()));
@@ -127,7 +143,7 @@ void qxgeditOptionsForm::setOptions ( qxgeditOptions *pOptions )
 	// Set reference descriptor.
 	m_pOptions = pOptions;
 
-	// MIDI devices listings...
+	// MIDI devices listings (current module)...
 	m_ui.MidiInputListView->clear();
 	m_ui.MidiOutputListView->clear();
 	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
@@ -135,8 +151,15 @@ void qxgeditOptionsForm::setOptions ( qxgeditOptions *pOptions )
 		m_ui.MidiInputListView->addItems(pMidiDevice->inputs());
 		m_ui.MidiOutputListView->addItems(pMidiDevice->outputs());
 	}
+	QStringList inputs  = m_pOptions->midiInputs;
+	QStringList outputs = m_pOptions->midiOutputs;
+	qxgeditXGModule *pModule = qxgeditXGModule::getInstance();
+	if (pModule) {
+		inputs  = pModule->inputs();
+		outputs = pModule->outputs();
+	}
 	// MIDI Inputs...
-	QStringListIterator ins(m_pOptions->midiInputs);
+	QStringListIterator ins(inputs);
 	while (ins.hasNext()) {
 		QListIterator<QListWidgetItem *> iter(
 			m_ui.MidiInputListView->findItems(ins.next(), Qt::MatchExactly));
@@ -144,7 +167,7 @@ void qxgeditOptionsForm::setOptions ( qxgeditOptions *pOptions )
 			iter.next()->setSelected(true);
 	}
 	// MIDI Outputs...
-	QStringListIterator outs(m_pOptions->midiOutputs);
+	QStringListIterator outs(outputs);
 	while (outs.hasNext()) {
 		QListIterator<QListWidgetItem *> iter(
 			m_ui.MidiOutputListView->findItems(outs.next(), Qt::MatchExactly));
@@ -155,6 +178,13 @@ void qxgeditOptionsForm::setOptions ( qxgeditOptions *pOptions )
 	m_iMidiInputsChanged  = 0;
 	m_iMidiOutputsChanged = 0;
 
+	// MIDI device receive rate and behavior...
+	m_ui.MidiRateSpinBox->setValue(m_pOptions->iMidiRate);
+	m_ui.MidiPacedCheckBox->setChecked(m_pOptions->bMidiPaced);
+	m_ui.MidiCompactCheckBox->setChecked(m_pOptions->bMidiCompact);
+	m_ui.MidiDirectCheckBox->setChecked(m_pOptions->bMidiDirect);
+	m_ui.PublishStateCheckBox->setChecked(m_pOptions->bPublishState);
+
 	// Other options finally.
 	m_ui.ConfirmResetCheckBox->setChecked(m_pOptions->bConfirmReset);
 	m_ui.ConfirmRemoveCheckBox->setChecked(m_pOptions->bConfirmRemove);
@@ -186,27 +216,38 @@ qxgeditOptions *qxgeditOptionsForm::options (void) const
 // Accept settings (OK button slot).
 void qxgeditOptionsForm::accept (void)
 {
-	// MIDI connections options.
+	// MIDI connections options (current module).
+	qxgeditXGModule *pModule = qxgeditXGModule::getInstance();
 	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
 	if (pMidiDevice) {
 		// MIDI Inputs...
 		if (m_iMidiInputsChanged > 0) {
-			m_pOptions->midiInputs.clear();
+			QStringList inputs;
 			QListIterator<QListWidgetItem *> iter1(
 				m_ui.MidiInputListView->selectedItems());
 			while (iter1.hasNext())
-				m_pOptions->midiInputs.append(iter1.next()->text());
-			pMidiDevice->connectInputs(m_pOptions->midiInputs);
+				inputs.append(iter1.next()->text());
+			if (pModule) {
+				pModule->setInputs(inputs);
+			} else {
+				m_pOptions->midiInputs = inputs;
+				pMidiDevice->connectInputs(inputs);
+			}
 			m_iMidiInputsChanged = 0;
 		}
 		// MIDI Outputs...
 		if (m_iMidiOutputsChanged > 0) {
-			m_pOptions->midiOutputs.clear();
+			QStringList outputs;
 			QListIterator<QListWidgetItem *> iter2(
 				m_ui.MidiOutputListView->selectedItems());
 			while (iter2.hasNext())
-				m_pOptions->midiOutputs.append(iter2.next()->text());
-			pMidiDevice->connectOutputs(m_pOptions->midiOutputs);
+				outputs.append(iter2.next()->text());
+			if (pModule) {
+				pModule->setOutputs(outputs);
+			} else {
+				m_pOptions->midiOutputs = outputs;
+				pMidiDevice->connectOutputs(outputs);
+			}
 			m_iMidiOutputsChanged = 0;
 		}
 	}
@@ -220,6 +261,12 @@ void qxgeditOptionsForm::accept (void)
 		m_pOptions->iMaxRecentFiles = m_ui.MaxRecentFilesSpinBox->value();
 		m_pOptions->fRandomizePercent = float(m_ui.RandomizePercentSpinBox->value());
 		m_pOptions->iBaseFontSize   = m_ui.BaseFontSizeComboBox->currentText().toInt();
+		// MIDI options...
+		m_pOptions->iMidiRate     = m_ui.MidiRateSpinBox->value();
+		m_pOptions->bMidiPaced    = m_ui.MidiPacedCheckBox->isChecked();
+		m_pOptions->bMidiCompact  = m_ui.MidiCompactCheckBox->isChecked();
+		m_pOptions->bMidiDirect   = m_ui.MidiDirectCheckBox->isChecked();
+		m_pOptions->bPublishState = m_ui.PublishStateCheckBox->isChecked();
 		// Custom options...
 		if (m_ui.StyleThemeComboBox->currentIndex() > 0)
 			m_pOptions->sStyleTheme = m_ui.StyleThemeComboBox->currentText();
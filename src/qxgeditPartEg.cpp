@@ -22,6 +22,8 @@
 #include "qxgeditAbout.h"
 #include "qxgeditPartEg.h"
 
+#include "qxgeditTrace.h"
+
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
@@ -98,6 +100,8 @@ unsigned short qxgeditPartEg::release (void) const
 // Draw curve.
 void qxgeditPartEg::paintEvent ( QPaintEvent *pPaintEvent )
 {
+	QXGEDIT_TRACE("qxgeditPartEg::paintEvent");
+
 	QPainter painter(this);
 
 	const int h  = height();
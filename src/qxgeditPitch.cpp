@@ -22,6 +22,8 @@
 #include "qxgeditAbout.h"
 #include "qxgeditPitch.h"
 
+#include "qxgeditTrace.h"
+
 #include <QPainter>
 #include <QMouseEvent>
 
@@ -114,6 +116,8 @@ unsigned short qxgeditPitch::releaseLevel (void) const
 // Draw curve.
 void qxgeditPitch::paintEvent ( QPaintEvent *pPaintEvent )
 {
+	QXGEDIT_TRACE("qxgeditPitch::paintEvent");
+
 	QPainter painter(this);
 
 	const int h  = height();
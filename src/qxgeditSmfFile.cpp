@@ -0,0 +1,184 @@
+// qxgeditSmfFile.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditSmfFile.h"
+
+#include <QFile>
+
+
+//----------------------------------------------------------------------------
+// qxgeditSmfFile -- Standard MIDI File (SMF format 0) setup sequence.
+
+// Constructor.
+qxgeditSmfFile::qxgeditSmfFile ( unsigned int iRate )
+	: m_iRate(DefaultRate), m_iDelta(0), m_iTime(0), m_iCount(0)
+{
+	setRate(iRate);
+}
+
+
+// Target device receive rate (bytes per second).
+void qxgeditSmfFile::setRate ( unsigned int iRate )
+{
+	// Never faster than the MIDI wire (31250 baud, 10 bits/byte)...
+	if (iRate < 1)
+		iRate = DefaultRate;
+	else
+	if (iRate > MaxRate)
+		iRate = MaxRate;
+
+	m_iRate = iRate;
+}
+
+unsigned int qxgeditSmfFile::rate (void) const
+{
+	return m_iRate;
+}
+
+
+// Append a SysEx message, with an extra settle time (msecs).
+void qxgeditSmfFile::addSysex (
+	const unsigned char *data, unsigned short size, unsigned int iSettle )
+{
+	if (data == nullptr || size < 2 || data[0] != 0xf0)
+		return;
+
+	// Delta-time, from the previous message...
+	writeVarLen(m_events, m_iDelta);
+
+	// SysEx event: F0 <length> <data...F7>
+	m_events.append(char(0xf0));
+	writeVarLen(m_events, size - 1);
+	m_events.append((const char *) data + 1, size - 1);
+
+	// Next delta-time is this message transmit time (rounded up),
+	// plus the time the device needs to settle afterwards...
+	m_iDelta = (1000UL * size + m_iRate - 1) / m_iRate + iSettle;
+	m_iTime += m_iDelta;
+
+	++m_iCount;
+}
+
+
+// Total sequence duration (msecs).
+unsigned long qxgeditSmfFile::duration (void) const
+{
+	return m_iTime;
+}
+
+
+// Number of events so far.
+int qxgeditSmfFile::count (void) const
+{
+	return m_iCount;
+}
+
+
+// Reset sequence.
+void qxgeditSmfFile::clear (void)
+{
+	m_events.clear();
+
+	m_iDelta = 0;
+	m_iTime  = 0;
+	m_iCount = 0;
+}
+
+
+// Write down the whole thing.
+bool qxgeditSmfFile::save (
+	const QString& sFilename, const QString& sName ) const
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	QByteArray track;
+
+	// Track name meta-event...
+	const QByteArray& name = sName.toUtf8();
+	writeVarLen(track, 0);
+	track.append(char(0xff));
+	track.append(char(0x03));
+	writeVarLen(track, name.length());
+	track.append(name);
+
+	// Tempo meta-event (one tick per msec)...
+	writeVarLen(track, 0);
+	track.append(char(0xff));
+	track.append(char(0x51));
+	track.append(char(0x03));
+	writeInt(track, MicrosPerBeat, 3);
+
+	// The setup sequence itself...
+	track.append(m_events);
+
+	// End-of-track meta-event, after the last transmit time...
+	writeVarLen(track, m_iDelta);
+	track.append(char(0xff));
+	track.append(char(0x2f));
+	track.append(char(0x00));
+
+	QByteArray data;
+
+	// Header chunk (format 0, one track)...
+	data.append("MThd", 4);
+	writeInt(data, 6, 4);
+	writeInt(data, 0, 2);
+	writeInt(data, 1, 2);
+	writeInt(data, TicksPerBeat, 2);
+
+	// Track chunk...
+	data.append("MTrk", 4);
+	writeInt(data, track.length(), 4);
+	data.append(track);
+
+	const bool bResult = (file.write(data) == data.length());
+
+	file.close();
+
+	return bResult;
+}
+
+
+// Encoding helpers.
+void qxgeditSmfFile::writeVarLen ( QByteArray& data, unsigned long val )
+{
+	unsigned char buf[4];
+	int n = 0;
+
+	buf[n++] = (val & 0x7f);
+	while ((val >>= 7) > 0 && n < 4)
+		buf[n++] = (val & 0x7f) | 0x80;
+
+	while (n > 0)
+		data.append(char(buf[--n]));
+}
+
+
+void qxgeditSmfFile::writeInt ( QByteArray& data, unsigned long val, int n )
+{
+	while (--n >= 0)
+		data.append(char((val >> (n << 3)) & 0xff));
+}
+
+
+// end of qxgeditSmfFile.cpp
@@ -0,0 +1,94 @@
+// qxgeditSmfFile.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditSmfFile_h
+#define __qxgeditSmfFile_h
+
+#include <QByteArray>
+#include <QString>
+
+
+//----------------------------------------------------------------------------
+// qxgeditSmfFile -- Standard MIDI File (SMF format 0) setup sequence.
+//
+// Each SysEx message gets its own delta-time, computed from the
+// message byte length and the target device receive rate, so that
+// a sequencer playing it back won't overflow the module buffer.
+
+class qxgeditSmfFile
+{
+public:
+
+	// Constructor.
+	qxgeditSmfFile(unsigned int iRate = DefaultRate);
+
+	// Target device receive rate (bytes per second).
+	void setRate(unsigned int iRate);
+	unsigned int rate() const;
+
+	// Append a SysEx message, with an extra settle time (msecs).
+	void addSysex(const unsigned char *data, unsigned short size,
+		unsigned int iSettle = 0);
+
+	// Total sequence duration (msecs).
+	unsigned long duration() const;
+
+	// Number of events so far.
+	int count() const;
+
+	// Reset sequence.
+	void clear();
+
+	// Write down the whole thing.
+	bool save(const QString& sFilename, const QString& sName) const;
+
+	// Target device receive rates (bytes per second): a conservative
+	// module processing rate by default, never above the MIDI wire
+	// (31250 baud, 10 bits per byte).
+	static const unsigned int DefaultRate = 1000;
+	static const unsigned int MaxRate = 3125;
+
+	// SMF timing: one tick per msec.
+	static const unsigned short TicksPerBeat = 480;
+	static const unsigned long  MicrosPerBeat = 480000;
+
+protected:
+
+	// Encoding helpers.
+	static void writeVarLen(QByteArray& data, unsigned long val);
+	static void writeInt(QByteArray& data, unsigned long val, int n);
+
+private:
+
+	// Instance variables.
+	unsigned int  m_iRate;
+	unsigned long m_iDelta;
+	unsigned long m_iTime;
+	int           m_iCount;
+
+	QByteArray    m_events;
+};
+
+
+#endif	// __qxgeditSmfFile_h
+
+
+// end of qxgeditSmfFile.h
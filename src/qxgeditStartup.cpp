@@ -0,0 +1,165 @@
+// qxgeditStartup.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditStartup.h"
+
+#include <QApplication>
+#include <QWidget>
+#include <QEvent>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <cstdio>
+#include <cstring>
+
+
+//----------------------------------------------------------------------------
+// Startup phases (main thread only).
+
+static const int c_iMaxPhases = 16;
+
+static struct
+{
+	const char *name;
+	qint64 nsecs;
+
+} g_phases[c_iMaxPhases];
+
+static int g_iPhases = 0;
+
+static qint64 g_iLastMark = 0;
+
+static bool g_bFinished = false;
+
+
+// Process start clock (as early as static initialization goes).
+static struct qxgeditStartupClock
+{
+	qxgeditStartupClock() { timer.start(); }
+
+	QElapsedTimer timer;
+
+} g_clock;
+
+
+//----------------------------------------------------------------------------
+// qxgeditStartup -- Startup phase profiler (--profile-startup).
+
+// Constructor.
+qxgeditStartup::qxgeditStartup ( QWidget *pWidget, int iBudget )
+	: QObject(pWidget), m_pWidget(pWidget), m_iBudget(iBudget)
+{
+	m_pWidget->installEventFilter(this);
+}
+
+
+// Phase boundary (name must be a string literal).
+void qxgeditStartup::mark ( const char *name )
+{
+	if (g_bFinished)
+		return;
+
+	const qint64 t = g_clock.timer.nsecsElapsed();
+	const qint64 dt = t - g_iLastMark;
+	g_iLastMark = t;
+
+	for (int i = 0; i < g_iPhases; ++i) {
+		if (::strcmp(g_phases[i].name, name) == 0) {
+			g_phases[i].nsecs += dt;
+			return;
+		}
+	}
+
+	if (g_iPhases < c_iMaxPhases) {
+		g_phases[g_iPhases].name  = name;
+		g_phases[g_iPhases].nsecs = dt;
+		++g_iPhases;
+	}
+}
+
+
+// Startup is over: no more marks from now on.
+void qxgeditStartup::finish (void)
+{
+	g_bFinished = true;
+}
+
+
+// Profile mode: report on first paint, then exit.
+void qxgeditStartup::profile ( QWidget *pWidget, int iBudget )
+{
+	if (pWidget)
+		new qxgeditStartup(pWidget, iBudget);
+}
+
+
+// Phase breakdown report (stderr); true if within budget.
+bool qxgeditStartup::report ( int iBudget )
+{
+	finish();
+
+	const double total = double(g_iLastMark) / 1000000.0;
+
+	::fprintf(stderr, "\nStartup profile (msecs):\n\n");
+	::fprintf(stderr, "  %-20s %10s %10s %7s\n",
+		"phase", "time", "elapsed", "share");
+
+	qint64 elapsed = 0;
+	for (int i = 0; i < g_iPhases; ++i) {
+		elapsed += g_phases[i].nsecs;
+		const double msecs = double(g_phases[i].nsecs) / 1000000.0;
+		::fprintf(stderr, "  %-20s %10.3f %10.3f %6.1f%%\n",
+			g_phases[i].name, msecs, double(elapsed) / 1000000.0,
+			(total > 0.0 ? 100.0 * msecs / total : 0.0));
+	}
+
+	const bool bBudget = (iBudget < 1 || total <= double(iBudget));
+
+	::fprintf(stderr, "\n  %-20s %10.3f (budget %d): %s\n\n",
+		"total", total, iBudget, bBudget ? "ok" : "OVER BUDGET");
+
+	return bBudget;
+}
+
+
+// First paint watcher.
+bool qxgeditStartup::eventFilter ( QObject *pObject, QEvent *pEvent )
+{
+	if (pObject == m_pWidget && pEvent->type() == QEvent::Paint) {
+		m_pWidget->removeEventFilter(this);
+		// Report right after this paint gets done...
+		QTimer::singleShot(0, this, SLOT(painted()));
+	}
+
+	return QObject::eventFilter(pObject, pEvent);
+}
+
+
+// First paint done.
+void qxgeditStartup::painted (void)
+{
+	mark("first paint");
+
+	QApplication::exit(report(m_iBudget) ? 0 : 3);
+}
+
+
+// end of qxgeditStartup.cpp
@@ -0,0 +1,89 @@
+// qxgeditStartup.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditStartup_h
+#define __qxgeditStartup_h
+
+#include <QObject>
+
+
+// Forward declarations.
+class QWidget;
+class QEvent;
+
+
+//----------------------------------------------------------------------------
+// qxgeditStartup -- Startup phase profiler (--profile-startup).
+//
+// Phase marks are always taken (a handful of clock reads, no allocation);
+// the time elapsed since the previous mark is accounted to the named
+// phase, adding up when the same phase is marked again (eg. per module).
+// Only in profile mode the breakdown gets reported, on first paint.
+// Once startup is over, later marks (eg. modules added at runtime)
+// are simply ignored.
+
+class qxgeditStartup : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Phase boundary (name must be a string literal).
+	static void mark(const char *name);
+
+	// Startup is over: no more marks from now on.
+	static void finish();
+
+	// Profile mode: report on the first paint of the given
+	// widget, then exit (status 0 if within budget, 3 otherwise).
+	static void profile(QWidget *pWidget, int iBudget);
+
+	// Default cold-start budget (msecs, from process start to first paint).
+	static const int DefaultBudget = 1500;
+
+	// Phase breakdown report (stderr); true if within budget.
+	static bool report(int iBudget);
+
+protected:
+
+	// Constructor.
+	qxgeditStartup(QWidget *pWidget, int iBudget);
+
+	// First paint watcher.
+	bool eventFilter(QObject *pObject, QEvent *pEvent);
+
+protected slots:
+
+	// First paint done.
+	void painted();
+
+private:
+
+	// Instance variables.
+	QWidget *m_pWidget;
+	int      m_iBudget;
+};
+
+
+#endif	// __qxgeditStartup_h
+
+
+// end of qxgeditStartup.h
@@ -0,0 +1,204 @@
+// qxgeditTrace.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditTrace.h"
+
+#ifdef CONFIG_TRACE
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutex>
+#include <QFile>
+#include <QTextStream>
+#include <QList>
+
+#include <atomic>
+#include <chrono>
+
+
+//----------------------------------------------------------------------------
+// qxgeditTrace -- Per-thread ring buffers.
+
+struct qxgeditTraceEvent
+{
+	const char *name;
+	long long   begin;
+	long long   end;
+};
+
+
+struct qxgeditTraceBuffer
+{
+	qxgeditTraceBuffer ( int iTid, const QString& sName )
+		: tid(iTid), name(sName), count(0) {}
+
+	int     tid;
+	QString name;
+
+	// Total recorded so far (owner thread is the sole writer).
+	std::atomic<unsigned int> count;
+
+	qxgeditTraceEvent events[qxgeditTrace::MaxEvents];
+};
+
+
+// All buffers ever attached (registration is the only locked path).
+class qxgeditTraceRegistry
+{
+public:
+
+	~qxgeditTraceRegistry()
+		{ qDeleteAll(buffers); }
+
+	qxgeditTraceBuffer *attach ()
+	{
+		QString sName;
+		QThread *pThread = QThread::currentThread();
+		if (pThread) {
+			sName = pThread->objectName();
+			if (sName.isEmpty()) {
+				QCoreApplication *pApp = QCoreApplication::instance();
+				if (pApp && pApp->thread() == pThread)
+					sName = "main";
+				else
+					sName = pThread->metaObject()->className();
+			}
+		}
+
+		QMutexLocker locker(&mutex);
+		qxgeditTraceBuffer *pBuffer
+			= new qxgeditTraceBuffer(buffers.count() + 1, sName);
+		buffers.append(pBuffer);
+		return pBuffer;
+	}
+
+	QMutex mutex;
+	QList<qxgeditTraceBuffer *> buffers;
+};
+
+
+static qxgeditTraceRegistry& qxgedit_trace_registry (void)
+{
+	static qxgeditTraceRegistry g_registry;
+	return g_registry;
+}
+
+
+// Current thread buffer (lazily attached).
+static thread_local qxgeditTraceBuffer *g_pTraceBuffer = nullptr;
+
+// Clock origin.
+static const std::chrono::steady_clock::time_point g_traceEpoch
+	= std::chrono::steady_clock::now();
+
+
+//----------------------------------------------------------------------------
+// qxgeditTrace -- Per-thread trace event recorder.
+
+// Monotonic clock (nsecs, since first use).
+long long qxgeditTrace::now (void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds> (
+		std::chrono::steady_clock::now() - g_traceEpoch).count();
+}
+
+
+// Record one complete event (calling thread).
+void qxgeditTrace::record ( const char *name, long long begin, long long end )
+{
+	qxgeditTraceBuffer *pBuffer = g_pTraceBuffer;
+	if (pBuffer == nullptr) {
+		pBuffer = qxgedit_trace_registry().attach();
+		g_pTraceBuffer = pBuffer;
+	}
+
+	const unsigned int i = pBuffer->count.load(std::memory_order_relaxed);
+	qxgeditTraceEvent& event = pBuffer->events[i & (MaxEvents - 1)];
+	event.name  = name;
+	event.begin = begin;
+	event.end   = end;
+	pBuffer->count.store(i + 1, std::memory_order_release);
+}
+
+
+// Discard all recorded events (all threads).
+void qxgeditTrace::clear (void)
+{
+	qxgeditTraceRegistry& registry = qxgedit_trace_registry();
+	QMutexLocker locker(&registry.mutex);
+
+	foreach (qxgeditTraceBuffer *pBuffer, registry.buffers)
+		pBuffer->count.store(0, std::memory_order_release);
+}
+
+
+// Export all recorded events as Chrome trace JSON.
+bool qxgeditTrace::save ( const QString& sFilename )
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+
+	QTextStream ts(&file);
+	ts.setRealNumberNotation(QTextStream::FixedNotation);
+	ts.setRealNumberPrecision(3);
+
+	ts << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+	qxgeditTraceRegistry& registry = qxgedit_trace_registry();
+	QMutexLocker locker(&registry.mutex);
+
+	bool bFirst = true;
+	foreach (qxgeditTraceBuffer *pBuffer, registry.buffers) {
+		// Thread name (metadata)...
+		if (!bFirst)
+			ts << ",\n";
+		bFirst = false;
+		ts << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< pBuffer->tid << ",\"args\":{\"name\":\""
+			<< pBuffer->name << "\"}}";
+		// Complete events (the last ones only, when wrapped around)...
+		const unsigned int n = pBuffer->count.load(std::memory_order_acquire);
+		const unsigned int i0 = (n > MaxEvents ? n - MaxEvents : 0);
+		for (unsigned int i = i0; i < n; ++i) {
+			const qxgeditTraceEvent& event
+				= pBuffer->events[i & (MaxEvents - 1)];
+			ts << ",\n{\"name\":\"" << event.name
+				<< "\",\"cat\":\"qxgedit\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+				<< pBuffer->tid
+				<< ",\"ts\":" << double(event.begin) / 1000.0
+				<< ",\"dur\":" << double(event.end - event.begin) / 1000.0
+				<< '}';
+		}
+	}
+
+	ts << "\n]}\n";
+	ts.flush();
+
+	file.close();
+	return true;
+}
+
+
+#endif	// CONFIG_TRACE
+
+
+// end of qxgeditTrace.cpp
@@ -0,0 +1,94 @@
+// qxgeditTrace.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditTrace_h
+#define __qxgeditTrace_h
+
+#include "config.h"
+
+
+//----------------------------------------------------------------------------
+// QXGEDIT_TRACE -- Scoped hot-path trace point.
+//
+// Expands to nothing unless configured with CONFIG_TRACE; otherwise
+// records one complete (begin, duration) event into the calling thread
+// own ring buffer, on scope exit. The name must be a string literal.
+
+#ifdef CONFIG_TRACE
+
+#define QXGEDIT_TRACE_CAT2(a, b) a##b
+#define QXGEDIT_TRACE_CAT(a, b)  QXGEDIT_TRACE_CAT2(a, b)
+
+#define QXGEDIT_TRACE(name) \
+	qxgeditTrace::Scope QXGEDIT_TRACE_CAT(qxgedit_trace_, __LINE__)(name)
+
+#include <QString>
+
+
+//----------------------------------------------------------------------------
+// qxgeditTrace -- Per-thread trace event recorder.
+
+class qxgeditTrace
+{
+public:
+
+	// Scoped trace point.
+	class Scope
+	{
+	public:
+
+		Scope(const char *name) : m_name(name), m_begin(now()) {}
+		~Scope() { record(m_name, m_begin, now()); }
+
+	private:
+
+		const char *m_name;
+		long long   m_begin;
+	};
+
+	// Monotonic clock (nsecs, since first use).
+	static long long now();
+
+	// Record one complete event (calling thread).
+	static void record(const char *name, long long begin, long long end);
+
+	// Discard all recorded events (all threads).
+	static void clear();
+
+	// Export all recorded events as Chrome trace JSON
+	// (chrome://tracing, ui.perfetto.dev); best run when quiet.
+	static bool save(const QString& sFilename);
+
+	// Per-thread ring buffer capacity (events, power of two).
+	static const unsigned int MaxEvents = 65536;
+};
+
+#else
+
+#define QXGEDIT_TRACE(name)
+
+#endif	// CONFIG_TRACE
+
+
+#endif	// __qxgeditTrace_h
+
+
+// end of qxgeditTrace.h
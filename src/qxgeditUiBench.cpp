@@ -0,0 +1,386 @@
+// qxgeditUiBench.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+
+#include "qxgeditOptions.h"
+#include "qxgeditMainForm.h"
+#include "qxgeditXGMasterMap.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QComboBox>
+#include <QTabWidget>
+#include <QEvent>
+
+#include <algorithm>
+#include <cstdio>
+
+
+//-------------------------------------------------------------------------
+// qxgeditUiBenchFilter - Application wide paint event counter.
+
+class qxgeditUiBenchFilter : public QObject
+{
+public:
+
+	qxgeditUiBenchFilter() : QObject(nullptr), paints(0) {}
+
+	unsigned long paints;
+
+protected:
+
+	bool eventFilter(QObject *pObject, QEvent *pEvent)
+	{
+		if (pEvent->type() == QEvent::Paint)
+			++paints;
+		return QObject::eventFilter(pObject, pEvent);
+	}
+};
+
+
+//-------------------------------------------------------------------------
+// qxgeditUiBench - Scripted operations context.
+
+struct qxgeditUiBench
+{
+	qxgeditMainForm *form;
+	qxgeditUiBenchFilter *filter;
+	QString session;
+};
+
+typedef void (*qxgedit_uibench_op) ( qxgeditUiBench& bench, int i );
+
+static bool g_uibench_csv = false;
+
+
+// Current master map shortcut.
+static qxgeditXGMasterMap *qxgedit_uibench_map (void)
+{
+	return qxgeditXGMasterMap::getInstance();
+}
+
+
+// Bring some widget's tab page(s) to front.
+static void qxgedit_uibench_show ( qxgeditUiBench& bench, const char *name )
+{
+	QWidget *pWidget = bench.form->findChild<QWidget *> (name);
+	for (QWidget *pPage = pWidget; pPage; pPage = pPage->parentWidget()) {
+		QWidget *pStack = pPage->parentWidget();
+		if (pStack == nullptr)
+			break;
+		QTabWidget *pTabWidget
+			= qobject_cast<QTabWidget *> (pStack->parentWidget());
+		if (pTabWidget && pTabWidget->indexOf(pPage) >= 0)
+			pTabWidget->setCurrentWidget(pPage);
+	}
+}
+
+
+// Switch a combo-box to its next item, as if activated by the user.
+static void qxgedit_uibench_combo ( qxgeditUiBench& bench,
+	const char *name, const char *slot )
+{
+	qxgedit_uibench_show(bench, name);
+
+	QComboBox *pComboBox = bench.form->findChild<QComboBox *> (name);
+	if (pComboBox == nullptr || pComboBox->count() < 1)
+		return;
+
+	const int iIndex = (pComboBox->currentIndex() + 1) % pComboBox->count();
+	pComboBox->setCurrentIndex(iIndex);
+	QMetaObject::invokeMethod(bench.form, slot, Q_ARG(int, iIndex));
+}
+
+
+// Switch an effect map type to the next one.
+static void qxgedit_uibench_effect ( qxgeditUiBench& bench,
+	const char *name, XGParamMap& map )
+{
+	qxgedit_uibench_show(bench, name);
+
+	XGParam *pParam = map.key_param();
+	if (pParam == nullptr)
+		return;
+
+	const QList<unsigned short>& keys = map.keys().keys();
+	if (keys.isEmpty())
+		return;
+
+	const int iKey = (keys.indexOf(pParam->value()) + 1) % keys.count();
+	pParam->set_value(keys.at(iKey));
+}
+
+
+//-------------------------------------------------------------------------
+// The scripted operations.
+
+static void qxgedit_uibench_load ( qxgeditUiBench& bench, int )
+{
+	bench.form->loadSessionFile(bench.session);
+}
+
+static void qxgedit_uibench_reset_all ( qxgeditUiBench&, int )
+{
+	qxgedit_uibench_map()->reset_all();
+}
+
+static void qxgedit_uibench_randomize_part ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_show(bench, "MultipartCombo");
+	qxgeditXGMasterMap *pMasterMap = qxgedit_uibench_map();
+	pMasterMap->randomize_part(pMasterMap->MULTIPART.current_key(), 100.0f);
+}
+
+static void qxgedit_uibench_randomize_drums ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_show(bench, "DrumsetupNoteCombo");
+	qxgeditXGMasterMap *pMasterMap = qxgedit_uibench_map();
+	const unsigned short key = pMasterMap->DRUMSETUP.current_key();
+	pMasterMap->randomize_drums(key >> 7, key & 0x7f, 100.0f);
+}
+
+static void qxgedit_uibench_randomize_user ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_show(bench, "UservoiceCombo");
+	qxgeditXGMasterMap *pMasterMap = qxgedit_uibench_map();
+	pMasterMap->randomize_user(pMasterMap->USERVOICE.current_key(), 100.0f);
+}
+
+static void qxgedit_uibench_multipart ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_combo(bench, "MultipartCombo", "multipartComboActivated");
+}
+
+static void qxgedit_uibench_drumnote ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_combo(bench, "DrumsetupNoteCombo", "drumsetupNoteComboActivated");
+}
+
+static void qxgedit_uibench_uservoice ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_combo(bench, "UservoiceCombo", "uservoiceComboActivated");
+}
+
+static void qxgedit_uibench_reverb ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_effect(bench, "ReverbTypeCombo", qxgedit_uibench_map()->REVERB);
+}
+
+static void qxgedit_uibench_chorus ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_effect(bench, "ChorusTypeCombo", qxgedit_uibench_map()->CHORUS);
+}
+
+static void qxgedit_uibench_variation ( qxgeditUiBench& bench, int )
+{
+	qxgedit_uibench_effect(bench, "VariationTypeCombo", qxgedit_uibench_map()->VARIATION);
+}
+
+
+//-------------------------------------------------------------------------
+// Operation timing: the stall is from the operation call until the
+// event loop has painted everything it brought about (idle again).
+
+static void qxgedit_uibench_settle ( qxgeditUiBench& bench )
+{
+	for (int k = 0; k < 16; ++k) {
+		const unsigned long paints = bench.filter->paints;
+		QCoreApplication::processEvents(QEventLoop::AllEvents);
+		QCoreApplication::sendPostedEvents();
+		QCoreApplication::processEvents(QEventLoop::AllEvents);
+		if (bench.filter->paints == paints)
+			break;
+	}
+}
+
+
+static bool qxgedit_uibench_run ( qxgeditUiBench& bench, const char *name,
+	qxgedit_uibench_op op, int iRepeat, double fBudget )
+{
+	QElapsedTimer timer;
+
+	QList<double> stalls;
+	double fBlocked = 0.0;
+	unsigned long paints = 0;
+
+	for (int i = 0; i < iRepeat; ++i) {
+		qxgedit_uibench_settle(bench);
+		const unsigned long paints0 = bench.filter->paints;
+		timer.start();
+		(*op)(bench, i);
+		const double t1 = double(timer.nsecsElapsed()) / 1e6;
+		qxgedit_uibench_settle(bench);
+		const double t2 = double(timer.nsecsElapsed()) / 1e6;
+		stalls.append(t2);
+		if (fBlocked < t1)
+			fBlocked = t1;
+		paints += bench.filter->paints - paints0;
+	}
+
+	std::sort(stalls.begin(), stalls.end());
+	const double fMedian = stalls.at(stalls.count() / 2);
+	const double fMax = stalls.last();
+	const bool bOk = (fMax <= fBudget);
+
+	if (g_uibench_csv) {
+		::printf("%s,%d,%.2f,%.2f,%.2f,%lu,%.1f,%s\n",
+			name, iRepeat, fMedian, fMax, fBlocked,
+			paints / iRepeat, fBudget, bOk ? "ok" : "FAIL");
+	} else {
+		::printf("%-16s %6d %10.2f %10.2f %10.2f %8lu %8.1f  %s\n",
+			name, iRepeat, fMedian, fMax, fBlocked,
+			paints / iRepeat, fBudget, bOk ? "ok" : "FAIL");
+	}
+
+	::fflush(stdout);
+
+	return bOk;
+}
+
+
+//-------------------------------------------------------------------------
+// main - The offscreen GUI responsiveness suite trunk.
+//
+// Usage: qxgedit_uibench [--budget ms] [--repeat n] [--csv]
+//
+// Instantiates the main form on the offscreen platform, scripts the
+// heavy batch operations and reports each one stall time (median and
+// worst, in ms), the longest synchronous part alone and the paint
+// events it brought about; exits non-zero when any operation worst
+// stall exceeds the frame budget.
+
+int main ( int argc, char **argv )
+{
+	Q_INIT_RESOURCE(qxgedit);
+
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+
+	double fBudget = 100.0;
+	int iRepeat = 5;
+
+	const QStringList& args = app.arguments();
+	for (int i = 1; i < args.count(); ++i) {
+		const QString& sArg = args.at(i);
+		if (sArg == "--csv")
+			g_uibench_csv = true;
+		else
+		if (sArg == "--budget" && i + 1 < args.count())
+			fBudget = args.at(++i).toDouble();
+		else
+		if (sArg == "--repeat" && i + 1 < args.count())
+			iRepeat = args.at(++i).toInt();
+	}
+	if (iRepeat < 1)
+		iRepeat = 1;
+
+	// Keep away from the user settings...
+	QTemporaryDir tmpdir;
+	QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, tmpdir.path());
+	QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, tmpdir.path());
+
+	qxgeditOptions options;
+
+	qxgeditMainForm w;
+	w.setup(&options);
+	w.resize(1280, 800);
+	w.show();
+
+	qxgeditUiBenchFilter filter;
+	app.installEventFilter(&filter);
+
+	qxgeditUiBench bench;
+	bench.form = &w;
+	bench.filter = &filter;
+	bench.session = tmpdir.filePath("uibench.syx");
+
+	qxgeditXGMasterMap *pMasterMap = qxgedit_uibench_map();
+	if (pMasterMap == nullptr) {
+		::fprintf(stderr, "qxgedit_uibench: no master map.\n");
+		return 1;
+	}
+
+	// A busy session to load back, all parts randomized...
+	for (unsigned short iPart = 0; iPart < 16; ++iPart)
+		pMasterMap->randomize_part(iPart, 100.0f);
+	if (!w.saveSessionFile(bench.session)) {
+		::fprintf(stderr, "qxgedit_uibench: could not save session.\n");
+		return 1;
+	}
+
+	qxgedit_uibench_settle(bench);
+
+	if (g_uibench_csv) {
+		::printf("name,repeat,median_ms,max_ms,blocked_ms,paints,budget_ms,status\n");
+	} else {
+		::printf("%-16s %6s %10s %10s %10s %8s %8s  %s\n",
+			"operation", "repeat", "median ms", "max ms",
+			"blocked ms", "paints", "budget", "status");
+	}
+
+	int iFailed = 0;
+
+	if (!qxgedit_uibench_run(bench, "load_session",
+			qxgedit_uibench_load, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "reset_all",
+			qxgedit_uibench_reset_all, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "randomize_part",
+			qxgedit_uibench_randomize_part, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "randomize_drums",
+			qxgedit_uibench_randomize_drums, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "randomize_user",
+			qxgedit_uibench_randomize_user, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "multipart_part",
+			qxgedit_uibench_multipart, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "drumsetup_note",
+			qxgedit_uibench_drumnote, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "uservoice_user",
+			qxgedit_uibench_uservoice, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "reverb_type",
+			qxgedit_uibench_reverb, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "chorus_type",
+			qxgedit_uibench_chorus, iRepeat, fBudget))
+		++iFailed;
+	if (!qxgedit_uibench_run(bench, "variation_type",
+			qxgedit_uibench_variation, iRepeat, fBudget))
+		++iFailed;
+
+	app.removeEventFilter(&filter);
+
+	return (iFailed > 0 ? 1 : 0);
+}
+
+
+// end of qxgeditUiBench.cpp
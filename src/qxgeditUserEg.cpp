@@ -22,6 +22,8 @@
 #include "qxgeditAbout.h"
 #include "qxgeditUserEg.h"
 
+#include "qxgeditTrace.h"
+
 #include <QPainter>
 #include <QMouseEvent>
 
@@ -189,6 +191,8 @@ unsigned short qxgeditUserEg::rate4 (void) const
 // Draw curve.
 void qxgeditUserEg::paintEvent ( QPaintEvent *pPaintEvent )
 {
+	QXGEDIT_TRACE("qxgeditUserEg::paintEvent");
+
 	QPainter painter(this);
 
 	const int h  = height();
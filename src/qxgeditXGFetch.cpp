@@ -0,0 +1,390 @@
+// qxgeditXGFetch.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditXGFetch.h"
+
+#include "qxgeditXGMasterMap.h"
+#include "qxgeditMidiDevice.h"
+
+
+// Response timeout bounds (msecs) and maximum retries.
+static const int c_iMinTimeout  = 50;
+static const int c_iMaxTimeout  = 2000;
+static const int c_iMaxRetries  = 2;
+
+// Initial response time estimate (msecs).
+static const int c_iResponseTime = 100;
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGFetch -- XG device state fetch (pull) engine.
+
+// Constructor.
+qxgeditXGFetch::qxgeditXGFetch (
+	qxgeditXGMasterMap *pMasterMap, QObject *pParent )
+	: QObject(pParent), m_pMasterMap(pMasterMap),
+		m_iRequest(-1), m_iRetry(0), m_iBlocks(0), m_iDone(0), m_iFailed(0),
+		m_iFailedGroups(0), m_iDoneGroups(0), m_bBlockAnswered(false),
+		m_iResponseTime(c_iResponseTime)
+{
+	m_timer.setSingleShot(true);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(timeout()));
+}
+
+
+// Destructor.
+qxgeditXGFetch::~qxgeditXGFetch (void)
+{
+	cancel();
+}
+
+
+// Target master map accessor.
+qxgeditXGMasterMap *qxgeditXGFetch::masterMap (void) const
+{
+	return m_pMasterMap;
+}
+
+
+// Engine control.
+bool qxgeditXGFetch::start ( int iGroups )
+{
+	cancel();
+
+	if (m_pMasterMap == nullptr || m_pMasterMap->midi_device() == nullptr)
+		return false;
+
+	m_iBlocks = 0;
+	m_iDone   = 0;
+	m_iFailed = 0;
+
+	m_iFailedGroups = 0;
+	m_iDoneGroups   = 0;
+
+	m_bBlockAnswered = false;
+
+	unsigned short i, j;
+
+	// SYSTEM...
+	if (iGroups & System)
+		addBlock(System, 0x00, 0x00, 0x00);
+
+	// EFFECT (REVERB, CHORUS, VARIATION)...
+	if (iGroups & Effect) {
+		addBlock(Effect, 0x02, 0x01, 0x00);
+		addBlock(Effect, 0x02, 0x01, 0x20);
+		addBlock(Effect, 0x02, 0x01, 0x40);
+	}
+
+	// MULTIPART...
+	if (iGroups & Multipart) {
+		for (i = 0; i < 16; ++i)
+			addBlock(Multipart, 0x08, i, 0x00);
+	}
+
+	// DRUMSETUP...
+	if (iGroups & Drumsetup) {
+		for (i = 0; i < 2; ++i) {
+			for (j = 13; j < 85; ++j)
+				addBlock(Drumsetup, 0x30 + i, j, 0x00);
+		}
+	}
+
+	// (QS300) USERVOICE...
+	if (iGroups & Uservoice) {
+		for (i = 0; i < 32; ++i)
+			addBlock(Uservoice, 0x11, i, 0x00);
+	}
+
+	if (m_requests.isEmpty())
+		return false;
+
+	m_iRequest = 0;
+	m_iRetry = 0;
+
+	// Responses must all get through process()...
+	m_pMasterMap->set_commit_hold(true);
+
+	emit progress(m_iDone, m_iBlocks);
+
+	request();
+
+	return true;
+}
+
+
+bool qxgeditXGFetch::isActive (void) const
+{
+	return (m_iRequest >= 0 && m_iRequest < m_requests.count());
+}
+
+
+// Engine cancellation.
+void qxgeditXGFetch::cancel (void)
+{
+	m_timer.stop();
+
+	m_requests.clear();
+	m_iRequest = -1;
+	m_iRetry = 0;
+
+	if (m_pMasterMap)
+		m_pMasterMap->set_commit_hold(false);
+}
+
+
+// Response matcher (true if consumed).
+bool qxgeditXGFetch::process ( const QByteArray& sysex )
+{
+	if (!isActive())
+		return false;
+
+	qxgeditXGMasterMap::SysexData sysex_data;
+	if (!m_pMasterMap->add_sysex_data(sysex_data,
+			(unsigned char *) sysex.data(),
+			(unsigned short) sysex.length()))
+		return false;
+
+	const Request& req = m_requests.at(m_iRequest);
+
+	bool bMatch = false;
+	qxgeditXGMasterMap::SysexData::const_iterator iter
+		= sysex_data.constBegin();
+	for (; iter != sysex_data.constEnd(); ++iter) {
+		const XGParamKey& key = iter.key();
+		if (match(req, key.high(), key.mid(), key.low(), iter.value().size()))
+			bMatch = true;
+	}
+
+	// Apply it anyway, in one batched update...
+	m_pMasterMap->begin_update();
+	m_pMasterMap->set_sysex_data(sysex_data);
+	m_pMasterMap->end_update();
+
+	if (bMatch) {
+		// Estimate response time, from first attempts only...
+		if (m_iRetry == 0) {
+			const int iElapsed = int(m_time.elapsed());
+			m_iResponseTime = (3 * m_iResponseTime + iElapsed) / 4;
+		}
+		next(false);
+	}
+
+	return true;
+}
+
+
+// Progress status.
+int qxgeditXGFetch::count (void) const
+{
+	return m_iBlocks;
+}
+
+int qxgeditXGFetch::done (void) const
+{
+	return m_iDone;
+}
+
+int qxgeditXGFetch::failed (void) const
+{
+	return m_iFailed;
+}
+
+
+// Response timeout handler.
+void qxgeditXGFetch::timeout (void)
+{
+	if (!isActive())
+		return;
+
+	if (++m_iRetry > c_iMaxRetries)
+		next(true);
+	else
+		request();
+}
+
+
+// Request queue builders.
+void qxgeditXGFetch::addBlock ( int iGroup,
+	unsigned short high, unsigned short mid, unsigned short low )
+{
+	Request req;
+	req.high  = high;
+	req.mid   = mid;
+	req.low   = low;
+	req.type  = XGRequestSysex::DumpRequest;
+	req.group = iGroup;
+	req.block = m_iBlocks++;
+
+	m_requests.append(req);
+}
+
+
+// Replace a block by its individual parameter requests.
+void qxgeditXGFetch::addParams ( const Request& req )
+{
+	unsigned short low0 = 0x00;
+	unsigned short low1 = 0x80;
+	if (req.group == Effect) {
+		low0 = req.low;
+		low1 = (req.low < 0x40 ? req.low + 0x20 : 0x80);
+	}
+
+	int iRequest = m_iRequest + 1;
+	int iLow = -1;
+
+	QListIterator<XGParam *> iter(m_pMasterMap->params());
+	while (iter.hasNext()) {
+		XGParam *pParam = iter.next();
+		if (pParam->high() != req.high || pParam->mid() != req.mid)
+			continue;
+		const unsigned short low = pParam->low();
+		if (low < low0 || low >= low1 || int(low) == iLow)
+			continue;
+		Request preq = req;
+		preq.low  = low;
+		preq.type = XGRequestSysex::ParamRequest;
+		m_requests.insert(iRequest++, preq);
+		iLow = low;
+	}
+}
+
+
+// Send out the current request.
+void qxgeditXGFetch::request (void)
+{
+	if (!isActive())
+		return;
+
+	qxgeditMidiDevice *pMidiDevice = m_pMasterMap->midi_device();
+	if (pMidiDevice == nullptr) {
+		cancel();
+		return;
+	}
+
+	const Request& req = m_requests.at(m_iRequest);
+
+	XGRequestSysex sysex(req.high, req.mid, req.low, req.type);
+	pMidiDevice->sendSysex(sysex.data(), sysex.size());
+	m_pMasterMap->encoder().sysex_sent(sysex.size());
+
+	// Adaptive timeout, backing off on each retry...
+	int iTimeout = (4 * m_iResponseTime + 20) << m_iRetry;
+	if (iTimeout < c_iMinTimeout)
+		iTimeout = c_iMinTimeout;
+	if (iTimeout > c_iMaxTimeout)
+		iTimeout = c_iMaxTimeout;
+
+	m_time.start();
+	m_timer.start(iTimeout);
+}
+
+
+// Move on to the next one.
+void qxgeditXGFetch::next ( bool bFailed )
+{
+	m_timer.stop();
+
+	if (!isActive())
+		return;
+
+	const Request req = m_requests.at(m_iRequest);
+
+	// Whether this is the last request from this block...
+	bool bBlockDone = (m_iRequest + 1 >= m_requests.count()
+		|| m_requests.at(m_iRequest + 1).block != req.block);
+
+	if (bFailed) {
+		// Try parameter requests instead (XG only)...
+		if (req.type == XGRequestSysex::DumpRequest && req.group != Uservoice) {
+			const int iRequests = m_requests.count();
+			addParams(req);
+			bBlockDone = (m_requests.count() == iRequests);
+		}
+		// A missing parameter is just skipped; the block only
+		// fails when none of its requests got answered at all...
+		if (bBlockDone && !m_bBlockAnswered) {
+			++m_iFailed;
+			// Never answered for this group? drop it all...
+			if ((m_iDoneGroups & req.group) == 0) {
+				m_iFailedGroups |= req.group;
+				int iBlock = req.block;
+				int i = m_iRequest + 1;
+				while (i < m_requests.count()) {
+					const Request& req2 = m_requests.at(i);
+					if (req2.group == req.group) {
+						if (req2.block != iBlock) {
+							iBlock = req2.block;
+							++m_iFailed;
+							++m_iDone;
+						}
+						m_requests.removeAt(i);
+					}
+					else ++i;
+				}
+			}
+		}
+	} else {
+		m_iDoneGroups |= req.group;
+		m_bBlockAnswered = true;
+	}
+
+	if (bBlockDone) {
+		m_bBlockAnswered = false;
+		++m_iDone;
+		emit progress(m_iDone, m_iBlocks);
+	}
+
+	++m_iRequest;
+	m_iRetry = 0;
+
+	if (isActive()) {
+		request();
+	} else {
+		m_requests.clear();
+		m_iRequest = -1;
+		m_pMasterMap->set_commit_hold(false);
+		emit finished(m_iFailed);
+	}
+}
+
+
+// Whether a response matches the current request.
+bool qxgeditXGFetch::match ( const Request& req,
+	unsigned short high, unsigned short mid, unsigned short low,
+	unsigned short size ) const
+{
+	if (high != req.high || mid != req.mid)
+		return false;
+
+	if (req.type == XGRequestSysex::ParamRequest)
+		return (low == req.low);
+
+	// Bulk dump block covering the requested address...
+	return (low <= req.low && req.low < low + size);
+}
+
+
+// end of qxgeditXGFetch.cpp
@@ -0,0 +1,163 @@
+// qxgeditXGFetch.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditXGFetch_h
+#define __qxgeditXGFetch_h
+
+#include "XGParamSysex.h"
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QList>
+
+
+// Forward decls.
+class qxgeditXGMasterMap;
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGFetch -- XG device state fetch (pull) engine.
+//
+// Issues one XG Dump Request per parameter block, stop-and-wait,
+// with an adaptive timeout estimated from the device response time.
+// Blocks that won't get a bulk dump response are retried, then
+// requested parameter by parameter (Parameter Request) instead;
+// unanswered parameters are just skipped, the block only failing
+// when none of them gets answered at all.
+
+class qxgeditXGFetch : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qxgeditXGFetch(qxgeditXGMasterMap *pMasterMap, QObject *pParent = nullptr);
+
+	// Destructor.
+	~qxgeditXGFetch();
+
+	// Block groups.
+	enum Group {
+		System    = 0x01,
+		Effect    = 0x02,
+		Multipart = 0x04,
+		Drumsetup = 0x08,
+		Uservoice = 0x10,
+		All       = 0x1f
+	};
+
+	// Target master map accessor.
+	qxgeditXGMasterMap *masterMap() const;
+
+	// Engine control.
+	bool start(int iGroups = All);
+	bool isActive() const;
+
+	// Response matcher (true if consumed).
+	bool process(const QByteArray& sysex);
+
+	// Progress status.
+	int count() const;
+	int done() const;
+	int failed() const;
+
+public slots:
+
+	// Engine cancellation.
+	void cancel();
+
+signals:
+
+	// Progress notification.
+	void progress(int iDone, int iCount);
+
+	// Completion notification.
+	void finished(int iFailed);
+
+protected slots:
+
+	// Response timeout handler.
+	void timeout();
+
+protected:
+
+	// Request queue item.
+	struct Request
+	{
+		unsigned short high;
+		unsigned short mid;
+		unsigned short low;
+		XGRequestSysex::Type type;
+		int group;
+		int block;
+	};
+
+	// Request queue builders.
+	void addBlock(int iGroup,
+		unsigned short high, unsigned short mid, unsigned short low);
+	void addParams(const Request& req);
+
+	// Send out the current request.
+	void request();
+
+	// Move on to the next one.
+	void next(bool bFailed);
+
+	// Whether a response matches the current request.
+	bool match(const Request& req,
+		unsigned short high, unsigned short mid, unsigned short low,
+		unsigned short size) const;
+
+private:
+
+	// Instance variables.
+	qxgeditXGMasterMap *m_pMasterMap;
+
+	QList<Request> m_requests;
+
+	int m_iRequest;
+	int m_iRetry;
+
+	int m_iBlocks;
+	int m_iDone;
+	int m_iFailed;
+
+	int m_iFailedGroups;
+	int m_iDoneGroups;
+
+	// Whether the current block got any response.
+	bool m_bBlockAnswered;
+
+	// Response time estimation (msecs).
+	QTimer m_timer;
+	QElapsedTimer m_time;
+
+	int m_iResponseTime;
+};
+
+
+#endif	// __qxgeditXGFetch_h
+
+
+// end of qxgeditXGFetch.h
@@ -23,21 +23,76 @@
 #include "qxgeditXGMasterMap.h"
 
 #include "qxgeditMidiDevice.h"
+#include "qxgeditXGPublisher.h"
+#include "qxgeditTrace.h"
+#include "qxgeditAlloc.h"
 
 #include "qxgeditMainForm.h"
 
 #include "XGParamSysex.h"
 
+#include <QFile>
+
 #include <cstdio>
+#include <cstring>
+
+
+//----------------------------------------------------------------------------
+// Native binary snapshot file header.
+
+struct qxgeditXGSnapshotHeader
+{
+	char           magic[4];    // "QXGS"
+	unsigned short version;     // Format version (1).
+	unsigned short bom;         // Byte-order mark (0xfeff, native).
+	unsigned int   layout;      // Master map layout signature.
+	unsigned int   count;       // Number of dense state values.
+	unsigned int   size;        // Data parameters block size (bytes).
+	unsigned int   cksum;       // Payload checksum (FNV-1a).
+};
+
+static const char          *g_snapshot_magic   = "QXGS";
+static const unsigned short g_snapshot_version = 1;
+static const unsigned short g_snapshot_bom     = 0xfeff;
+
+
+// Payload checksum (FNV-1a).
+static unsigned int qxgedit_snapshot_cksum (
+	const unsigned char *data, unsigned int size )
+{
+	unsigned int cksum = 2166136261U;
+	for (unsigned int i = 0; i < size; ++i) {
+		cksum ^= data[i];
+		cksum *= 16777619U;
+	}
+	return cksum;
+}
+
+
+// Reset trigger parameters (Drum Setup Reset, XG System On,
+// All Parameter Reset): never to be replayed from a snapshot.
+static bool qxgedit_snapshot_trigger ( const XGParam *pParam )
+{
+	return (pParam->high() == 0x00 && pParam->mid() == 0x00
+		&& pParam->low() >= 0x7d && 0x7f >= pParam->low());
+}
 
 
 //----------------------------------------------------------------------------
 // qxgeditXGMasterMap::Observer -- XGParam master map observer.
 
 // Constructor.
-qxgeditXGMasterMap::Observer::Observer ( XGParam *pParam )
-	: XGParamObserver(pParam)
+qxgeditXGMasterMap::Observer::Observer (
+	qxgeditXGMasterMap *pMasterMap, XGParam *pParam )
+	: XGParamObserver(pParam), m_pMasterMap(pMasterMap)
+{
+	qxgeditAlloc::acquire(qxgeditAlloc::MasterObserver, sizeof(Observer));
+}
+
+// Destructor.
+qxgeditXGMasterMap::Observer::~Observer (void)
 {
+	qxgeditAlloc::release(qxgeditAlloc::MasterObserver, sizeof(Observer));
 }
 
 // View updater (observer callback).
@@ -47,7 +102,7 @@ void qxgeditXGMasterMap::Observer::reset (void)
 
 void qxgeditXGMasterMap::Observer::update (void)
 {
-	qxgeditXGMasterMap *pMasterMap = qxgeditXGMasterMap::getInstance();
+	qxgeditXGMasterMap *pMasterMap = m_pMasterMap;
 	if (pMasterMap == nullptr)
 		return;
 
@@ -59,6 +114,21 @@ void qxgeditXGMasterMap::Observer::update (void)
 		pParam->text().toUtf8().constData(), pParam->value());
 #endif
 
+	// Tell any listeners, first...
+	QListIterator<Listener *> listener(g_listeners);
+	while (listener.hasNext())
+		listener.next()->param_changed(pMasterMap, pParam);
+
+	// Batched update, defer it...
+	if (pMasterMap->m_update_level > 0) {
+		const unsigned int index = pParam->index();
+		if (!pMasterMap->m_update_mask.testBit(index)) {
+			pMasterMap->m_update_mask.setBit(index);
+			pMasterMap->m_update_params.append(pParam);
+		}
+		return;
+	}
+
 	if (pParam->high() == 0x11) {
 		// Special USERVOICE bulk dump stuff...
 		unsigned short iUser = pMasterMap->USERVOICE.current_key(); 
@@ -72,9 +142,13 @@ void qxgeditXGMasterMap::Observer::update (void)
 		pMasterMap->send_param(pParam);
 	}
 
-	// HACK: Flag dirty the main form...
+	// Live state commit...
+	if (pMasterMap->m_pPublisher)
+		pMasterMap->m_pPublisher->publish(pParam);
+
+	// HACK: Flag dirty the main form (current module only)...
 	qxgeditMainForm *pMainForm = qxgeditMainForm::getInstance();
-	if (pMainForm)
+	if (pMainForm && pMasterMap == qxgeditXGMasterMap::getInstance())
 		pMainForm->contentsChanged();
 }
 
@@ -83,18 +157,36 @@ void qxgeditXGMasterMap::Observer::update (void)
 // qxgeditXGMasterMap -- XGParam master map.
 //
 
+// Change listeners.
+QList<qxgeditXGMasterMap::Listener *> qxgeditXGMasterMap::g_listeners;
+
+
 // Constructor.
 qxgeditXGMasterMap::qxgeditXGMasterMap (void)
-	: XGParamMasterMap(), m_auto_send(false)
+	: XGParamMasterMap(), m_pMidiDevice(nullptr), m_auto_send(false),
+		m_compact_send(false), m_encoder(this), m_pPublisher(nullptr),
+		m_update_level(0), m_data_size(0), m_commit_hold(false),
+		m_commit_posted(false), m_block_level(0), m_snapshot_load(false)
 {
+	for (int i = 0; i < CommitQueues; ++i)
+		m_commit_queued[i].store(0);
+
 	// Setup local observers...
 	XGParamMasterMap::const_iterator iter
 		= XGParamMasterMap::constBegin();
 	for (; iter != XGParamMasterMap::constEnd(); ++iter) {
 		XGParam *pParam = iter.value();
-		m_observers.insert(pParam, new Observer(pParam));
+		Observer *pObserver = new Observer(this, pParam);
+		m_observers.insert(pParam, pObserver);
+		m_state_observers.append(pObserver);
+		if (pParam->size() > 4) {
+			m_data_params.append(static_cast<XGDataParam *> (pParam));
+			m_data_size += pParam->size();
+		}
 	}
 
+	m_update_mask.resize(XGParamMasterMap::size());
+
 	reset_part_dirty();
 	reset_user_dirty();
 }
@@ -119,6 +211,32 @@ qxgeditXGMasterMap *qxgeditXGMasterMap::getInstance (void)
 }
 
 
+// Change listeners (global, any module).
+void qxgeditXGMasterMap::add_listener ( Listener *pListener )
+{
+	if (!g_listeners.contains(pListener))
+		g_listeners.append(pListener);
+}
+
+void qxgeditXGMasterMap::remove_listener ( Listener *pListener )
+{
+	g_listeners.removeAll(pListener);
+}
+
+
+// Own MIDI device (output port bindings).
+void qxgeditXGMasterMap::set_midi_device ( qxgeditMidiDevice *pMidiDevice )
+{
+	m_pMidiDevice = pMidiDevice;
+}
+
+qxgeditMidiDevice *qxgeditXGMasterMap::midi_device (void) const
+{
+	// Fallback to the current (pseudo-singleton) device...
+	return (m_pMidiDevice ? m_pMidiDevice : qxgeditMidiDevice::getInstance());
+}
+
+
 // Direct RPN value receiver.
 bool qxgeditXGMasterMap::set_rpn_value (
 	unsigned char /*ch*/, unsigned short /*rpn*/,
@@ -159,85 +277,6 @@ bool qxgeditXGMasterMap::set_nrpn_value (
 }
 
 
-// Direct SysEx data receiver.
-bool qxgeditXGMasterMap::add_sysex_data (
-	SysexData& sysex_data, unsigned char *data, unsigned short len )
-{
-	 // SysEx (actually)...
-	if (data[0] != 0xf0 || data[len - 1] != 0xf7)
-		return false;
-
-	// Yamaha ID...
-	if (data[1] != 0x43)
-		return false;
-
-	int nsysex = 0;
-
-	const unsigned char mode  = (data[2] & 0x70);
-//	const unsigned char devno = (data[2] & 0x0f);
-	if (data[3] == 0x4c || data[3] == 0x4b) {
-		// XG/QS300 Model ID...
-		if (mode == 0x00) {
-			// Native Bulk Dump...
-			const unsigned short size = (data[4] << 7) + data[5];
-			unsigned char cksum = 0;
-			for (unsigned short i = 0; i < size + 5; ++i) {
-				cksum += data[4 + i];
-				cksum &= 0x7f;
-			}
-			if (data[9 + size] == 0x80 - cksum) {
-				// Parameter Change...
-				const unsigned short high = data[6];
-				const unsigned short mid  = data[7];
-				const unsigned short low  = data[8];
-				const XGParamKey key(high, mid, low);
-				sysex_data.insert(key, QByteArray((const char *) &data[9], size));
-				++nsysex;
-			}
-		}
-		else
-		if (mode == 0x10) {
-			// Parameter Change...
-			const unsigned short high = data[4];
-			const unsigned short mid  = data[5];
-			const unsigned short low  = data[6];
-			const XGParamKey key(high, mid, low);
-			sysex_data.insert(key, QByteArray((const char *) &data[7], len - 7));
-			++nsysex;
-		}
-	}
-	
-	return (nsysex > 0);
-}
-
-
-bool qxgeditXGMasterMap::set_sysex_data (
-	const SysexData& sysex_data, bool bNotify )
-{
-	int nparam = 0;
-
-	SysexData::const_iterator iter = sysex_data.constBegin();
-	for (; iter != sysex_data.constEnd(); ++iter) {
-		const XGParamKey& key = iter.key();
-		const QByteArray& val = iter.value();
-		unsigned char *data = (unsigned char *) val.data();
-		for (unsigned short i = 0; i < val.size(); ++i) {
-			// Parameter Change...
-			XGParam *pParam = find_param(key.high(), key.mid(), key.low() + i);
-			if (pParam && set_param_data(pParam, data + i, bNotify)) {
-				const unsigned short n = pParam->size();
-				if (n > 1) {
-					i += (n - 1);
-					++nparam;
-				}
-			}
-		}
-	}
-
-	return (nparam > 0);
-}
-
-
 // Direct parameter data access.
 bool qxgeditXGMasterMap::set_param_data (
 	XGParam *pParam, unsigned char *data, bool bNotify )
@@ -260,16 +299,11 @@ bool qxgeditXGMasterMap::set_param_data (
 	}
 
 	Observer *pObserver = (bNotify ? nullptr : m_observers.value(pParam));
-	if (pParam->size() > 4) {
-		XGDataParam *pDataParam = static_cast<XGDataParam *> (pParam);
-		pDataParam->set_data(data, pDataParam->size(), pObserver);
-	}
-	else
-	if (high == 0x08 && low == 0x09) { // DETUNE (2byte, 4bit).
-		pParam->set_value(pParam->data_value2(data), pObserver);
-	} else {
-		pParam->set_value(pParam->data_value(data), pObserver);
-	}
+	XGParamMasterMap::decode_param_data(pParam, data, pObserver);
+
+	// Live state commit (unless notified or batched already)...
+	if (m_pPublisher && pObserver && m_update_level < 1)
+		m_pPublisher->publish(pParam);
 
 #ifdef CONFIG_DEBUG
 	fprintf(stderr, "< %02x %02x %02x",
@@ -300,14 +334,15 @@ void qxgeditXGMasterMap::reset_all (void)
 	qDebug("qxgeditXGMasterMap::reset_all()");
 #endif
 
-	ObserverMap::const_iterator iter = m_observers.constBegin();
-	for (; iter != m_observers.constEnd(); ++iter) {
-		XGParam *pParam = iter.key();
-		pParam->reset(iter.value());
-	}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const int iCount = params.count();
+	for (int i = 0; i < iCount; ++i)
+		params.at(i)->reset(m_state_observers.at(i));
 
 	reset_part_dirty();
 	reset_user_dirty();
+
+	publish_state();
 }
 
 
@@ -318,20 +353,18 @@ void qxgeditXGMasterMap::reset_part ( unsigned short iPart )
 	qDebug("qxgeditXGMasterMap::reset_part(%u)", iPart);
 #endif
 
-	XGParamMap::const_iterator iter = MULTIPART.constBegin();
-	for (; iter != MULTIPART.constEnd(); ++iter) {
-		XGParamSet *pParamSet = iter.value();
-		if (pParamSet->contains(iPart)) {
-			XGParam *pParam = pParamSet->value(iPart);
-			if (pParam)
-				pParam->reset();
-		}
-	}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x08, iPart);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i)
+		params.at(i)->reset();
 
 	if (part_dirty(iPart)) {
 		send_part(iPart);
 		set_part_dirty(iPart, false);
 	}
+
+	publish_state();
 }
 
 
@@ -342,13 +375,13 @@ void qxgeditXGMasterMap::reset_drums ( unsigned short iDrumSet )
 	qDebug("qxgeditXGMasterMap::reset_drums(%u)", iDrumSet);
 #endif
 
-	unsigned short high = 0x30 + iDrumSet;
-	ObserverMap::const_iterator iter = m_observers.constBegin();
-	for (; iter != m_observers.constEnd(); ++iter) {
-		XGParam *pParam = iter.key();
-		if (pParam->high() == high)
-			pParam->reset(iter.value());
-	}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x30 + iDrumSet);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i)
+		params.at(i)->reset(m_state_observers.at(i));
+
+	publish_state();
 }
 
 
@@ -363,15 +396,11 @@ void qxgeditXGMasterMap::reset_user ( unsigned short iUser )
 	bool bAuto = auto_send();
 	set_auto_send(false);
 
-	XGParamMap::const_iterator iter = USERVOICE.constBegin();
-	for (; iter != USERVOICE.constEnd(); ++iter) {
-		XGParamSet *pParamSet = iter.value();
-		if (pParamSet->contains(iUser)) {
-			XGParam *pParam = pParamSet->value(iUser);
-			if (pParam)
-				pParam->reset();
-		}
-	}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x11, iUser);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i)
+		params.at(i)->reset();
 
 	if (user_dirty(iUser)) {
 		send_user(iUser);
@@ -380,6 +409,8 @@ void qxgeditXGMasterMap::reset_user ( unsigned short iUser )
 
 	// Restore auto-send.
 	set_auto_send(bAuto);
+
+	publish_state();
 }
 
 
@@ -389,14 +420,34 @@ void qxgeditXGMasterMap::send_param ( XGParam *pParam )
 	if (pParam == nullptr)
 		return;
 
-	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
+	QXGEDIT_TRACE("qxgeditXGMasterMap::send_param");
+
+	// Snapshot loading must never reset anything...
+	if (m_snapshot_load && qxgedit_snapshot_trigger(pParam)) {
+	#ifdef CONFIG_DEBUG
+		qDebug("qxgeditXGMasterMap::send_param(%02x %02x %02x) "
+			"reset trigger while loading snapshot, ignored.",
+			pParam->high(), pParam->mid(), pParam->low());
+	#endif
+		return;
+	}
+
+	qxgeditMidiDevice *pMidiDevice = midi_device();
 	if (pMidiDevice == nullptr)
 		return;
 
-	// Build the complete SysEx message...
-	XGParamSysex sysex(pParam);
-	// Send it out...
-	pMidiDevice->sendSysex(sysex.data(), sysex.size());
+	if (m_compact_send) {
+		// Cheapest of SysEx, NRPN or CC...
+		QByteArray data;
+		m_encoder.encode(pParam, data);
+		pMidiDevice->sendMidi(data);
+	} else {
+		// Build the complete SysEx message...
+		XGParamSysex sysex(pParam);
+		// Send it out...
+		pMidiDevice->sendSysex(sysex.data(), sysex.size());
+		m_encoder.sysex_sent(sysex.size());
+	}
 
 	// HACK: Special reset actions...
 	if (pParam->high() == 0x00 && pParam->mid() == 0x00) {
@@ -416,7 +467,7 @@ void qxgeditXGMasterMap::send_param ( XGParam *pParam )
 // Send Multi Part Bank Select/Program Number SysEx messages.
 void qxgeditXGMasterMap::send_part ( unsigned short iPart ) const
 {
-	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
+	qxgeditMidiDevice *pMidiDevice = midi_device();
 	if (pMidiDevice == nullptr)
 		return;
 
@@ -430,6 +481,7 @@ void qxgeditXGMasterMap::send_part ( unsigned short iPart ) const
 			XGParamSysex sysex(pParam);
 			// Send it out...
 			pMidiDevice->sendSysex(sysex.data(), sysex.size());
+			m_encoder.sysex_sent(sysex.size());
 		}
 	}
 }
@@ -438,14 +490,15 @@ void qxgeditXGMasterMap::send_part ( unsigned short iPart ) const
 // Send USER VOICE Bulk Dump SysEx message.
 void qxgeditXGMasterMap::send_user ( unsigned short iUser ) const
 {
-	qxgeditMidiDevice *pMidiDevice = qxgeditMidiDevice::getInstance();
+	qxgeditMidiDevice *pMidiDevice = midi_device();
 	if (pMidiDevice == nullptr)
 		return;
 
 	// Build the complete SysEx message...
-	XGUserVoiceSysex sysex(iUser);
+	XGUserVoiceSysex sysex(iUser, const_cast<qxgeditXGMasterMap *> (this));
 	// Send it out...
 	pMidiDevice->sendSysex(sysex.data(), sysex.size());
+	m_encoder.sysex_sent(sysex.size());
 }
 
 
@@ -539,6 +592,49 @@ bool qxgeditXGMasterMap::auto_send (void) const
 }
 
 
+// Compact (cheapest encoding) send feature.
+void qxgeditXGMasterMap::set_compact_send ( bool bCompact )
+{
+	m_compact_send = bCompact;
+
+	m_encoder.reset();
+}
+
+bool qxgeditXGMasterMap::compact_send (void) const
+{
+	return m_compact_send;
+}
+
+
+// Live state publisher (shared memory).
+void qxgeditXGMasterMap::set_publisher ( qxgeditXGPublisher *pPublisher )
+{
+	m_pPublisher = pPublisher;
+
+	publish_state();
+}
+
+qxgeditXGPublisher *qxgeditXGMasterMap::publisher (void) const
+{
+	return m_pPublisher;
+}
+
+
+// Live state commit (whole image, unless batched).
+void qxgeditXGMasterMap::publish_state (void)
+{
+	if (m_pPublisher && m_update_level < 1)
+		m_pPublisher->publish_all();
+}
+
+
+// Outgoing change encoder.
+XGParamEncoder& qxgeditXGMasterMap::encoder (void)
+{
+	return m_encoder;
+}
+
+
 // Part randomize (from value/def)
 void qxgeditXGMasterMap::randomize_part ( unsigned short iPart, float p )
 {
@@ -546,14 +642,13 @@ void qxgeditXGMasterMap::randomize_part ( unsigned short iPart, float p )
 	qDebug("qxgeditXGMasterMap::randomize_part(%u, %g)", iPart, p);
 #endif
 
-	XGParamMap::const_iterator iter = MULTIPART.constBegin();
-	for (; iter != MULTIPART.constEnd(); ++iter) {
-		XGParamSet *pParamSet = iter.value();
-		if (pParamSet->contains(iPart)) {
-			XGParam *pParam = pParamSet->value(iPart);
-			if (pParam && pParam->low() > 0x04)
-				pParam->randomize_value(p);
-		}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x08, iPart);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i) {
+		XGParam *pParam = params.at(i);
+		if (pParam->low() > 0x04)
+			pParam->randomize_value(p);
 	}
 
 	if (part_dirty(iPart)) {
@@ -571,16 +666,11 @@ void qxgeditXGMasterMap::randomize_drums (
 	qDebug("qxgeditXGMasterMap::randomize_drums(%u, %u, %g)", iDrumSet, iDrumKey, p);
 #endif
 
-	unsigned short key = (unsigned short) (iDrumSet << 7) + iDrumKey;
-	XGParamMap::const_iterator iter = DRUMSETUP.constBegin();
-	for (; iter != DRUMSETUP.constEnd(); ++iter) {
-		XGParamSet *pParamSet = iter.value();
-		if (pParamSet->contains(key)) {
-			XGParam *pParam = pParamSet->value(key);
-			if (pParam)
-				pParam->randomize_value(p);
-		}
-	}
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x30 + iDrumSet, iDrumKey);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i)
+		params.at(i)->randomize_value(p);
 }
 
 
@@ -596,19 +686,17 @@ void qxgeditXGMasterMap::randomize_user ( unsigned short iUser, float p )
 	set_auto_send(false);
 
 	unsigned short id0 = 0x3d + (USERVOICE.current_element() * 0x50);
-	XGParamMap::const_iterator iter = USERVOICE.constBegin();
-	for (; iter != USERVOICE.constEnd(); ++iter) {
-		unsigned short id = iter.key();
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(0x11, iUser);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i) {
+		XGParam *pParam = params.at(i);
+		unsigned short id = pParam->low();
 		if (id < 0x3d)
 			continue;
 		if (USERVOICE.elements() > 0 && (id < id0 || id >= id0 + 0x50))
 			continue;
-		XGParamSet *pParamSet = iter.value();
-		if (pParamSet->contains(iUser)) {
-			XGParam *pParam = pParamSet->value(iUser);
-			if (pParam)
-				pParam->randomize_value(p);
-		}
+		pParam->randomize_value(p);
 	}
 
 	if (user_dirty(iUser)) {
@@ -621,4 +709,583 @@ void qxgeditXGMasterMap::randomize_user ( unsigned short iUser, float p )
 }
 
 
+// Batched update (one notification transaction).
+void qxgeditXGMasterMap::begin_update (void)
+{
+	++m_update_level;
+}
+
+
+void qxgeditXGMasterMap::end_update (void)
+{
+	if (m_update_level < 1 || --m_update_level > 0)
+		return;
+
+	if (m_update_params.isEmpty())
+		return;
+
+	const QList<XGParam *> params = m_update_params;
+	m_update_params.clear();
+
+	unsigned int users = 0;
+
+	QListIterator<XGParam *> iter(params);
+	while (iter.hasNext()) {
+		XGParam *pParam = iter.next();
+		m_update_mask.clearBit(pParam->index());
+		if (pParam->high() == 0x11) {
+			// Special USERVOICE bulk dump stuff, once per user...
+			const unsigned short iUser = pParam->mid();
+			set_user_dirty(iUser, true);
+			users |= (1U << iUser);
+		} else {
+			// Regular XG Parameter change...
+			send_param(pParam);
+		}
+	}
+
+	if (auto_send()) {
+		for (unsigned short iUser = 0; iUser < 32; ++iUser) {
+			if (users & (1U << iUser)) {
+				send_user(iUser);
+				set_user_dirty_1(iUser, false);
+			}
+		}
+	}
+
+	// Live state commit, all in one go...
+	publish_state();
+
+	// HACK: Flag dirty the main form (current module only)...
+	qxgeditMainForm *pMainForm = qxgeditMainForm::getInstance();
+	if (pMainForm && this == qxgeditXGMasterMap::getInstance())
+		pMainForm->contentsChanged();
+}
+
+
+bool qxgeditXGMasterMap::is_updating (void) const
+{
+	return (m_update_level > 0);
+}
+
+
+// Part block copy/swap.
+void qxgeditXGMasterMap::copy_part (
+	unsigned short iPart, unsigned short iToPart )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::copy_part(%u, %u)", iPart, iToPart);
+#endif
+
+	begin_block();
+	copy_block(0x08, iPart, 0x08, iToPart, 0x01, 0x04, 0, false);
+	copy_block(0x08, iPart, 0x08, iToPart, 0x05, 0x80, 0, false);
+	end_block();
+}
+
+
+void qxgeditXGMasterMap::swap_parts (
+	unsigned short iPart1, unsigned short iPart2 )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::swap_parts(%u, %u)", iPart1, iPart2);
+#endif
+
+	begin_block();
+	copy_block(0x08, iPart1, 0x08, iPart2, 0x01, 0x04, 0, true);
+	copy_block(0x08, iPart1, 0x08, iPart2, 0x05, 0x80, 0, true);
+	end_block();
+}
+
+
+// Drum note block copy.
+void qxgeditXGMasterMap::copy_drums (
+	unsigned short iDrumSet, unsigned short iDrumKey,
+	unsigned short iToDrumSet, unsigned short iToDrumKey )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::copy_drums(%u, %u, %u, %u)",
+		iDrumSet, iDrumKey, iToDrumSet, iToDrumKey);
+#endif
+
+	begin_block();
+	copy_block(0x30 + iDrumSet, iDrumKey,
+		0x30 + iToDrumSet, iToDrumKey, 0x00, 0x80, 0, false);
+	end_block();
+}
+
+
+// User voice block copy/swap.
+void qxgeditXGMasterMap::copy_user (
+	unsigned short iUser, unsigned short iToUser )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::copy_user(%u, %u)", iUser, iToUser);
+#endif
+
+	begin_block();
+	copy_block(0x11, iUser, 0x11, iToUser, 0x00, 0x100, 0, false);
+	end_block();
+}
+
+
+void qxgeditXGMasterMap::swap_users (
+	unsigned short iUser1, unsigned short iUser2 )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::swap_users(%u, %u)", iUser1, iUser2);
+#endif
+
+	begin_block();
+	copy_block(0x11, iUser1, 0x11, iUser2, 0x00, 0x100, 0, true);
+	end_block();
+}
+
+
+// User voice element block copy/swap.
+void qxgeditXGMasterMap::copy_user_element (
+	unsigned short iUser, unsigned short iElem,
+	unsigned short iToUser, unsigned short iToElem )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::copy_user_element(%u, %u, %u, %u)",
+		iUser, iElem, iToUser, iToElem);
+#endif
+
+	const unsigned short low1 = 0x3d + (iElem * 0x50);
+	const int delta = (int(iToElem) - int(iElem)) * 0x50;
+
+	begin_block();
+	copy_block(0x11, iUser, 0x11, iToUser, low1, low1 + 0x50, delta, false);
+	end_block();
+}
+
+
+void qxgeditXGMasterMap::swap_user_elements ( unsigned short iUser )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qxgeditXGMasterMap::swap_user_elements(%u)", iUser);
+#endif
+
+	begin_block();
+	copy_block(0x11, iUser, 0x11, iUser, 0x3d, 0x3d + 0x50, 0x50, true);
+	end_block();
+}
+
+
+// Block transaction (one bulk dump per touched sub-block).
+void qxgeditXGMasterMap::begin_block (void)
+{
+	++m_block_level;
+}
+
+
+void qxgeditXGMasterMap::end_block (void)
+{
+	if (m_block_level < 1 || --m_block_level > 0)
+		return;
+
+	if (m_block_keys.isEmpty())
+		return;
+
+	const QList<unsigned short> keys = m_block_keys;
+	m_block_keys.clear();
+
+	QListIterator<unsigned short> iter(keys);
+	while (iter.hasNext()) {
+		const unsigned short key  = iter.next();
+		const unsigned short high = (key >> 8);
+		const unsigned short mid  = (key & 0xff);
+		// Nothing really gets sent without a device...
+		const bool bSent = (midi_device() != nullptr);
+		if (high == 0x11) {
+			// Special USERVOICE bulk dump stuff...
+			set_user_dirty(mid, true);
+			if (auto_send() && bSent) {
+				send_user(mid);
+				set_user_dirty_1(mid, false);
+			}
+		} else {
+			// Regular XG native bulk dump(s)...
+			send_block(high, mid);
+			if (high == 0x08 && bSent)
+				set_part_dirty(mid, false);
+		}
+	}
+
+	// Live state commit, all in one go...
+	publish_state();
+
+	// HACK: Flag dirty the main form (current module only)...
+	qxgeditMainForm *pMainForm = qxgeditMainForm::getInstance();
+	if (pMainForm && this == qxgeditXGMasterMap::getInstance())
+		pMainForm->contentsChanged();
+}
+
+
+// Block copy/swap executive: all source sub-block parameters in the
+// [low1, low2) address range onto destination address (low + delta);
+// views and listeners are notified, but nothing is sent until the
+// outermost block transaction ends.
+void qxgeditXGMasterMap::copy_block (
+	unsigned short high, unsigned short mid,
+	unsigned short high2, unsigned short mid2,
+	unsigned short low1, unsigned short low2, int delta, bool bSwap )
+{
+	if (high == high2 && mid == mid2 && delta == 0)
+		return;
+
+	bool bChanged = false;
+
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(high, mid);
+	const unsigned int iLast = range.first + range.count;
+	for (unsigned int i = range.first; i < iLast; ++i) {
+		XGParam *pParam = params.at(i);
+		const unsigned short low = pParam->low();
+		if (low < low1 || low >= low2)
+			continue;
+		XGParam *pParam2 = find_param(high2, mid2, low + delta);
+		if (pParam2 == nullptr || pParam2->size() != pParam->size())
+			continue;
+		Observer *pObserver  = m_state_observers.at(pParam->index());
+		Observer *pObserver2 = m_state_observers.at(pParam2->index());
+		if (pParam->size() > 4) {
+			XGDataParam *pDataParam  = static_cast<XGDataParam *> (pParam);
+			XGDataParam *pDataParam2 = static_cast<XGDataParam *> (pParam2);
+			const unsigned short n = pParam->size();
+			if (::memcmp(pDataParam->data(), pDataParam2->data(), n) == 0)
+				continue;
+			QByteArray data((const char *) pDataParam2->data(), n);
+			pDataParam2->set_data(pDataParam->data(), n, pObserver2);
+			if (bSwap)
+				pDataParam->set_data((unsigned char *) data.data(), n, pObserver);
+		} else {
+			const unsigned short u  = pParam->value();
+			const unsigned short u2 = pParam2->value();
+			if (u == u2)
+				continue;
+			pParam2->set_value(u, pObserver2);
+			if (bSwap)
+				pParam->set_value(u2, pObserver);
+		}
+		// Tell any listeners...
+		QListIterator<Listener *> listener(g_listeners);
+		while (listener.hasNext()) {
+			Listener *pListener = listener.next();
+			pListener->param_changed(this, pParam2);
+			if (bSwap)
+				pListener->param_changed(this, pParam);
+		}
+		bChanged = true;
+	}
+
+	if (!bChanged)
+		return;
+
+	const unsigned short key2 = (high2 << 8) | mid2;
+	if (!m_block_keys.contains(key2))
+		m_block_keys.append(key2);
+
+	if (bSwap) {
+		const unsigned short key = (high << 8) | mid;
+		if (!m_block_keys.contains(key))
+			m_block_keys.append(key);
+	}
+}
+
+
+// Send one sub-block as native bulk dump(s), one per contiguous run.
+void qxgeditXGMasterMap::send_block (
+	unsigned short high, unsigned short mid ) const
+{
+	qxgeditMidiDevice *pMidiDevice = midi_device();
+	if (pMidiDevice == nullptr)
+		return;
+
+	qxgeditXGMasterMap *pMasterMap = const_cast<qxgeditXGMasterMap *> (this);
+
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const Range range = XGParamMasterMap::range(high, mid);
+	const unsigned int iLast = range.first + range.count;
+
+	unsigned int i = range.first;
+	while (i < iLast) {
+		const unsigned short low = params.at(i)->low();
+		unsigned short next = low + params.at(i)->size();
+		for (++i; i < iLast && params.at(i)->low() == next; ++i)
+			next += params.at(i)->size();
+		XGBulkDumpSysex sysex(high, mid, low, next - low, pMasterMap);
+		pMidiDevice->sendSysex(sysex.data(), sysex.size());
+		m_encoder.sysex_sent(sysex.size());
+	}
+}
+
+
+// Concurrent model commit (MIDI input thread).
+bool qxgeditXGMasterMap::commitSysex (
+	const unsigned char *pSysex, unsigned int iSysex, bool& bNotify )
+{
+	// Validate it all, first...
+	const XGSysexDecoder sysex(pSysex, iSysex);
+	if (!sysex.is_valid())
+		return false;
+
+	const unsigned short high = sysex.high();
+	const unsigned short mid  = sysex.mid();
+	const unsigned short low  = sysex.low();
+	const unsigned char *data = sysex.data();
+	const unsigned int size   = sysex.size();
+
+	// Fetching in progress, or an earlier fall-back still pending
+	// for the same sub-block? leave it all to the main thread, in order...
+	std::atomic<unsigned int>& queued = m_commit_queued[commit_queue(high, mid)];
+	bool bQueue = (m_commit_hold.load(std::memory_order_acquire)
+		|| queued.load(std::memory_order_acquire) > 0);
+
+	// EFFECT parameters depend on the current effect type,
+	// which is only to be resolved on the main thread...
+	if (high == 0x02)
+		bQueue = true;
+
+	// Make sure it's all plain values, first...
+	unsigned int i;
+	for (i = 0; i < size && !bQueue; ++i) {
+		XGParam *pParam = XGParamMasterMap::value(
+			XGParamKey(high, mid, low + i), nullptr);
+		if (pParam == nullptr)
+			continue;
+		const unsigned short n = pParam->size();
+		if (n > 4 || i + n > size)
+			bQueue = true;
+		else
+		if (n > 1)
+			i += (n - 1);
+	}
+
+	if (bQueue) {
+		queued.fetch_add(1, std::memory_order_acq_rel);
+		return false;
+	}
+
+	// Commit to dense state slots...
+	XGParamState *pState = XGParamMasterMap::state();
+	for (i = 0; i < size; ++i) {
+		XGParam *pParam = XGParamMasterMap::value(
+			XGParamKey(high, mid, low + i), nullptr);
+		if (pParam == nullptr)
+			continue;
+		unsigned char *p = const_cast<unsigned char *> (data + i);
+		const unsigned short u = (high == 0x08 && pParam->low() == 0x09
+			? pParam->data_value2(p)	// DETUNE (2byte, 4bit).
+			: pParam->data_value(p));
+		if (!pParam->gets(pParam->min()) || pParam->gets(u))
+			pState->commit(pParam->index(), u);
+		const unsigned short n = pParam->size();
+		if (n > 1)
+			i += (n - 1);
+	}
+
+	// Coalesced notification (one pending at a time)...
+	bNotify = (pState->is_dirty()
+		&& !m_commit_posted.exchange(true, std::memory_order_acq_rel));
+
+	return true;
+}
+
+
+// Concurrent commits pick-up (main thread, coalesced).
+void qxgeditXGMasterMap::flush_commits (void)
+{
+	// Re-arm notification before picking up...
+	m_commit_posted.store(false, std::memory_order_release);
+
+	XGParamState *pState = XGParamMasterMap::state();
+	if (pState == nullptr || pState->take_dirty(m_commit_indexes) < 1)
+		return;
+
+	const QList<XGParam *>& params = XGParamMasterMap::params();
+	const int iCount = m_commit_indexes.count();
+	for (int i = 0; i < iCount; ++i) {
+		const unsigned int index = m_commit_indexes.at(i);
+		XGParam *pParam = params.at(index);
+		const unsigned short high = pParam->high();
+		const unsigned short mid  = pParam->mid();
+		const unsigned short low  = pParam->low();
+		if (high == 0x08 && low >= 0x01 && 0x03 >= low)
+			set_part_dirty(mid, true);
+		else
+		if (high == 0x11)
+			set_user_dirty(mid, true);
+		// Tell everyone but ourselves (no echo)...
+		pParam->notify_update(m_state_observers.at(index));
+		// Tell change listeners too (eg. control clients)...
+		QListIterator<Listener *> listener(g_listeners);
+		while (listener.hasNext())
+			listener.next()->param_changed(this, pParam);
+	}
+
+	// Live state commit (whole image, unless batched)...
+	publish_state();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qxgeditXGMasterMap::flush_commits() %d", iCount);
+#endif
+}
+
+
+// Concurrent commits hold-off (eg. while fetching).
+void qxgeditXGMasterMap::set_commit_hold ( bool bHold )
+{
+	m_commit_hold.store(bHold, std::memory_order_release);
+}
+
+bool qxgeditXGMasterMap::commit_hold (void) const
+{
+	return m_commit_hold.load(std::memory_order_acquire);
+}
+
+
+// Concurrent commits fall-back release (main thread).
+void qxgeditXGMasterMap::release_commit (
+	const unsigned char *pSysex, unsigned int iSysex )
+{
+	const XGSysexDecoder sysex(pSysex, iSysex);
+	if (!sysex.is_valid())
+		return;
+
+	// Only the main thread ever decrements...
+	std::atomic<unsigned int>& queued
+		= m_commit_queued[commit_queue(sysex.high(), sysex.mid())];
+	if (queued.load(std::memory_order_acquire) > 0)
+		queued.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+
+// Native binary snapshot (dense state image).
+bool qxgeditXGMasterMap::save_snapshot ( const QString& sFilename ) const
+{
+	XGParamState *pState = XGParamMasterMap::state();
+	if (pState == nullptr)
+		return false;
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	// Payload: dense state values, then data parameters...
+	const unsigned int nvalues = pState->count() * sizeof(unsigned short);
+	QByteArray payload(nvalues, '\0');
+	pState->snapshot((unsigned short *) payload.data());
+	payload.reserve(nvalues + m_data_size);
+	QListIterator<XGDataParam *> iter(m_data_params);
+	while (iter.hasNext()) {
+		XGDataParam *pDataParam = iter.next();
+		payload.append((const char *) pDataParam->data(), pDataParam->size());
+	}
+
+	qxgeditXGSnapshotHeader header;
+	::memcpy(header.magic, g_snapshot_magic, sizeof(header.magic));
+	header.version = g_snapshot_version;
+	header.bom     = g_snapshot_bom;
+	header.layout  = XGParamMasterMap::layout();
+	header.count   = pState->count();
+	header.size    = m_data_size;
+	header.cksum   = qxgedit_snapshot_cksum(
+		(const unsigned char *) payload.constData(), payload.size());
+
+	bool bResult = (file.write((const char *) &header, sizeof(header))
+		== qint64(sizeof(header)));
+	if (bResult)
+		bResult = (file.write(payload) == qint64(payload.size()));
+
+	file.close();
+
+	return bResult;
+}
+
+
+bool qxgeditXGMasterMap::load_snapshot ( const QString& sFilename )
+{
+	XGParamState *pState = XGParamMasterMap::state();
+	if (pState == nullptr)
+		return false;
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	const unsigned int nvalues = pState->count() * sizeof(unsigned short);
+	const qint64 nsize = sizeof(qxgeditXGSnapshotHeader) + nvalues + m_data_size;
+	if (file.size() != nsize) {
+		file.close();
+		return false;
+	}
+
+	unsigned char *pMap = file.map(0, nsize);
+	if (pMap == nullptr) {
+		file.close();
+		return false;
+	}
+
+	bool bResult = false;
+
+	const qxgeditXGSnapshotHeader *pHeader
+		= (const qxgeditXGSnapshotHeader *) pMap;
+	const unsigned char *payload = pMap + sizeof(qxgeditXGSnapshotHeader);
+
+	if (::memcmp(pHeader->magic, g_snapshot_magic, sizeof(pHeader->magic)) == 0
+		&& pHeader->version == g_snapshot_version
+		&& pHeader->bom     == g_snapshot_bom
+		&& pHeader->layout  == XGParamMasterMap::layout()
+		&& pHeader->count   == pState->count()
+		&& pHeader->size    == m_data_size
+		&& pHeader->cksum   == qxgedit_snapshot_cksum(payload, nvalues + m_data_size)) {
+		// Find which ones are about to change...
+		const QList<XGParam *>& params = XGParamMasterMap::params();
+		const unsigned int count = pState->count();
+		QVector<unsigned short> values(count);
+		::memcpy(values.data(), payload, nvalues);
+		QList<XGParam *> changed;
+		for (unsigned int i = 0; i < count; ++i) {
+			XGParam *pParam = params.at(i);
+			// Leave reset triggers as they are...
+			if (qxgedit_snapshot_trigger(pParam))
+				values[i] = pState->value(i);
+			else
+			if (pState->value(i) != values.at(i))
+				changed.append(pParam);
+		}
+		// Whole state restore...
+		pState->restore(values.constData());
+		// Data parameters...
+		const unsigned char *data = payload + nvalues;
+		QListIterator<XGDataParam *> iter(m_data_params);
+		while (iter.hasNext()) {
+			XGDataParam *pDataParam = iter.next();
+			const unsigned short n = pDataParam->size();
+			if (::memcmp(pDataParam->data(), data, n)) {
+				::memcpy(pDataParam->data(), data, n);
+				changed.append(pDataParam);
+			}
+			data += n;
+		}
+		// One batched notification (no resets whatsoever)...
+		m_snapshot_load = true;
+		begin_update();
+		QListIterator<XGParam *> iter2(changed);
+		while (iter2.hasNext())
+			iter2.next()->notify_update();
+		end_update();
+		m_snapshot_load = false;
+		bResult = true;
+	}
+
+	file.unmap(pMap);
+	file.close();
+
+	return bResult;
+}
+
+
 // end of qxgeditXGMasterMap.cpp
@@ -23,14 +23,24 @@
 #define __qxgeditXGMasterMap_h
 
 #include "XGParam.h"
+#include "XGParamEncoder.h"
+
+#include "qxgeditMidiDevice.h"
 
 #include <QByteArray>
+#include <QBitArray>
+#include <QString>
+
+
+// Forward decls.
+class qxgeditXGPublisher;
 
 
 //----------------------------------------------------------------------------
 // qxgeditXGMasterMap -- XGParam master map.
 //
-class qxgeditXGMasterMap : public XGParamMasterMap
+class qxgeditXGMasterMap : public XGParamMasterMap,
+	public qxgeditMidiDevice::Committer
 {
 public:
 
@@ -43,6 +53,10 @@ public:
 	// Singleton (re)cast.
 	static qxgeditXGMasterMap *getInstance();
 
+	// Own MIDI device (output port bindings).
+	void set_midi_device(qxgeditMidiDevice *pMidiDevice);
+	qxgeditMidiDevice *midi_device() const;
+
 	// Direct RPN value receiver.
 	bool set_rpn_value(unsigned char ch,
 		unsigned short rpn, unsigned short val, bool bNotify = false);
@@ -51,13 +65,6 @@ public:
 	bool set_nrpn_value(unsigned char ch,
 		unsigned short nrpn, unsigned short val, bool bNotify = false);
 
-	// Direct SysEx data receiver.
-	typedef QMultiMap<XGParamKey, QByteArray> SysexData;
-
-	bool add_sysex_data(SysexData& sysex_data,
-		unsigned char *data, unsigned short len);
-	bool set_sysex_data(const SysexData& sysex_data, bool bNotify = false);
-
 	// Direct parameter data access.
 	bool set_param_data(
 		XGParam *pParam, unsigned char *data, bool bNotify = false);
@@ -103,6 +110,17 @@ public:
 	void set_auto_send(bool bAuto);
 	bool auto_send() const;
 
+	// Compact (cheapest encoding) send feature.
+	void set_compact_send(bool bCompact);
+	bool compact_send() const;
+
+	// Outgoing change encoder.
+	XGParamEncoder& encoder();
+
+	// Live state publisher (shared memory).
+	void set_publisher(qxgeditXGPublisher *pPublisher);
+	qxgeditXGPublisher *publisher() const;
+
 	// Part randomize (from value/def)
 	void randomize_part(unsigned short iPart, float p = 20.0f);
 
@@ -113,6 +131,81 @@ public:
 	// User voice randomize (from value/def)
 	void randomize_user(unsigned short iUser, float p = 20.0f);
 
+	// Batched update (one notification transaction).
+	void begin_update();
+	void end_update();
+
+	bool is_updating() const;
+
+	// Part block copy/swap (all but element reserve and receive channel).
+	void copy_part(unsigned short iPart, unsigned short iToPart);
+	void swap_parts(unsigned short iPart1, unsigned short iPart2);
+
+	// Drum note block copy (across notes and drum sets).
+	void copy_drums(unsigned short iDrumSet, unsigned short iDrumKey,
+		unsigned short iToDrumSet, unsigned short iToDrumKey);
+
+	// User voice block copy/swap.
+	void copy_user(unsigned short iUser, unsigned short iToUser);
+	void swap_users(unsigned short iUser1, unsigned short iUser2);
+
+	// User voice element block copy/swap.
+	void copy_user_element(unsigned short iUser, unsigned short iElem,
+		unsigned short iToUser, unsigned short iToElem);
+	void swap_user_elements(unsigned short iUser);
+
+	// Block transaction (one bulk dump per touched sub-block).
+	void begin_block();
+	void end_block();
+
+	// Parameter change listener (eg. remote control subscribers).
+	class Listener
+	{
+	public:
+		// Destructor.
+		virtual ~Listener() {}
+		// Change notification (observer callback).
+		virtual void param_changed(
+			qxgeditXGMasterMap *pMasterMap, XGParam *pParam) = 0;
+	};
+
+	// Change listeners (global, any module).
+	static void add_listener(Listener *pListener);
+	static void remove_listener(Listener *pListener);
+
+	// Native binary snapshot (dense state image).
+	bool save_snapshot(const QString& sFilename) const;
+	bool load_snapshot(const QString& sFilename);
+
+	// Concurrent model commit (MIDI input thread; no signals,
+	// no allocations; false if it must go through set_sysex_data).
+	bool commitSysex(
+		const unsigned char *pSysex, unsigned int iSysex, bool& bNotify);
+
+	// Concurrent commits pick-up (main thread, coalesced).
+	void flush_commits();
+
+	// Concurrent commits hold-off (eg. while fetching).
+	void set_commit_hold(bool bHold);
+	bool commit_hold() const;
+
+	// Concurrent commits fall-back release (main thread,
+	// after a message refused by commitSysex is processed).
+	void release_commit(const unsigned char *pSysex, unsigned int iSysex);
+
+protected:
+
+	// Live state commit (whole image, unless batched).
+	void publish_state();
+
+	// Block copy/swap executive (low address range, destination offset).
+	void copy_block(unsigned short high, unsigned short mid,
+		unsigned short high2, unsigned short mid2,
+		unsigned short low1, unsigned short low2, int delta, bool bSwap);
+
+	// Send one sub-block as native bulk dump(s), one per contiguous run.
+	void send_block(unsigned short high, unsigned short mid) const;
+
 private:
 
 	// Simple XGParam observer.
@@ -120,11 +213,16 @@ private:
 	{
 	public:
 		// Constructor.
-		Observer(XGParam *pParam);
+		Observer(qxgeditXGMasterMap *pMasterMap, XGParam *pParam);
+		// Destructor.
+		~Observer();
 	protected:
 		// View updater (observer callback).
 		void reset();
 		void update();
+	private:
+		// Owner master map.
+		qxgeditXGMasterMap *m_pMasterMap;
 	};
 
 	// Local observer map.
@@ -133,6 +231,12 @@ private:
 	// Instance variables.
 	ObserverMap m_observers;
 
+	// Local observers, in dense state order.
+	QVector<Observer *> m_state_observers;
+
+	// Own MIDI device.
+	qxgeditMidiDevice *m_pMidiDevice;
+
 	// Multi Part dirty flag array.
 	int m_part_dirty[16];
 
@@ -141,6 +245,51 @@ private:
 
 	// QS300 User Voice auto-send feature.
 	bool m_auto_send;
+
+	// Compact send feature (NRPN, CC).
+	bool m_compact_send;
+
+	// Outgoing change encoder (running status, wire accounting).
+	mutable XGParamEncoder m_encoder;
+
+	// Live state publisher.
+	qxgeditXGPublisher *m_pPublisher;
+
+	// Batched update pending list.
+	int m_update_level;
+
+	QList<XGParam *> m_update_params;
+	QBitArray m_update_mask;
+
+	// Data parameters (in dense state order).
+	QList<XGDataParam *> m_data_params;
+	unsigned int m_data_size;
+
+	// Concurrent commit state.
+	std::atomic<bool> m_commit_hold;
+	std::atomic<bool> m_commit_posted;
+
+	QVector<unsigned int> m_commit_indexes;
+
+	// Concurrent commit fall-backs in flight, per sub-block hash:
+	// while any is pending, later ones must queue up behind it.
+	enum { CommitQueues = 64 };
+
+	static unsigned int commit_queue(unsigned short high, unsigned short mid)
+		{ return ((high << 4) ^ mid) & (CommitQueues - 1); }
+
+	std::atomic<unsigned int> m_commit_queued[CommitQueues];
+
+	// Block transaction pending sub-blocks, as (high << 8) | mid.
+	int m_block_level;
+
+	QList<unsigned short> m_block_keys;
+
+	// Snapshot loading in progress (no reset triggers sent).
+	bool m_snapshot_load;
+
+	// Change listeners.
+	static QList<Listener *> g_listeners;
 };
 
 
@@ -0,0 +1,197 @@
+// qxgeditXGModule.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditXGModule.h"
+
+#include "qxgeditXGMasterMap.h"
+#include "qxgeditMidiDevice.h"
+#include "qxgeditMidiLearn.h"
+#include "qxgeditXGPublisher.h"
+#include "qxgeditStartup.h"
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGModule -- XG module (device) context.
+
+// Pseudo-singleton reference.
+qxgeditXGModule *qxgeditXGModule::g_pModule = nullptr;
+
+// Constructor.
+qxgeditXGModule::qxgeditXGModule (
+	const QString& sName, const QString& sClientName )
+	: m_sName(sName), m_sClientName(sClientName), m_pPublisher(nullptr)
+{
+	m_pMasterMap  = new qxgeditXGMasterMap();
+	qxgeditStartup::mark("master map");
+
+	m_pMidiDevice = new qxgeditMidiDevice(sClientName);
+	qxgeditStartup::mark("midi device");
+
+	// Each master map sends through its own device...
+	m_pMasterMap->set_midi_device(m_pMidiDevice);
+
+	// Each device drives its own master map (MIDI Learn)...
+	m_pMidiLearn = new qxgeditMidiLearn(m_pMasterMap);
+	m_pMidiDevice->setMidiLearn(m_pMidiLearn);
+
+	// Set pseudo-singleton reference (first one only).
+	if (g_pModule == nullptr)
+		g_pModule = this;
+}
+
+
+// Destructor.
+qxgeditXGModule::~qxgeditXGModule (void)
+{
+	// Reset pseudo-singleton reference.
+	if (g_pModule == this)
+		g_pModule = nullptr;
+
+	m_pMidiDevice->setMidiLearn(nullptr);
+	m_pMidiDevice->setCommitter(nullptr);
+
+	setPublishState(false);
+
+	delete m_pMidiDevice;
+	delete m_pMidiLearn;
+	delete m_pMasterMap;
+}
+
+
+// Module name accessor.
+const QString& qxgeditXGModule::name (void) const
+{
+	return m_sName;
+}
+
+
+// Context accessors.
+qxgeditXGMasterMap *qxgeditXGModule::masterMap (void) const
+{
+	return m_pMasterMap;
+}
+
+qxgeditMidiDevice *qxgeditXGModule::midiDevice (void) const
+{
+	return m_pMidiDevice;
+}
+
+qxgeditMidiLearn *qxgeditXGModule::midiLearn (void) const
+{
+	return m_pMidiLearn;
+}
+
+
+// Live state publication (shared memory).
+bool qxgeditXGModule::setPublishState ( bool bPublish )
+{
+	if (bPublish && m_pPublisher == nullptr) {
+		m_pPublisher = new qxgeditXGPublisher(m_pMasterMap,
+			m_sClientName + ":state");
+		if (!m_pPublisher->open()) {
+			delete m_pPublisher;
+			m_pPublisher = nullptr;
+			return false;
+		}
+		m_pMasterMap->set_publisher(m_pPublisher);
+	}
+	else
+	if (!bPublish && m_pPublisher) {
+		m_pMasterMap->set_publisher(nullptr);
+		delete m_pPublisher;
+		m_pPublisher = nullptr;
+	}
+
+	return true;
+}
+
+qxgeditXGPublisher *qxgeditXGModule::publisher (void) const
+{
+	return m_pPublisher;
+}
+
+
+// Concurrent model commit (MIDI input thread, SysEx).
+void qxgeditXGModule::setDirectCommit ( bool bDirect )
+{
+	m_pMidiDevice->setCommitter(bDirect ? m_pMasterMap : nullptr);
+
+	// Pick up whatever got committed in the meantime...
+	if (!bDirect)
+		m_pMasterMap->flush_commits();
+}
+
+bool qxgeditXGModule::isDirectCommit (void) const
+{
+	return (m_pMidiDevice->committer() != nullptr);
+}
+
+
+// MIDI Input(readable) / Output(writable) bindings.
+void qxgeditXGModule::setInputs ( const QStringList& inputs )
+{
+	m_inputs = inputs;
+
+	m_pMidiDevice->connectInputs(m_inputs);
+}
+
+const QStringList& qxgeditXGModule::inputs (void) const
+{
+	return m_inputs;
+}
+
+
+void qxgeditXGModule::setOutputs ( const QStringList& outputs )
+{
+	m_outputs = outputs;
+
+	m_pMidiDevice->connectOutputs(m_outputs);
+}
+
+const QStringList& qxgeditXGModule::outputs (void) const
+{
+	return m_outputs;
+}
+
+
+// Pseudo-singleton reference (current module).
+qxgeditXGModule *qxgeditXGModule::getInstance (void)
+{
+	return g_pModule;
+}
+
+
+// Make it the current one, along with its own master map and device.
+void qxgeditXGModule::setInstance ( qxgeditXGModule *pModule )
+{
+	g_pModule = pModule;
+
+	if (pModule) {
+		qxgeditXGMasterMap::setInstance(pModule->masterMap());
+		qxgeditMidiDevice::setInstance(pModule->midiDevice());
+	} else {
+		qxgeditXGMasterMap::setInstance(nullptr);
+		qxgeditMidiDevice::setInstance(nullptr);
+	}
+}
+
+
+// end of qxgeditXGModule.cpp
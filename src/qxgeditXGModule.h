@@ -0,0 +1,102 @@
+// qxgeditXGModule.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditXGModule_h
+#define __qxgeditXGModule_h
+
+#include <QStringList>
+
+
+// Forward decls.
+class qxgeditXGMasterMap;
+class qxgeditMidiDevice;
+class qxgeditMidiLearn;
+class qxgeditXGPublisher;
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGModule -- XG module (device) context.
+//
+// Each module owns its own master map (parameter state), its own
+// MIDI device (ALSA client and output thread) and port bindings;
+// all of them share the same (static, read-only) descriptor tables.
+
+class qxgeditXGModule
+{
+public:
+
+	// Constructor.
+	qxgeditXGModule(const QString& sName, const QString& sClientName);
+
+	// Destructor.
+	~qxgeditXGModule();
+
+	// Module name accessor.
+	const QString& name() const;
+
+	// Context accessors.
+	qxgeditXGMasterMap *masterMap() const;
+	qxgeditMidiDevice *midiDevice() const;
+	qxgeditMidiLearn *midiLearn() const;
+
+	// Live state publication (shared memory).
+	bool setPublishState(bool bPublish);
+	qxgeditXGPublisher *publisher() const;
+
+	// Concurrent model commit (MIDI input thread, SysEx).
+	void setDirectCommit(bool bDirect);
+	bool isDirectCommit() const;
+
+	// MIDI Input(readable) / Output(writable) bindings.
+	void setInputs(const QStringList& inputs);
+	const QStringList& inputs() const;
+
+	void setOutputs(const QStringList& outputs);
+	const QStringList& outputs() const;
+
+	// Pseudo-singleton reference (current module).
+	static qxgeditXGModule *getInstance();
+	static void setInstance(qxgeditXGModule *pModule);
+
+private:
+
+	// Instance variables.
+	QString m_sName;
+
+	qxgeditXGMasterMap *m_pMasterMap;
+	qxgeditMidiDevice  *m_pMidiDevice;
+	qxgeditMidiLearn   *m_pMidiLearn;
+
+	QString m_sClientName;
+	qxgeditXGPublisher *m_pPublisher;
+
+	QStringList m_inputs;
+	QStringList m_outputs;
+
+	// Pseudo-singleton reference.
+	static qxgeditXGModule *g_pModule;
+};
+
+
+#endif	// __qxgeditXGModule_h
+
+
+// end of qxgeditXGModule.h
@@ -0,0 +1,208 @@
+// qxgeditXGPublisher.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qxgeditAbout.h"
+#include "qxgeditXGPublisher.h"
+
+#include "qxgeditXGMasterMap.h"
+
+#include <QSharedMemory>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+#include <QNativeIpcKey>
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+
+static const char          *g_publish_magic   = "QXGP";
+static const unsigned short g_publish_version = 1;
+static const unsigned short g_publish_bom     = 0xfeff;
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGPublisher -- Live parameter state shared memory publisher.
+
+// Constructor.
+qxgeditXGPublisher::qxgeditXGPublisher (
+	qxgeditXGMasterMap *pMasterMap, const QString& sKey )
+	: m_pMasterMap(pMasterMap), m_sKey(sKey), m_pMemory(nullptr),
+		m_pHeader(nullptr), m_pValues(nullptr)
+{
+}
+
+
+// Destructor.
+qxgeditXGPublisher::~qxgeditXGPublisher (void)
+{
+	close();
+}
+
+
+// Segment key accessor.
+const QString& qxgeditXGPublisher::key (void) const
+{
+	return m_sKey;
+}
+
+
+// Segment lifetime.
+bool qxgeditXGPublisher::open (void)
+{
+	close();
+
+	XGParamState *pState = m_pMasterMap->state();
+	if (pState == nullptr)
+		return false;
+
+	const unsigned int count = pState->count();
+	const unsigned int values = sizeof(qxgeditXGPublishHeader);
+	const unsigned int table  = values
+		+ ((count * sizeof(unsigned short) + 7) & ~7U);
+	const unsigned int size = table + count * sizeof(qxgeditXGPublishEntry);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+	const QNativeIpcKey nativeKey
+		= QSharedMemory::legacyNativeKey(m_sKey);
+#if defined(Q_OS_UNIX)
+	// Cleanup any stale segment left behind...
+	m_pMemory = new QSharedMemory(nativeKey);
+	m_pMemory->attach();
+	delete m_pMemory;
+#endif
+	m_pMemory = new QSharedMemory(nativeKey);
+#else
+#if defined(Q_OS_UNIX)
+	m_pMemory = new QSharedMemory(m_sKey);
+	m_pMemory->attach();
+	delete m_pMemory;
+#endif
+	m_pMemory = new QSharedMemory(m_sKey);
+#endif
+
+	if (!m_pMemory->create(size)) {
+	#ifdef CONFIG_DEBUG
+		qDebug("qxgeditXGPublisher::open(\"%s\"): %s",
+			m_sKey.toUtf8().constData(),
+			m_pMemory->errorString().toUtf8().constData());
+	#endif
+		delete m_pMemory;
+		m_pMemory = nullptr;
+		return false;
+	}
+
+	unsigned char *data = static_cast<unsigned char *> (m_pMemory->data());
+	::memset(data, 0, size);
+
+	m_pHeader = new (data) qxgeditXGPublishHeader;
+	::memcpy(m_pHeader->magic, g_publish_magic, sizeof(m_pHeader->magic));
+	m_pHeader->version = g_publish_version;
+	m_pHeader->bom     = g_publish_bom;
+	m_pHeader->layout  = m_pMasterMap->layout();
+	m_pHeader->count   = count;
+	m_pHeader->values  = values;
+	m_pHeader->table   = table;
+	m_pHeader->seq.storeRelaxed(0);
+
+	m_pValues = reinterpret_cast<unsigned short *> (data + values);
+
+	// Static address table...
+	qxgeditXGPublishEntry *entries
+		= reinterpret_cast<qxgeditXGPublishEntry *> (data + table);
+	const QList<XGParam *>& params = m_pMasterMap->params();
+	for (unsigned int i = 0; i < count && i < (unsigned int) params.count(); ++i) {
+		XGParam *pParam = params.at(i);
+		qxgeditXGPublishEntry *entry = &entries[i];
+		entry->high = pParam->high();
+		entry->mid  = pParam->mid();
+		entry->low  = pParam->low();
+		entry->size = pParam->size();
+		if (entry->high == 0x02 && entry->mid == 0x01
+			&& entry->low != 0x00 && entry->low != 0x20 && entry->low != 0x40)
+			entry->etype = static_cast<XGEffectParam *> (pParam)->etype();
+	}
+
+	publish_all();
+
+	return true;
+}
+
+
+void qxgeditXGPublisher::close (void)
+{
+	m_pHeader = nullptr;
+	m_pValues = nullptr;
+
+	if (m_pMemory) {
+		delete m_pMemory;
+		m_pMemory = nullptr;
+	}
+}
+
+
+bool qxgeditXGPublisher::isOpen (void) const
+{
+	return (m_pHeader != nullptr);
+}
+
+
+// Publish a single value (one commit).
+void qxgeditXGPublisher::publish ( XGParam *pParam )
+{
+	if (m_pHeader == nullptr)
+		return;
+
+	const unsigned int index = pParam->index();
+	if (index >= m_pHeader->count)
+		return;
+
+	const unsigned int seq = m_pHeader->seq.loadRelaxed();
+	m_pHeader->seq.storeRelaxed(seq + 1);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	m_pValues[index] = pParam->value();
+
+	m_pHeader->seq.storeRelease(seq + 2);
+}
+
+
+// Publish the whole state image (one commit).
+void qxgeditXGPublisher::publish_all (void)
+{
+	if (m_pHeader == nullptr)
+		return;
+
+	XGParamState *pState = m_pMasterMap->state();
+	if (pState == nullptr)
+		return;
+
+	const unsigned int seq = m_pHeader->seq.loadRelaxed();
+	m_pHeader->seq.storeRelaxed(seq + 1);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	pState->snapshot(m_pValues);
+
+	m_pHeader->seq.storeRelease(seq + 2);
+}
+
+
+// end of qxgeditXGPublisher.cpp
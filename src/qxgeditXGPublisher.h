@@ -0,0 +1,111 @@
+// qxgeditXGPublisher.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qxgeditXGPublisher_h
+#define __qxgeditXGPublisher_h
+
+#include <QString>
+#include <QAtomicInteger>
+
+
+// Forward decls.
+class qxgeditXGMasterMap;
+class XGParam;
+
+class QSharedMemory;
+
+
+//----------------------------------------------------------------------------
+// qxgeditXGPublisher -- Live parameter state shared memory publisher.
+//
+// The segment holds a header, the dense state values (in master map
+// key order) and a static address table, one entry per value. It is
+// only ever written from the main thread, without locking, as a
+// seqlock: readers take the sequence counter (retry while odd), copy
+// what they need, then take it again (retry if it's changed).
+
+struct qxgeditXGPublishHeader
+{
+	char           magic[4];    // "QXGP"
+	unsigned short version;     // Format version (1).
+	unsigned short bom;         // Byte-order mark (0xfeff, native).
+	unsigned int   layout;      // Master map layout signature.
+	unsigned int   count;       // Number of dense state values.
+	unsigned int   values;      // Values offset (bytes).
+	unsigned int   table;       // Address table offset (bytes).
+
+	QAtomicInteger<unsigned int> seq; // Sequence counter (odd=busy).
+};
+
+struct qxgeditXGPublishEntry
+{
+	unsigned char  high;        // XG address.
+	unsigned char  mid;
+	unsigned char  low;
+	unsigned char  size;        // Data size (>4: value not meaningful).
+	unsigned short etype;       // Effect type (0=n/a).
+	unsigned short reserved;
+};
+
+
+class qxgeditXGPublisher
+{
+public:
+
+	// Constructor.
+	qxgeditXGPublisher(qxgeditXGMasterMap *pMasterMap, const QString& sKey);
+
+	// Destructor.
+	~qxgeditXGPublisher();
+
+	// Segment key accessor.
+	const QString& key() const;
+
+	// Segment lifetime.
+	bool open();
+	void close();
+
+	bool isOpen() const;
+
+	// Publish a single value (one commit).
+	void publish(XGParam *pParam);
+
+	// Publish the whole state image (one commit).
+	void publish_all();
+
+private:
+
+	// Instance variables.
+	qxgeditXGMasterMap *m_pMasterMap;
+
+	QString m_sKey;
+
+	QSharedMemory *m_pMemory;
+
+	qxgeditXGPublishHeader *m_pHeader;
+	unsigned short *m_pValues;
+};
+
+
+#endif	// __qxgeditXGPublisher_h
+
+
+// end of qxgeditXGPublisher.h